@@ -129,7 +129,58 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // The grammar has no INCLUDE clause, so included columns come as index options instead:
+  // `WITH (include = b, include = c)` or `WITH (include = 'b, c')`. `WITH (bloom_filter = 10)` adds a bloom filter
+  // with 10 bits per key.
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols;
+  size_t bloom_filter_bits_per_key = 0;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto def_elem = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      if (std::string(def_elem->defname) == "bloom_filter" && def_elem->arg != nullptr &&
+          def_elem->arg->type == duckdb_libpgquery::T_PGInteger) {
+        auto bits_per_key = reinterpret_cast<duckdb_libpgquery::PGValue *>(def_elem->arg)->val.ival;
+        if (bits_per_key <= 0) {
+          throw bustub::Exception("bloom filter needs a positive number of bits per key");
+        }
+        bloom_filter_bits_per_key = bits_per_key;
+        continue;
+      }
+      if (std::string(def_elem->defname) != "include" || def_elem->arg == nullptr) {
+        throw NotImplementedException(fmt::format("index option {} is not supported", def_elem->defname));
+      }
+      std::vector<std::string> col_names;
+      if (def_elem->arg->type == duckdb_libpgquery::T_PGString) {
+        for (const auto &col_name :
+             StringUtil::Split(reinterpret_cast<duckdb_libpgquery::PGValue *>(def_elem->arg)->val.str, ',')) {
+          col_names.emplace_back(StringUtil::Strip(col_name, ' '));
+        }
+      } else if (def_elem->arg->type == duckdb_libpgquery::T_PGTypeName) {
+        // a bare column name parses as a type name
+        auto names = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(def_elem->arg)->names;
+        col_names.emplace_back(reinterpret_cast<duckdb_libpgquery::PGValue *>(names->tail->data.ptr_value)->val.str);
+      } else {
+        throw bustub::Exception(
+            fmt::format("unexpected included column {}", Binder::NodeTagToString(def_elem->arg->type)));
+      }
+      for (const auto &col_name : col_names) {
+        auto column_ref = ResolveColumn(*table, std::vector{col_name});
+        include_cols.emplace_back(std::make_unique<BoundColumnRef>(dynamic_cast<const BoundColumnRef &>(*column_ref)));
+      }
+    }
+  }
+
+  // 不写 USING 时 parser 默认填 "art"，按 btree 处理
+  std::string index_type = stmt->accessMethod != nullptr ? stmt->accessMethod : "btree";
+  if (index_type == "art") {
+    index_type = "btree";
+  }
+  if (index_type != "btree" && index_type != "hash") {
+    throw NotImplementedException(fmt::format("index type {} is not supported", index_type));
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), stmt->unique,
+                                          std::move(include_cols), bloom_filter_bits_per_key, std::move(index_type));
 }
 
 }  // namespace bustub
@@ -719,6 +719,17 @@ auto Binder::BindAExpr(duckdb_libpgquery::PGAExpr *root) -> std::unique_ptr<Boun
   BUSTUB_ASSERT(root, "nullptr");
   auto name = std::string((reinterpret_cast<duckdb_libpgquery::PGValue *>(root->name->head->data.ptr_value))->val.str);
 
+  if (root->kind == duckdb_libpgquery::PG_AEXPR_BETWEEN) {
+    // `x BETWEEN a AND b` is bound as `x >= a AND x <= b`
+    auto bounds = BindExpressionList(reinterpret_cast<duckdb_libpgquery::PGList *>(root->rexpr));
+    if (bounds.size() != 2) {
+      throw bustub::Exception("BETWEEN should have 2 bounds");
+    }
+    auto lower = std::make_unique<BoundBinaryOp>(">=", BindExpression(root->lexpr), std::move(bounds[0]));
+    auto upper = std::make_unique<BoundBinaryOp>("<=", BindExpression(root->lexpr), std::move(bounds[1]));
+    return std::make_unique<BoundBinaryOp>("and", std::move(lower), std::move(upper));
+  }
+
   if (root->kind != duckdb_libpgquery::PG_AEXPR_OP) {
     throw bustub::Exception("unsupported op in AExpr");
   }
@@ -7,14 +7,22 @@
 namespace bustub {
 
 IndexStatement::IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                               std::vector<std::unique_ptr<BoundColumnRef>> cols)
+                               std::vector<std::unique_ptr<BoundColumnRef>> cols, bool is_unique,
+                               std::vector<std::unique_ptr<BoundColumnRef>> include_cols,
+                               size_t bloom_filter_bits_per_key, std::string index_type)
     : BoundStatement(StatementType::INDEX_STATEMENT),
       index_name_(std::move(index_name)),
       table_(std::move(table)),
-      cols_(std::move(cols)) {}
+      cols_(std::move(cols)),
+      is_unique_(is_unique),
+      include_cols_(std::move(include_cols)),
+      bloom_filter_bits_per_key_(bloom_filter_bits_per_key),
+      index_type_(std::move(index_type)) {}
 
 auto IndexStatement::ToString() const -> std::string {
-  return fmt::format("BoundIndex {{ index_name={}, table={}, cols={} }}", index_name_, *table_, cols_);
+  return fmt::format(
+      "BoundIndex {{ index_name={}, table={}, cols={}, unique={}, include={}, bloom_filter={}, type={} }}", index_name_,
+      *table_, cols_, is_unique_, include_cols_, bloom_filter_bits_per_key_, index_type_);
 }
 
 }  // namespace bustub
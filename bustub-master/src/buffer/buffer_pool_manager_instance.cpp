@@ -168,9 +168,7 @@ auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
     return false;
   }
 
-  if (page->IsDirty()) {
-    disk_manager_->ReadPage(page->GetPageId(), page->GetData());
-  }
+  // 页要被删掉了，脏数据直接丢弃，不用再读写磁盘
   page->ResetMemory();
   page->is_dirty_ = false;
   page->page_id_ = INVALID_PAGE_ID;
@@ -1,6 +1,9 @@
+#include <algorithm>
+#include <cctype>
 #include <optional>
 #include <shared_mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 
 #include "binder/binder.h"
@@ -18,6 +21,7 @@
 #include "common/enums/statement_type.h"
 #include "common/exception.h"
 #include "common/util/string_util.h"
+#include "common/worker_pool.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction.h"
 #include "execution/execution_engine.h"
@@ -38,7 +42,32 @@
 namespace bustub {
 
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_,
+                                           worker_pool_, GetParallelism(), GetMemoryBudget());
+}
+
+auto BustubInstance::GetSizeVariable(const std::string &key, size_t default_value) -> size_t {
+  auto variable = GetSessionVariable(key);
+  // 没设置或者不是正整数就用默认值
+  if (variable.empty() || std::isdigit(variable[0]) == 0) {
+    return default_value;
+  }
+  try {
+    size_t end = 0;
+    auto value = std::stoul(variable, &end);
+    if (end == variable.size() && value > 0) {
+      return value;
+    }
+  } catch (std::out_of_range &e) {
+    // 数字太大，按未设置处理
+  }
+  return default_value;
+}
+
+auto BustubInstance::GetParallelism() -> size_t { return GetSizeVariable("execution_parallelism", 1); }
+
+auto BustubInstance::GetMemoryBudget() -> size_t {
+  return GetSizeVariable("execution_memory_budget", EXECUTION_MEMORY_BUDGET);
 }
 
 BustubInstance::BustubInstance(const std::string &db_file_name) {
@@ -73,6 +102,9 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+
+  // Worker pool, the thread running a query joins in as one more worker.
+  worker_pool_ = new WorkerPool(std::max(std::thread::hardware_concurrency(), 2U) - 1);
 }
 
 void BustubInstance::CmdDisplayTables(ResultWriter &writer) {
@@ -204,10 +236,45 @@ void BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         }
         auto key_schema = Schema::CopySchema(&index_stmt.table_->schema_, col_ids);
 
+        std::vector<uint32_t> include_ids;
+        for (const auto &col : index_stmt.include_cols_) {
+          auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
+          if (std::find(col_ids.begin(), col_ids.end(), idx) != col_ids.end() ||
+              std::find(include_ids.begin(), include_ids.end(), idx) != include_ids.end()) {
+            throw bustub::Exception(fmt::format("column {} is already part of the index", col->col_name_.back()));
+          }
+          if (!index_stmt.table_->schema_.GetColumn(idx).IsInlined()) {
+            throw NotImplementedException("only support including fixed-length columns in an index");
+          }
+          include_ids.push_back(idx);
+        }
+        auto index_type = IndexType::BPlusTreeIndex;
+        if (index_stmt.index_type_ == "hash") {
+          if (!include_ids.empty() || index_stmt.bloom_filter_bits_per_key_ > 0) {
+            throw NotImplementedException("hash indexes support neither included columns nor bloom filters");
+          }
+          index_type = IndexType::HashTableIndex;
+        }
+        // key, RID suffix (non-unique B+ tree indexes only) and included columns must fit into one index key
+        auto include_schema = Schema::CopySchema(&index_stmt.table_->schema_, include_ids);
+        bool has_rid_suffix = !index_stmt.is_unique_ && index_type == IndexType::BPlusTreeIndex;
+        size_t entry_size = key_schema.GetLength() + (has_rid_suffix ? sizeof(RID) : 0) + include_schema.GetLength();
+
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-            txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+        IndexInfo *info;
+        if (entry_size <= INTEGER_KEY_SIZE) {
+          info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+              txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
+              INTEGER_KEY_SIZE, IntegerHashFunctionType{}, index_stmt.is_unique_, include_ids,
+              index_stmt.bloom_filter_bits_per_key_, index_type);
+        } else if (entry_size <= COVERING_KEY_SIZE) {
+          info = catalog_->CreateIndex<CoveringKeyType, IntegerValueType, CoveringComparatorType>(
+              txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
+              COVERING_KEY_SIZE, CoveringHashFunctionType{}, index_stmt.is_unique_, include_ids,
+              index_stmt.bloom_filter_bits_per_key_, index_type);
+        } else {
+          throw NotImplementedException("included columns do not fit into an index key");
+        }
         l.unlock();
 
         if (info == nullptr) {
@@ -356,6 +423,7 @@ BustubInstance::~BustubInstance() {
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
+  delete worker_pool_;
   delete execution_engine_;
   delete catalog_;
   delete checkpoint_manager_;
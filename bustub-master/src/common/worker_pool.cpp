@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool.cpp
+//
+// Identification: src/common/worker_pool.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/worker_pool.h"
+
+#include <exception>
+
+namespace bustub {
+
+struct WorkerPool::Job {
+  const std::function<void(size_t)> *task_;
+  /** Tasks of the job that have not finished yet */
+  size_t pending_;
+  std::exception_ptr error_;
+};
+
+WorkerPool::WorkerPool(size_t num_threads) {
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::scoped_lock lock(latch_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+auto WorkerPool::RunQueued(std::unique_lock<std::mutex> *lock) -> bool {
+  if (queue_.empty()) {
+    return false;
+  }
+  auto [job, worker_id] = queue_.front();
+  queue_.pop_front();
+  lock->unlock();
+  std::exception_ptr error;
+  try {
+    (*job->task_)(worker_id);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  lock->lock();
+  if (error != nullptr && job->error_ == nullptr) {
+    job->error_ = error;
+  }
+  // job 属于等待它的 Run()，pending_ 归零后那边就可能把它销毁，不能再碰
+  if (--job->pending_ == 0) {
+    cv_.notify_all();
+  }
+  return true;
+}
+
+void WorkerPool::WorkerLoop() {
+  std::unique_lock lock(latch_);
+  while (true) {
+    cv_.wait(lock, [this] { return shutdown_ || !queue_.empty(); });
+    if (shutdown_) {
+      return;
+    }
+    RunQueued(&lock);
+  }
+}
+
+void WorkerPool::Run(size_t num_workers, const std::function<void(size_t)> &task) {
+  if (num_workers == 0) {
+    return;
+  }
+  Job job{&task, num_workers, nullptr};
+  std::unique_lock lock(latch_);
+  for (size_t worker_id = 1; worker_id < num_workers; worker_id++) {
+    queue_.emplace_back(&job, worker_id);
+  }
+  cv_.notify_all();
+  lock.unlock();
+
+  // 调用线程自己当 0 号 worker
+  try {
+    task(0);
+  } catch (...) {
+    lock.lock();
+    if (job.error_ == nullptr) {
+      job.error_ = std::current_exception();
+    }
+    lock.unlock();
+  }
+
+  lock.lock();
+  job.pending_--;
+  // 等别的 worker 时顺手执行排队的任务，嵌套的 Run() 也就不会把池子占满卡死
+  while (job.pending_ > 0) {
+    if (!RunQueued(&lock)) {
+      cv_.wait(lock, [&] { return job.pending_ == 0 || !queue_.empty(); });
+    }
+  }
+  if (job.error_ != nullptr) {
+    std::rethrow_exception(job.error_);
+  }
+}
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -26,7 +27,18 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                          const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+  // 初始时全局深度为0，目录只有一项，指向唯一的桶
+  auto *dir_page =
+      reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->NewPage(&directory_page_id_)->GetData());
+  dir_page->SetPageId(directory_page_id_);
+  page_id_t bucket_page_id;
+  if (buffer_pool_manager_->NewPage(&bucket_page_id) == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame in the buffer pool for a hash table bucket");
+  }
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
 }
 
 /*****************************************************************************
@@ -46,22 +58,22 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+  return reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+  return reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(buffer_pool_manager_->FetchPage(bucket_page_id)->GetData());
 }
 
 /*****************************************************************************
@@ -69,20 +81,123 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
+  // 要加页锁，所以直接取页而不是用FetchBucketPage
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  auto *bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  page->RLatch();
+  bool found = bucket_page->GetValue(key, comparator_, result);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
 }
 
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value, bool unique)
+    -> bool {
+  // 桶没满时只需要目录的读锁和桶的页写锁，不同桶上的插入可以并发
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  auto *bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  page->WLatch();
+  // 相同的key都在同一个桶里，持有桶的写锁查重，查重和插入之间不会有别的线程插入同一个key
+  std::vector<ValueType> values;
+  bool duplicate = unique && bucket_page->GetValue(key, comparator_, &values);
+  bool full = !duplicate && bucket_page->IsFull();
+  bool inserted = !duplicate && !full && bucket_page->Insert(key, value, comparator_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (!full) {
+    return inserted;
+  }
+  return SplitInsert(transaction, key, value, unique);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value, bool unique)
+    -> bool {
+  // 分裂要改目录，持有表的写锁，期间没有别的线程能碰任何桶，所以不再加页锁
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  bool dir_dirty = false;
+  bool inserted = false;
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    HASH_TABLE_BUCKET_TYPE *bucket_page = FetchBucketPage(bucket_page_id);
+    // 放掉读锁到拿到写锁之间，别的线程可能插入了同一个key
+    std::vector<ValueType> values;
+    bucket_page->GetValue(key, comparator_, &values);
+    if ((unique && !values.empty()) || std::find(values.begin(), values.end(), value) != values.end()) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+    // 拿写锁之前可能已经有别的线程分裂过这个桶了
+    if (!bucket_page->IsFull()) {
+      inserted = bucket_page->Insert(key, value, comparator_);
+      buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+      break;
+    }
+
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == dir_page->GetGlobalDepth()) {
+      if (dir_page->Size() * 2 > DIRECTORY_ARRAY_SIZE) {
+        // 目录页已经满了，不能再翻倍
+        buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+        break;
+      }
+      dir_page->IncrGlobalDepth();
+    }
+
+    page_id_t image_page_id;
+    Page *image_page = buffer_pool_manager_->NewPage(&image_page_id);
+    if (image_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+    auto *image_bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(image_page->GetData());
+
+    // 指向这个桶的目录项里，新的局部深度最高位为1的一半改指向分裂出的新桶
+    uint32_t high_bit = 1U << local_depth;
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      if (dir_page->GetBucketPageId(idx) == bucket_page_id) {
+        dir_page->IncrLocalDepth(idx);
+        if ((idx & high_bit) != 0) {
+          dir_page->SetBucketPageId(idx, image_page_id);
+        }
+      }
+    }
+    dir_dirty = true;
+
+    // 按新的局部深度把桶里的元素重新分到两个桶
+    for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE; slot++) {
+      if (!bucket_page->IsReadable(slot)) {
+        continue;
+      }
+      KeyType slot_key = bucket_page->KeyAt(slot);
+      if ((Hash(slot_key) & high_bit) != 0) {
+        image_bucket->Insert(slot_key, bucket_page->ValueAt(slot), comparator_);
+        bucket_page->RemoveAt(slot);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+    // 所有元素可能都落在同一边，回到循环开头重新找桶，必要时继续分裂
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+  table_latch_.WUnlock();
+  return inserted;
 }
 
 /*****************************************************************************
@@ -90,14 +205,80 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  auto *bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  page->WLatch();
+  bool removed = bucket_page->Remove(key, value, comparator_);
+  bool empty = bucket_page->IsEmpty();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  bool dir_dirty = false;
+  // 合并后的桶可能又能和它新的镜像合并，沿着key所在的桶一直合并上去
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == 0) {
+      break;
+    }
+    uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    // 放掉读锁到拿到写锁之间，桶可能又被插入了元素，所以重新检查；镜像也可能早就空了
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+    page_id_t empty_page_id;
+    if (IsBucketEmpty(bucket_page_id)) {
+      empty_page_id = bucket_page_id;
+    } else if (IsBucketEmpty(image_page_id)) {
+      empty_page_id = image_page_id;
+    } else {
+      break;
+    }
+
+    // 空桶并入另一个，原来指向两者的目录项都指向留下的桶并减小局部深度
+    page_id_t kept_page_id = empty_page_id == bucket_page_id ? image_page_id : bucket_page_id;
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      page_id_t page_id = dir_page->GetBucketPageId(idx);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        dir_page->SetBucketPageId(idx, kept_page_id);
+        dir_page->DecrLocalDepth(idx);
+      }
+    }
+    buffer_pool_manager_->DeletePage(empty_page_id);
+    while (dir_page->CanShrink()) {
+      dir_page->DecrGlobalDepth();
+    }
+    dir_dirty = true;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::IsBucketEmpty(page_id_t bucket_page_id) -> bool {
+  bool empty = FetchBucketPage(bucket_page_id)->IsEmpty();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  return empty;
+}
 
 /*****************************************************************************
  * GETGLOBALDEPTH - DO NOT TOUCH
@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -26,21 +28,200 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  auto *header_page =
+      reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->NewPage(&header_page_id_)->GetData());
+  header_page->SetPageId(header_page_id_);
+  CreateNewBlockPages(header_page, std::max<size_t>(1, (num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE));
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetHeaderPage(page_id_t header_page_id) -> HashTableHeaderPage * {
+  return reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE * {
+  return reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(buffer_pool_manager_->FetchPage(block_page_id)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::Home(const KeyType &key, size_t size) -> size_t {
+  return hash_fn_.GetHash(key) % size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::Distance(HASH_TABLE_BLOCK_TYPE *block_page, size_t slot, size_t size) -> size_t {
+  return (slot + size - Home(block_page->KeyAt(slot % BLOCK_ARRAY_SIZE), size)) % size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+auto HASH_TABLE_TYPE::Probe(HashTableHeaderPage *header_page, const KeyType &key, bool dirty, Visitor &&visit)
+    -> bool {
+  const size_t size = header_page->GetSize();
+  const size_t home = Home(key, size);
+  SlotCursor cursor(buffer_pool_manager_, header_page, dirty);
+  for (size_t distance = 0; distance < size; distance++) {
+    size_t slot = (home + distance) % size;
+    auto *block_page = cursor.Seek(slot);
+    slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+    // 比当前键离家还近的元素后面不会再有这个键，插入时它会把这样的元素挤走
+    if (!block_page->IsOccupied(offset) || Distance(block_page, slot, size) < distance) {
+      return false;
+    }
+    if (visit(block_page, offset, slot)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::RobinHoodInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value)
+    -> bool {
+  const size_t size = header_page->GetSize();
+  if (stats_.num_entries_ == size) {
+    return false;
+  }
+  KeyType carried_key = key;
+  ValueType carried_value = value;
+  size_t distance = 0;
+  SlotCursor cursor(buffer_pool_manager_, header_page, true);
+  // 表没满，一定能走到空槽
+  for (size_t slot = Home(key, size);; slot = (slot + 1) % size, distance++) {
+    auto *block_page = cursor.Seek(slot);
+    slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+    if (!block_page->IsOccupied(offset)) {
+      block_page->Insert(offset, carried_key, carried_value);
+      stats_.num_entries_++;
+      stats_.total_distance_ += distance;
+      stats_.max_distance_ = std::max(stats_.max_distance_, distance);
+      return true;
+    }
+    size_t occupant_distance = Distance(block_page, slot, size);
+    if (occupant_distance < distance) {
+      // 劫富济贫：离家更近的元素让出槽位，换成带着它继续往后找
+      KeyType occupant_key = block_page->KeyAt(offset);
+      ValueType occupant_value = block_page->ValueAt(offset);
+      block_page->Clear(offset);
+      block_page->Insert(offset, carried_key, carried_value);
+      stats_.total_distance_ += distance - occupant_distance;
+      stats_.max_distance_ = std::max(stats_.max_distance_, distance);
+      carried_key = occupant_key;
+      carried_value = occupant_value;
+      distance = occupant_distance;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::ShiftBackward(HashTableHeaderPage *header_page, size_t slot) {
+  const size_t size = header_page->GetSize();
+  SlotCursor cursor(buffer_pool_manager_, header_page, true);
+  stats_.num_entries_--;
+  stats_.total_distance_ -= Distance(cursor.Seek(slot), slot, size);
+  // 后面的元素依次前移一格，直到空槽或者已经在家的元素，不留墓碑
+  size_t hole = slot;
+  for (size_t next = (hole + 1) % size; next != slot; next = (next + 1) % size) {
+    auto *block_page = cursor.Seek(next);
+    slot_offset_t offset = next % BLOCK_ARRAY_SIZE;
+    if (!block_page->IsOccupied(offset) || Distance(block_page, next, size) == 0) {
+      break;
+    }
+    KeyType key = block_page->KeyAt(offset);
+    ValueType value = block_page->ValueAt(offset);
+    block_page = cursor.Seek(hole);
+    block_page->Clear(hole % BLOCK_ARRAY_SIZE);
+    block_page->Insert(hole % BLOCK_ARRAY_SIZE, key, value);
+    stats_.total_distance_--;
+    hole = next;
+  }
+  cursor.Seek(hole)->Clear(hole % BLOCK_ARRAY_SIZE);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks) {
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame in the buffer pool for a hash table block");
+    }
+    header_page->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  header_page->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DeleteBlockPages(HashTableHeaderPage *old_header_page) {
+  for (size_t i = 0; i < old_header_page->NumBlocks(); i++) {
+    buffer_pool_manager_->DeletePage(old_header_page->GetBlockPageId(i));
+  }
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  bool found = false;
+  auto collect = [&](HASH_TABLE_BLOCK_TYPE *block_page, slot_offset_t offset, size_t /*slot*/) {
+    if (block_page->IsReadable(offset) && comparator_(block_page->KeyAt(offset), key) == 0) {
+      result->push_back(block_page->ValueAt(offset));
+      found = true;
+    }
+    return false;
+  };
+  // 扩容期间还没搬走的元素在旧表里，每个元素只会在其中一张表
+  for (page_id_t header_page_id : {header_page_id_, old_header_page_id_}) {
+    if (header_page_id != INVALID_PAGE_ID) {
+      Probe(GetHeaderPage(header_page_id), key, false, collect);
+      buffer_pool_manager_->UnpinPage(header_page_id, false);
+    }
+  }
+  table_latch_.RUnlock();
+  return found;
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  auto is_same = [&](HASH_TABLE_BLOCK_TYPE *block_page, slot_offset_t offset, size_t /*slot*/) {
+    return block_page->IsReadable(offset) && comparator_(block_page->KeyAt(offset), key) == 0 &&
+           block_page->ValueAt(offset) == value;
+  };
+  for (page_id_t header_page_id : {header_page_id_, old_header_page_id_}) {
+    if (header_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    bool duplicate = Probe(GetHeaderPage(header_page_id), key, false, is_same);
+    buffer_pool_manager_->UnpinPage(header_page_id, false);
+    if (duplicate) {
+      table_latch_.WUnlock();
+      return false;
+    }
+  }
+  // 新元素只进当前的表；当前表满了就马上换一张大表再插
+  auto *header_page = GetHeaderPage(header_page_id_);
+  bool inserted = RobinHoodInsert(header_page, key, value);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (!inserted && StartResize(2 * GetSizeLatchFree())) {
+    header_page = GetHeaderPage(header_page_id_);
+    inserted = RobinHoodInsert(header_page, key, value);
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  }
+  MaintainResize();
+  table_latch_.WUnlock();
+  return inserted;
 }
 
 /*****************************************************************************
@@ -48,21 +229,156 @@ auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  size_t found_slot = 0;
+  auto find_pair = [&](HASH_TABLE_BLOCK_TYPE *block_page, slot_offset_t offset, size_t slot) {
+    found_slot = slot;
+    return block_page->IsReadable(offset) && comparator_(block_page->KeyAt(offset), key) == 0 &&
+           block_page->ValueAt(offset) == value;
+  };
+  auto *header_page = GetHeaderPage(header_page_id_);
+  bool removed = Probe(header_page, key, false, find_pair);
+  if (removed) {
+    ShiftBackward(header_page, found_slot);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  if (!removed && old_header_page_id_ != INVALID_PAGE_ID) {
+    // 旧表不移动元素，留墓碑保证还没搬走的元素仍然探测得到
+    auto remove_pair = [&](HASH_TABLE_BLOCK_TYPE *block_page, slot_offset_t offset, size_t /*slot*/) {
+      if (block_page->IsReadable(offset) && comparator_(block_page->KeyAt(offset), key) == 0 &&
+          block_page->ValueAt(offset) == value) {
+        block_page->Remove(offset);
+        return true;
+      }
+      return false;
+    };
+    removed = Probe(GetHeaderPage(old_header_page_id_), key, true, remove_pair);
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  }
+  MaintainResize();
+  table_latch_.WUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  StartResize(2 * initial_size);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::IsResizing() -> bool {
+  table_latch_.RLock();
+  bool resizing = old_header_page_id_ != INVALID_PAGE_ID;
+  table_latch_.RUnlock();
+  return resizing;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::StartResize(size_t size) -> bool {
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    // 同时只保留两张表，上一次扩容还没搬完就先搬完
+    MoveSlots(std::numeric_limits<size_t>::max());
+  }
+  auto *header_page = GetHeaderPage(header_page_id_);
+  size_t num_blocks = std::min((size + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE, HashTableHeaderPage::MaxBlocks());
+  bool can_grow = num_blocks > header_page->NumBlocks();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (!can_grow) {
+    return false;
+  }
+
+  // 只分配新表的块，元素留给之后的操作一点点搬
+  page_id_t new_header_page_id;
+  auto *new_header_page =
+      reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->NewPage(&new_header_page_id)->GetData());
+  new_header_page->SetPageId(new_header_page_id);
+  CreateNewBlockPages(new_header_page, num_blocks);
+  buffer_pool_manager_->UnpinPage(new_header_page_id, true);
+
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = new_header_page_id;
+  next_move_slot_ = 0;
+  stats_ = LinearProbeStats();
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MoveSlots(size_t num_slots) {
+  auto *old_header_page = GetHeaderPage(old_header_page_id_);
+  auto *header_page = GetHeaderPage(header_page_id_);
+  const size_t old_size = old_header_page->GetSize();
+  const size_t end = num_slots >= old_size - next_move_slot_ ? old_size : next_move_slot_ + num_slots;
+  while (next_move_slot_ < end) {
+    page_id_t block_page_id = old_header_page->GetBlockPageId(next_move_slot_ / BLOCK_ARRAY_SIZE);
+    auto *block_page = GetBlockPage(block_page_id);
+    // 一次处理同一个块里的所有待搬槽位；搬走的元素在旧表里只留墓碑，不打断还没搬的元素的探测链
+    size_t block_end = std::min(end, (next_move_slot_ / BLOCK_ARRAY_SIZE + 1) * BLOCK_ARRAY_SIZE);
+    for (; next_move_slot_ < block_end; next_move_slot_++) {
+      slot_offset_t offset = next_move_slot_ % BLOCK_ARRAY_SIZE;
+      if (block_page->IsReadable(offset)) {
+        // 插入放在断言外面，NDEBUG 下也要执行
+        [[maybe_unused]] bool inserted =
+            RobinHoodInsert(header_page, block_page->KeyAt(offset), block_page->ValueAt(offset));
+        BUSTUB_ASSERT(inserted, "the grown table cannot be full");
+        block_page->Remove(offset);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  if (next_move_slot_ == old_size) {
+    DeleteBlockPages(old_header_page);
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+    buffer_pool_manager_->DeletePage(old_header_page_id_);
+    old_header_page_id_ = INVALID_PAGE_ID;
+  } else {
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MaintainResize() {
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    MoveSlots(RESIZE_STEP_SLOTS);
+    return;
+  }
+  size_t size = GetSizeLatchFree();
+  if (stats_.num_entries_ * MAX_LOAD_DENOMINATOR > size * MAX_LOAD_NUMERATOR) {
+    StartResize(2 * size);
+  }
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+  table_latch_.RLock();
+  size_t size = GetSizeLatchFree();
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetProbeStats() -> LinearProbeStats {
+  table_latch_.RLock();
+  LinearProbeStats stats = stats_;
+  table_latch_.RUnlock();
+  return stats;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetSizeLatchFree() -> size_t {
+  size_t size = GetHeaderPage(header_page_id_)->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  return size;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -1,29 +1,177 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx) {}
-
-void AggregationExecutor::Init() {}
-
-auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+#include "execution/parallel_pipeline.h"
+
+namespace bustub {
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      layout_(plan, &plan->GetChildPlan()->OutputSchema()) {}
+
+auto AggregationExecutor::MakeLocalAggregation() -> LocalAggregation {
+  LocalAggregation local;
+  for (size_t partition = 0; partition < NUM_PARTITIONS; partition++) {
+    local.tables_.emplace_back(&layout_);
+    local.runs_.emplace_back(exec_ctx_->GetBufferPoolManager());
+  }
+  return local;
+}
+
+void AggregationExecutor::Accumulate(LocalAggregation *local, TupleBatch *batch, size_t budget) {
+  for (size_t i = 0; i < batch->Size(); i++) {
+    const Tuple &tuple = batch->GetTuple(i);
+    auto hash = layout_.EncodeKey(tuple, &local->key_);
+    auto &table = local->tables_[PartitionOf(hash)];
+    table.Accumulate(table.FindOrInsert(local->key_.data(), local->key_.size(), hash), tuple);
+  }
+  size_t memory = 0;
+  for (const auto &table : local->tables_) {
+    memory += table.GetMemoryUsage();
+  }
+  if (memory > budget) {
+    Spill(local);
+  }
+}
+
+void AggregationExecutor::Spill(LocalAggregation *local) {
+  for (size_t partition = 0; partition < NUM_PARTITIONS; partition++) {
+    auto &table = local->tables_[partition];
+    if (table.GetNumGroups() == 0) {
+      continue;
+    }
+    // 每次溢写完都 unpin 尾页，免得每个分区各占着一帧
+    table.WriteTo(&local->runs_[partition]);
+    local->runs_[partition].Finish();
+    table.Clear();
+  }
+  local->spilled_ = true;
+}
+
+void AggregationExecutor::MergePartition(size_t partition) {
+  auto &merged = partitions_[partition];
+  std::vector<Tuple> partials;
+  for (auto &local : locals_) {
+    merged.MergeFrom(local.tables_[partition]);
+    local.tables_[partition].Clear();
+    auto &run = local.runs_[partition];
+    for (size_t page = 0; page < run.GetNumPages(); page++) {
+      partials.clear();
+      run.ReadPage(page, &partials);
+      for (const auto &partial : partials) {
+        merged.MergeFrom(partial);
+      }
+    }
+    run = TmpTupleRun(exec_ctx_->GetBufferPoolManager());
+  }
+}
+
+void AggregationExecutor::Init() {
+  locals_.clear();
+  partitions_.clear();
+  for (size_t partition = 0; partition < NUM_PARTITIONS; partition++) {
+    partitions_.emplace_back(&layout_);
+  }
+  partition_ = 0;
+  group_ = 0;
+
+  auto *pool = exec_ctx_->GetWorkerPool();
+  if (ParallelPipeline::CanRun(exec_ctx_, *plan_->GetChildPlan())) {
+    // 每个 worker 先聚合到自己的表里，内存超出自己那一份就溢写
+    auto num_workers = exec_ctx_->GetParallelism();
+    for (size_t worker = 0; worker < num_workers; worker++) {
+      locals_.push_back(MakeLocalAggregation());
+    }
+    auto budget = exec_ctx_->GetMemoryBudget() / num_workers;
+    ParallelPipeline::Run(exec_ctx_, plan_->GetChildPlan(), [&](size_t worker_id, TupleBatch *batch) {
+      Accumulate(&locals_[worker_id], batch, budget);
+    });
+  } else {
+    // 按批从子节点拉取，聚合到一组表里
+    locals_.push_back(MakeLocalAggregation());
+    child_->Init();
+    TupleBatch batch;
+    while (child_->NextBatch(&batch)) {
+      Accumulate(&locals_[0], &batch, exec_ctx_->GetMemoryBudget());
+    }
+  }
+  // 空输入也要输出没有group by时那一组的初始值，比如count(*)为0；初始值合并进别的部分结果不影响结果
+  if (plan_->GetGroupBys().empty()) {
+    auto hash = AggregationLayout::HashKey("", 0);
+    locals_[0].tables_[PartitionOf(hash)].FindOrInsert("", 0, hash);
+  }
+
+  spilled_ = std::any_of(locals_.begin(), locals_.end(), [](const auto &local) { return local.spilled_; });
+  if (spilled_) {
+    // 有溢写时输出到哪个分区才合并哪个，同一时间内存里只有一个合并好的分区
+    MergePartition(0);
+    return;
+  }
+  // 没有溢写时各个分区互不相干，分给 worker 并行合并
+  if (pool == nullptr || locals_.size() == 1) {
+    partitions_ = std::move(locals_[0].tables_);
+    locals_.clear();
+    return;
+  }
+  pool->Run(locals_.size(), [&](size_t worker) {
+    for (size_t partition = worker; partition < NUM_PARTITIONS; partition += locals_.size()) {
+      MergePartition(partition);
+    }
+  });
+  locals_.clear();
+}
+
+auto AggregationExecutor::Advance() -> bool {
+  while (partition_ < NUM_PARTITIONS) {
+    if (group_ < partitions_[partition_].GetNumGroups()) {
+      return true;
+    }
+    partitions_[partition_].Clear();
+    partition_++;
+    group_ = 0;
+    if (spilled_ && partition_ < NUM_PARTITIONS) {
+      MergePartition(partition_);
+    }
+  }
+  return false;
+}
+
+auto AggregationExecutor::MakeOutputTuple() -> Tuple {
+  return partitions_[partition_].MakeOutputTuple(group_++, &GetOutputSchema());
+}
+
+auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (!Advance()) {
+    return false;
+  }
+  *tuple = MakeOutputTuple();
+  return true;
+}
+
+auto AggregationExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset();
+  while (!batch->IsFull() && Advance()) {
+    batch->Append(MakeOutputTuple(), RID{});
+  }
+  return !batch->IsEmpty();
+}
+
+auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
+
+}  // namespace bustub
@@ -0,0 +1,376 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_table.cpp
+//
+// Identification: src/execution/aggregation_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/aggregation_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto DoubleToWord(double number) -> int64_t {
+  int64_t word;
+  memcpy(&word, &number, sizeof(word));
+  return word;
+}
+
+auto WordToDouble(int64_t word) -> double {
+  double number;
+  memcpy(&number, &word, sizeof(number));
+  return number;
+}
+
+auto ToInt64(const Value &value) -> int64_t {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+/** Combine a non-NULL input into a non-NULL running aggregate; counts are sums of ones */
+template <class T>
+auto CombineNumbers(AggregationType type, T acc, T input) -> T {
+  switch (type) {
+    case AggregationType::CountStarAggregate:
+    case AggregationType::CountAggregate:
+    case AggregationType::SumAggregate:
+      return acc + input;
+    case AggregationType::MinAggregate:
+      return std::min(acc, input);
+    case AggregationType::MaxAggregate:
+      return std::max(acc, input);
+  }
+  return acc;
+}
+
+/** @return the bytes SerializeTo() writes for a value */
+auto SerializedSize(const Value &value) -> size_t {
+  if (value.GetTypeId() != TypeId::VARCHAR) {
+    return Type::GetTypeSize(value.GetTypeId());
+  }
+  return sizeof(uint32_t) + (value.IsNull() ? 0 : value.GetLength());
+}
+
+}  // namespace
+
+AggregationLayout::AggregationLayout(const AggregationPlanNode *plan, const Schema *input_schema)
+    : plan_(plan), input_schema_(input_schema) {
+  for (const auto &expr : plan->GetGroupBys()) {
+    key_types_.push_back(expr->GetReturnType());
+  }
+  for (size_t i = 0; i < plan->GetAggregates().size(); i++) {
+    auto type = plan->GetAggregates()[i]->GetReturnType();
+    auto agg_type = plan->GetAggregateTypes()[i];
+    auto accumulator = Accumulator::VALUE;
+    if (agg_type == AggregationType::CountStarAggregate || agg_type == AggregationType::CountAggregate) {
+      accumulator = Accumulator::COUNT;
+    } else if (type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER ||
+               type == TypeId::BIGINT) {
+      accumulator = Accumulator::INTEGER;
+    } else if (type == TypeId::DECIMAL) {
+      accumulator = Accumulator::DECIMAL;
+    }
+    accumulators_.push_back(accumulator);
+    input_types_.push_back(type);
+    value_slots_.push_back(static_cast<uint32_t>(num_values_));
+    if (accumulator == Accumulator::VALUE) {
+      num_values_++;
+    }
+  }
+}
+
+auto AggregationLayout::EncodeKey(const Tuple &tuple, std::vector<char> *key) const -> hash_t {
+  key->clear();
+  for (size_t i = 0; i < key_types_.size(); i++) {
+    auto type = key_types_[i];
+    auto value = plan_->GetGroupBys()[i]->Evaluate(&tuple, *input_schema_);
+    // NULL 一律换成声明类型的 NULL，保证相等的键字节也相同
+    if (value.IsNull()) {
+      value = ValueFactory::GetNullValueByType(type);
+    } else if (value.GetTypeId() != type) {
+      value = value.CastAs(type);
+    }
+    auto offset = key->size();
+    key->resize(offset + SerializedSize(value));
+    value.SerializeTo(key->data() + offset);
+  }
+  return HashKey(key->data(), key->size());
+}
+
+auto AggregationTable::FindOrInsert(const char *key, size_t key_size, hash_t hash) -> uint32_t {
+  if ((GetNumGroups() + 1) * 2 > slots_.size()) {
+    Grow();
+  }
+  auto mask = slots_.size() - 1;
+  auto tag = TagOf(hash);
+  for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    auto &slot = slots_[pos];
+    if (slot.group_ == 0) {
+      break;
+    }
+    // 标签相同才去比较键
+    auto group = slot.group_ - 1;
+    if (slot.tag_ == tag && KeySizeOf(group) == key_size && memcmp(KeyOf(group), key, key_size) == 0) {
+      return group;
+    }
+  }
+
+  auto group = static_cast<uint32_t>(GetNumGroups());
+  keys_.insert(keys_.end(), key, key + key_size);
+  key_offsets_.push_back(static_cast<uint32_t>(keys_.size()));
+  hashes_.push_back(hash);
+  // count(*) 从 0 开始，其他聚合在第一个非 NULL 输入之前都是 NULL
+  for (auto agg_type : layout_->plan_->GetAggregateTypes()) {
+    accumulators_.push_back(0);
+    valid_.push_back(static_cast<uint8_t>(agg_type == AggregationType::CountStarAggregate));
+  }
+  values_.resize(values_.size() + layout_->num_values_, ValueFactory::GetNullValueByType(TypeId::INTEGER));
+  for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    if (slots_[pos].group_ == 0) {
+      slots_[pos] = Slot{tag, group + 1};
+      break;
+    }
+  }
+  return group;
+}
+
+void AggregationTable::Grow() {
+  std::vector<Slot> slots(std::max<size_t>(slots_.size() * 2, 16), Slot{0, 0});
+  auto mask = slots.size() - 1;
+  for (uint32_t group = 0; group < GetNumGroups(); group++) {
+    auto pos = hashes_[group] & mask;
+    while (slots[pos].group_ != 0) {
+      pos = (pos + 1) & mask;
+    }
+    slots[pos] = Slot{TagOf(hashes_[group]), group + 1};
+  }
+  slots_ = std::move(slots);
+}
+
+void AggregationTable::CombineWord(uint32_t group, size_t aggregate, int64_t word) {
+  auto index = group * layout_->accumulators_.size() + aggregate;
+  auto &acc = accumulators_[index];
+  if (valid_[index] == 0) {
+    acc = word;
+    valid_[index] = 1;
+    return;
+  }
+  auto agg_type = layout_->plan_->GetAggregateTypes()[aggregate];
+  if (layout_->accumulators_[aggregate] == AggregationLayout::Accumulator::DECIMAL) {
+    acc = DoubleToWord(CombineNumbers(agg_type, WordToDouble(acc), WordToDouble(word)));
+  } else {
+    acc = CombineNumbers(agg_type, acc, word);
+  }
+}
+
+void AggregationTable::CombineValue(uint32_t group, size_t aggregate, const Value &value) {
+  auto index = group * layout_->accumulators_.size() + aggregate;
+  auto &acc = values_[group * layout_->num_values_ + layout_->value_slots_[aggregate]];
+  if (valid_[index] == 0) {
+    acc = value;
+    valid_[index] = 1;
+    return;
+  }
+  switch (layout_->plan_->GetAggregateTypes()[aggregate]) {
+    case AggregationType::MinAggregate:
+      if (value.CompareLessThan(acc) == CmpBool::CmpTrue) {
+        acc = value;
+      }
+      break;
+    case AggregationType::MaxAggregate:
+      if (value.CompareGreaterThan(acc) == CmpBool::CmpTrue) {
+        acc = value;
+      }
+      break;
+    default:
+      acc = acc.Add(value);
+      break;
+  }
+}
+
+void AggregationTable::Accumulate(uint32_t group, const Tuple &tuple) {
+  const auto &aggregates = layout_->plan_->GetAggregates();
+  for (size_t i = 0; i < aggregates.size(); i++) {
+    if (layout_->plan_->GetAggregateTypes()[i] == AggregationType::CountStarAggregate) {
+      CombineWord(group, i, 1);
+      continue;
+    }
+    auto value = aggregates[i]->Evaluate(&tuple, *layout_->input_schema_);
+    if (value.IsNull()) {
+      continue;
+    }
+    switch (layout_->accumulators_[i]) {
+      case AggregationLayout::Accumulator::COUNT:
+        CombineWord(group, i, 1);
+        break;
+      case AggregationLayout::Accumulator::INTEGER:
+        CombineWord(group, i, ToInt64(value));
+        break;
+      case AggregationLayout::Accumulator::DECIMAL:
+        CombineWord(group, i, DoubleToWord(value.GetAs<double>()));
+        break;
+      case AggregationLayout::Accumulator::VALUE:
+        CombineValue(group, i, value);
+        break;
+    }
+  }
+}
+
+void AggregationTable::MergeAccumulators(uint32_t group, const uint8_t *valid, const int64_t *accumulators,
+                                         const Value *values) {
+  for (size_t i = 0; i < layout_->accumulators_.size(); i++) {
+    if (valid[i] == 0) {
+      continue;
+    }
+    if (layout_->accumulators_[i] == AggregationLayout::Accumulator::VALUE) {
+      CombineValue(group, i, values[layout_->value_slots_[i]]);
+    } else {
+      CombineWord(group, i, accumulators[i]);
+    }
+  }
+}
+
+void AggregationTable::MergeFrom(const AggregationTable &other) {
+  auto num_aggregates = layout_->accumulators_.size();
+  for (uint32_t group = 0; group < other.GetNumGroups(); group++) {
+    auto target = FindOrInsert(other.KeyOf(group), other.KeySizeOf(group), other.hashes_[group]);
+    MergeAccumulators(target, &other.valid_[group * num_aggregates], &other.accumulators_[group * num_aggregates],
+                      other.values_.data() + group * layout_->num_values_);
+  }
+}
+
+void AggregationTable::WriteTo(TmpTupleRun *run) const {
+  // 一行部分聚合：[哈希][键长][键][非 NULL 标记][累加器][各个 Value 的类型和序列化]
+  auto num_aggregates = layout_->accumulators_.size();
+  std::vector<char> buffer;
+  for (uint32_t group = 0; group < GetNumGroups(); group++) {
+    auto key_size = static_cast<uint32_t>(KeySizeOf(group));
+    const auto *values = values_.data() + group * layout_->num_values_;
+    size_t size = sizeof(hash_t) + sizeof(uint32_t) + key_size + num_aggregates * (1 + sizeof(int64_t));
+    for (size_t i = 0; i < layout_->num_values_; i++) {
+      size += 1 + SerializedSize(values[i]);
+    }
+    buffer.resize(sizeof(uint32_t) + size);
+    auto size32 = static_cast<uint32_t>(size);
+    memcpy(buffer.data(), &size32, sizeof(size32));
+    char *out = buffer.data() + sizeof(uint32_t);
+    memcpy(out, &hashes_[group], sizeof(hash_t));
+    out += sizeof(hash_t);
+    memcpy(out, &key_size, sizeof(key_size));
+    out += sizeof(key_size);
+    memcpy(out, KeyOf(group), key_size);
+    out += key_size;
+    memcpy(out, &valid_[group * num_aggregates], num_aggregates);
+    out += num_aggregates;
+    memcpy(out, &accumulators_[group * num_aggregates], num_aggregates * sizeof(int64_t));
+    out += num_aggregates * sizeof(int64_t);
+    for (size_t i = 0; i < layout_->num_values_; i++) {
+      *out++ = static_cast<char>(values[i].GetTypeId());
+      values[i].SerializeTo(out);
+      out += SerializedSize(values[i]);
+    }
+    Tuple partial;
+    partial.DeserializeFrom(buffer.data());
+    run->Append(partial);
+  }
+}
+
+void AggregationTable::MergeFrom(const Tuple &partial) {
+  auto num_aggregates = layout_->accumulators_.size();
+  const char *in = partial.GetData();
+  hash_t hash;
+  memcpy(&hash, in, sizeof(hash));
+  in += sizeof(hash);
+  uint32_t key_size;
+  memcpy(&key_size, in, sizeof(key_size));
+  in += sizeof(key_size);
+  auto group = FindOrInsert(in, key_size, hash);
+  in += key_size;
+  const auto *valid = reinterpret_cast<const uint8_t *>(in);
+  in += num_aggregates;
+  // 溢写的数据不保证对齐，累加器拷出来再用
+  std::vector<int64_t> accumulators(num_aggregates);
+  memcpy(accumulators.data(), in, num_aggregates * sizeof(int64_t));
+  in += num_aggregates * sizeof(int64_t);
+  std::vector<Value> values;
+  values.reserve(layout_->num_values_);
+  for (size_t i = 0; i < layout_->num_values_; i++) {
+    auto type = static_cast<TypeId>(*in++);
+    values.push_back(Value::DeserializeFrom(in, type));
+    in += SerializedSize(values.back());
+  }
+  MergeAccumulators(group, valid, accumulators.data(), values.data());
+}
+
+auto AggregationTable::GetMemoryUsage() const -> size_t {
+  return slots_.capacity() * sizeof(Slot) + keys_.capacity() + key_offsets_.capacity() * sizeof(uint32_t) +
+         hashes_.capacity() * sizeof(hash_t) + accumulators_.capacity() * sizeof(int64_t) + valid_.capacity() +
+         values_.capacity() * sizeof(Value);
+}
+
+auto AggregationTable::MakeOutputTuple(uint32_t group, const Schema *output_schema) const -> Tuple {
+  std::vector<Value> values;
+  values.reserve(output_schema->GetColumnCount());
+  const char *key = KeyOf(group);
+  for (auto type : layout_->key_types_) {
+    values.push_back(Value::DeserializeFrom(key, type));
+    key += SerializedSize(values.back());
+  }
+  auto num_aggregates = layout_->accumulators_.size();
+  for (size_t i = 0; i < num_aggregates; i++) {
+    auto index = group * num_aggregates + i;
+    auto acc = accumulators_[index];
+    if (valid_[index] == 0) {
+      values.push_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+      continue;
+    }
+    switch (layout_->accumulators_[i]) {
+      case AggregationLayout::Accumulator::COUNT:
+        values.push_back(ValueFactory::GetIntegerValue(static_cast<int32_t>(acc)));
+        break;
+      case AggregationLayout::Accumulator::INTEGER:
+        // 和逐个 Value 相加一样，结果超出输入类型的范围时报错
+        values.push_back(ValueFactory::GetBigIntValue(acc).CastAs(layout_->input_types_[i]));
+        break;
+      case AggregationLayout::Accumulator::DECIMAL:
+        values.push_back(ValueFactory::GetDecimalValue(WordToDouble(acc)));
+        break;
+      case AggregationLayout::Accumulator::VALUE:
+        values.push_back(values_[group * layout_->num_values_ + layout_->value_slots_[i]]);
+        break;
+    }
+  }
+  return Tuple{std::move(values), output_schema};
+}
+
+void AggregationTable::Clear() {
+  // 用 swap 释放内存，clear 只会保留容量
+  std::vector<Slot>().swap(slots_);
+  std::vector<char>().swap(keys_);
+  std::vector<uint32_t>{0}.swap(key_offsets_);
+  std::vector<hash_t>().swap(hashes_);
+  std::vector<int64_t>().swap(accumulators_);
+  std::vector<uint8_t>().swap(valid_);
+  std::vector<Value>().swap(values_);
+}
+
+}  // namespace bustub
@@ -23,6 +23,7 @@
 #include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/limit_executor.h"
+#include "execution/executors/merge_join_executor.h"
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
@@ -114,6 +115,14 @@ auto ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx, const AbstractPl
       return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
     }
 
+    // Create a new merge join executor
+    case PlanType::MergeJoin: {
+      auto merge_join_plan = dynamic_cast<const MergeJoinPlanNode *>(plan.get());
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, merge_join_plan->GetLeftPlan());
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, merge_join_plan->GetRightPlan());
+      return std::make_unique<MergeJoinExecutor>(exec_ctx, merge_join_plan, std::move(left), std::move(right));
+    }
+
     // Create a new mock scan executor
     case PlanType::MockScan: {
       const auto *mock_scan_plan = dynamic_cast<const MockScanPlanNode *>(plan.get());
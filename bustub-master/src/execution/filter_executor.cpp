@@ -31,4 +31,20 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 }
 
+auto FilterExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &filter_expr = plan_->GetPredicate();
+  const auto &child_schema = child_executor_->GetOutputSchema();
+  // 在子节点的批上原地缩小选择向量，不拷贝留下的元组；整批都不满足就接着拉下一批
+  while (child_executor_->NextBatch(batch)) {
+    batch->Select([&](const Tuple &tuple) {
+      auto value = filter_expr->Evaluate(&tuple, child_schema);
+      return !value.IsNull() && value.GetAs<bool>();
+    });
+    if (!batch->IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace bustub
@@ -12,6 +12,12 @@
 
 #include "execution/executors/hash_join_executor.h"
 
+#include "execution/executor_factory.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/parallel_pipeline.h"
+#include "execution/plans/projection_plan.h"
+#include "type/value_factory.h"
+
 // Note for 2022 Fall: You don't need to implement HashJoinExecutor to pass all tests. You ONLY need to implement it
 // if you want to get faster in leaderboard tests.
 
@@ -20,15 +26,398 @@ namespace bustub {
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_child_(std::move(left_child)),
+      right_child_(std::move(right_child)) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void HashJoinExecutor::Init() { throw NotImplementedException("HashJoinExecutor is not implemented"); }
+void HashJoinExecutor::InsertBatch(const HashJoinPlanNode *plan, const Schema &right_schema, TupleBatch *batch,
+                                   RadixJoinTable *ht) {
+  for (size_t i = 0; i < batch->Size(); i++) {
+    auto key = plan->RightJoinKeyExpression().Evaluate(&batch->GetTuple(i), right_schema);
+    if (!key.IsNull()) {
+      ht->Insert(std::move(batch->GetTuple(i)), key);
+    }
+  }
+}
+
+auto HashJoinExecutor::BuildHashTable(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan)
+    -> std::shared_ptr<RadixJoinTable> {
+  auto ht = std::make_shared<RadixJoinTable>();
+  const auto &right_schema = plan->GetRightPlan()->OutputSchema();
+  if (ParallelPipeline::CanRun(exec_ctx, *plan->GetRightPlan())) {
+    // 每个 worker 收集自己的行，最后拼到一起统一分区建表
+    std::vector<RadixJoinTable> locals(exec_ctx->GetParallelism());
+    ParallelPipeline::Run(exec_ctx, plan->GetRightPlan(), [&](size_t worker_id, TupleBatch *batch) {
+      InsertBatch(plan, right_schema, batch, &locals[worker_id]);
+    });
+    for (auto &local : locals) {
+      ht->Append(std::move(local));
+    }
+    ht->Build();
+    PublishRuntimeFilter(exec_ctx, plan, *ht);
+    return ht;
+  }
+  auto right_child = ExecutorFactory::CreateExecutor(exec_ctx, plan->GetRightPlan());
+  // 右表建哈希表，按批拉取，元组直接移进桶里
+  right_child->Init();
+  TupleBatch batch;
+  while (right_child->NextBatch(&batch)) {
+    InsertBatch(plan, right_schema, &batch, ht.get());
+  }
+  ht->Build();
+  PublishRuntimeFilter(exec_ctx, plan, *ht);
+  return ht;
+}
+
+void HashJoinExecutor::PublishRuntimeFilter(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                            const RadixJoinTable &ht) {
+  // 左连接要保留所有左元组，不能提前过滤
+  if (plan->GetJoinType() != JoinType::INNER) {
+    return;
+  }
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(&plan->LeftJoinKeyExpression());
+  if (column == nullptr) {
+    return;
+  }
+  // 顺着探测侧往下找产出这一列的扫描，途中的节点都不能改变这一列的值
+  uint32_t col_idx = column->GetColIdx();
+  const AbstractPlanNode *node = plan->GetLeftPlan().get();
+  while (node->GetType() != PlanType::SeqScan) {
+    switch (node->GetType()) {
+      case PlanType::Filter:
+        break;
+      case PlanType::Projection: {
+        const auto &expr = dynamic_cast<const ProjectionPlanNode *>(node)->GetExpressions()[col_idx];
+        column = dynamic_cast<const ColumnValueExpression *>(expr.get());
+        if (column == nullptr) {
+          return;
+        }
+        col_idx = column->GetColIdx();
+        break;
+      }
+      case PlanType::HashJoin:
+        // 下面一层连接的输出先是它左孩子的列
+        if (col_idx >= node->GetChildAt(0)->OutputSchema().GetColumnCount()) {
+          return;
+        }
+        break;
+      default:
+        return;
+    }
+    node = node->GetChildAt(0).get();
+  }
+  auto filter = std::make_shared<BlockedBloomFilter>(ht.GetNumRows(), RUNTIME_FILTER_BITS_PER_KEY);
+  for (size_t row = 0; row < ht.GetNumRows(); row++) {
+    filter->Insert(ht.GetHash(row));
+  }
+  exec_ctx->SetRuntimeFilter(node, plan, RuntimeFilter{col_idx, std::move(filter)});
+}
+
+auto HashJoinExecutor::PartitionOf(hash_t hash, size_t depth) -> size_t {
+  // 每一层用哈希值更低的下一段位，从高位开始取，和哈希表自己分区用的低位错开
+  return (static_cast<uint64_t>(hash) >> (64 - GRACE_FANOUT_BITS * (depth + 1))) & (GRACE_FANOUT - 1);
+}
+
+auto HashJoinExecutor::MakePartitions(size_t depth) const -> std::vector<JoinPartition> {
+  auto *bpm = exec_ctx_->GetBufferPoolManager();
+  std::vector<JoinPartition> partitions;
+  partitions.reserve(GRACE_FANOUT);
+  for (size_t i = 0; i < GRACE_FANOUT; i++) {
+    partitions.push_back(JoinPartition{TmpTupleRun(bpm), TmpTupleRun(bpm), depth});
+  }
+  return partitions;
+}
+
+void HashJoinExecutor::FinishRuns(std::vector<JoinPartition> *partitions) {
+  // 每写完一批（重新分区时是一页）就解除各分区尾页的 pin，拉下一批时孩子（比如下面的连接）还能用这些帧
+  for (auto &partition : *partitions) {
+    partition.right_.Finish();
+    partition.left_.Finish();
+  }
+}
+
+void HashJoinExecutor::PushPartitions(std::vector<JoinPartition> *partitions) {
+  FinishRuns(partitions);
+  for (auto &partition : *partitions) {
+    // 左边为空的分区没有输出；内连接时右边为空的也没有
+    bool has_output = partition.left_.GetNumTuples() > 0 &&
+                      (partition.right_.GetNumTuples() > 0 || plan_->GetJoinType() == JoinType::LEFT);
+    if (has_output) {
+      pending_.push_back(std::move(partition));
+    }
+  }
+  partitions->clear();
+}
+
+void HashJoinExecutor::BuildOrPartition() {
+  right_child_->Init();
+  const auto &right_schema = right_child_->GetOutputSchema();
+  auto ht = std::make_shared<RadixJoinTable>();
+  size_t num_bytes = 0;
+  size_t num_tuples = 0;
+  std::vector<JoinPartition> partitions;
+  TupleBatch batch;
+  while (right_child_->NextBatch(&batch)) {
+    if (partitions.empty()) {
+      for (size_t i = 0; i < batch.Size(); i++) {
+        num_bytes += batch.GetTuple(i).GetLength();
+      }
+      num_tuples += batch.Size();
+      InsertBatch(plan_, right_schema, &batch, ht.get());
+      if (Footprint(num_bytes, num_tuples) > exec_ctx_->GetMemoryBudget()) {
+        // 超出内存预算，已经建好的部分和后面的输入都按哈希分区写到临时页上
+        partitions = MakePartitions(0);
+        for (size_t row = 0; row < ht->GetNumRows(); row++) {
+          partitions[PartitionOf(ht->GetHash(row), 0)].right_.Append(ht->GetRow(row));
+        }
+        ht.reset();
+        FinishRuns(&partitions);
+      }
+      continue;
+    }
+    for (size_t i = 0; i < batch.Size(); i++) {
+      auto key = plan_->RightJoinKeyExpression().Evaluate(&batch.GetTuple(i), right_schema);
+      if (!key.IsNull()) {
+        partitions[PartitionOf(RadixJoinTable::HashOf(key), 0)].right_.Append(batch.GetTuple(i));
+      }
+    }
+    FinishRuns(&partitions);
+  }
+  if (partitions.empty()) {
+    ht->Build();
+    PublishRuntimeFilter(exec_ctx_, plan_, *ht);
+    ht_ = std::move(ht);
+    return;
+  }
+  // 右边的分区先放着，等左孩子初始化后再把左表分进去
+  spilled_ = true;
+  pending_ = std::move(partitions);
+}
+
+void HashJoinExecutor::PartitionLeft() {
+  // 左表整个读完再分区；连接键为 NULL 的左元组不会匹配，左连接时单独放一个右边为空的分区
+  auto partitions = std::move(pending_);
+  pending_.clear();
+  const auto &left_schema = left_child_->GetOutputSchema();
+  TupleBatch batch;
+  JoinPartition null_keys{TmpTupleRun(exec_ctx_->GetBufferPoolManager()),
+                          TmpTupleRun(exec_ctx_->GetBufferPoolManager()), GRACE_MAX_DEPTH};
+  while (left_child_->NextBatch(&batch)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      auto key = plan_->LeftJoinKeyExpression().Evaluate(&batch.GetTuple(i), left_schema);
+      if (!key.IsNull()) {
+        partitions[PartitionOf(RadixJoinTable::HashOf(key), 0)].left_.Append(batch.GetTuple(i));
+      } else if (plan_->GetJoinType() == JoinType::LEFT) {
+        null_keys.left_.Append(batch.GetTuple(i));
+      }
+    }
+    FinishRuns(&partitions);
+    null_keys.left_.Finish();
+  }
+  partitions.push_back(std::move(null_keys));
+  PushPartitions(&partitions);
+}
+
+void HashJoinExecutor::Repartition(JoinPartition *partition) {
+  auto children = MakePartitions(partition->depth_ + 1);
+  const auto &right_schema = right_child_->GetOutputSchema();
+  for (size_t page = 0; page < partition->right_.GetNumPages(); page++) {
+    page_tuples_.clear();
+    partition->right_.ReadPage(page, &page_tuples_);
+    for (const auto &tuple : page_tuples_) {
+      auto key = plan_->RightJoinKeyExpression().Evaluate(&tuple, right_schema);
+      children[PartitionOf(RadixJoinTable::HashOf(key), partition->depth_ + 1)].right_.Append(tuple);
+    }
+    FinishRuns(&children);
+  }
+  const auto &left_schema = left_child_->GetOutputSchema();
+  for (size_t page = 0; page < partition->left_.GetNumPages(); page++) {
+    page_tuples_.clear();
+    partition->left_.ReadPage(page, &page_tuples_);
+    for (const auto &tuple : page_tuples_) {
+      auto key = plan_->LeftJoinKeyExpression().Evaluate(&tuple, left_schema);
+      children[PartitionOf(RadixJoinTable::HashOf(key), partition->depth_ + 1)].left_.Append(tuple);
+    }
+    FinishRuns(&children);
+  }
+  PushPartitions(&children);
+}
+
+auto HashJoinExecutor::NextPartition() -> bool {
+  current_.reset();
+  while (!pending_.empty()) {
+    JoinPartition partition = std::move(pending_.back());
+    pending_.pop_back();
+    const auto &right = partition.right_;
+    if (Footprint(right.GetNumBytes(), right.GetNumTuples()) > exec_ctx_->GetMemoryBudget() &&
+        partition.depth_ < GRACE_MAX_DEPTH) {
+      Repartition(&partition);
+      continue;
+    }
+    auto ht = std::make_shared<RadixJoinTable>();
+    const auto &right_schema = right_child_->GetOutputSchema();
+    for (size_t page = 0; page < partition.right_.GetNumPages(); page++) {
+      page_tuples_.clear();
+      partition.right_.ReadPage(page, &page_tuples_);
+      for (auto &tuple : page_tuples_) {
+        auto key = plan_->RightJoinKeyExpression().Evaluate(&tuple, right_schema);
+        ht->Insert(std::move(tuple), key);
+      }
+    }
+    ht->Build();
+    ht_ = std::move(ht);
+    current_ = std::move(partition);
+    left_page_ = 0;
+    return true;
+  }
+  return false;
+}
+
+auto HashJoinExecutor::NextLeftBatch() -> bool {
+  if (!spilled_) {
+    return left_child_->NextBatch(&left_batch_);
+  }
+  left_batch_.Reset();
+  while (!current_.has_value() || left_page_ == current_->left_.GetNumPages()) {
+    if (!NextPartition()) {
+      return false;
+    }
+  }
+  // 一页临时页的元组数不超过一批的容量，一次放一页
+  page_tuples_.clear();
+  current_->left_.ReadPage(left_page_++, &page_tuples_);
+  for (auto &tuple : page_tuples_) {
+    left_batch_.Append(std::move(tuple), RID{});
+  }
+  return true;
+}
+
+void HashJoinExecutor::Init() {
+  spilled_ = false;
+  pending_.clear();
+  current_.reset();
+  left_page_ = 0;
+  // 属于并行流水线时，表已经由流水线建好并共享出来
+  ht_ = exec_ctx_->GetSharedState<const RadixJoinTable>(plan_);
+  if (ht_ == nullptr) {
+    if (ParallelPipeline::CanRun(exec_ctx_, *plan_->GetRightPlan())) {
+      ht_ = BuildHashTable(exec_ctx_, plan_);
+    } else {
+      BuildOrPartition();
+    }
+  }
+  // 建表时已经发布了运行时过滤器，左孩子初始化时扫描才能拿到
+  left_child_->Init();
+  if (spilled_) {
+    PartitionLeft();
+  }
+  left_batch_.Reset();
+  probe_order_.clear();
+  left_cursor_ = 0;
+  probed_ = false;
+  matches_.clear();
+  match_cursor_ = 0;
+}
+
+void HashJoinExecutor::PrepareLeftBatch() {
+  const auto &left_schema = left_child_->GetOutputSchema();
+  size_t size = left_batch_.Size();
+  left_keys_.clear();
+  left_hashes_.resize(size);
+  for (size_t i = 0; i < size; i++) {
+    left_keys_.push_back(plan_->LeftJoinKeyExpression().Evaluate(&left_batch_.GetTuple(i), left_schema));
+    left_hashes_[i] = left_keys_[i].IsNull() ? 0 : RadixJoinTable::HashOf(left_keys_[i]);
+  }
+  probe_order_.resize(size);
+  size_t num_partitions = ht_->GetNumPartitions();
+  if (num_partitions == 1) {
+    for (size_t i = 0; i < size; i++) {
+      probe_order_[i] = static_cast<uint32_t>(i);
+    }
+    return;
+  }
+  // 和建表一样两遍：先按分区计数，再按分区顺序排好探测的次序
+  partition_starts_.assign(num_partitions + 1, 0);
+  for (size_t i = 0; i < size; i++) {
+    partition_starts_[ht_->PartitionOf(left_hashes_[i]) + 1]++;
+  }
+  for (size_t p = 0; p < num_partitions; p++) {
+    partition_starts_[p + 1] += partition_starts_[p];
+  }
+  for (size_t i = 0; i < size; i++) {
+    probe_order_[partition_starts_[ht_->PartitionOf(left_hashes_[i])]++] = static_cast<uint32_t>(i);
+  }
+}
+
+auto HashJoinExecutor::MakeOutputTuple(const Tuple &left_tuple, const Tuple *right_tuple) const -> Tuple {
+  const auto &left_schema = left_child_->GetOutputSchema();
+  const auto &right_schema = right_child_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(GetOutputSchema().GetColumnCount());
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    values.push_back(left_tuple.GetValue(&left_schema, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    values.push_back(right_tuple != nullptr ? right_tuple->GetValue(&right_schema, i)
+                                            : ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+  }
+  return Tuple{std::move(values), &GetOutputSchema()};
+}
+
+auto HashJoinExecutor::NextJoined(Tuple *tuple) -> bool {
+  while (true) {
+    if (left_cursor_ == probe_order_.size()) {
+      // 拉下一批会先清空当前批，游标要一起归零
+      left_cursor_ = 0;
+      probed_ = false;
+      if (!NextLeftBatch()) {
+        probe_order_.clear();
+        return false;
+      }
+      PrepareLeftBatch();
+      continue;
+    }
+    auto left = probe_order_[left_cursor_];
+    const auto &left_tuple = left_batch_.GetTuple(left);
+    if (!probed_) {
+      probed_ = true;
+      match_cursor_ = 0;
+      matches_.clear();
+      if (!left_keys_[left].IsNull()) {
+        ht_->Find(left_keys_[left], left_hashes_[left], &matches_);
+      }
+      if (matches_.empty() && plan_->GetJoinType() == JoinType::LEFT) {
+        *tuple = MakeOutputTuple(left_tuple, nullptr);
+        left_cursor_++;
+        probed_ = false;
+        return true;
+      }
+    }
+    if (match_cursor_ < matches_.size()) {
+      *tuple = MakeOutputTuple(left_tuple, &ht_->GetRow(matches_[match_cursor_++]));
+      return true;
+    }
+    // 当前左元组的匹配都输出完了
+    left_cursor_++;
+    probed_ = false;
+  }
+}
+
+auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextJoined(tuple); }
 
-auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto HashJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset();
+  Tuple tuple;
+  while (!batch->IsFull() && NextJoined(&tuple)) {
+    batch->Append(std::move(tuple), RID{});
+  }
+  return !batch->IsEmpty();
+}
 
 }  // namespace bustub
@@ -10,13 +10,71 @@
 //
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
 
-void IndexScanExecutor::Init() { throw NotImplementedException("IndexScanExecutor is not implemented"); }
+void IndexScanExecutor::Init() {
+  auto *catalog = exec_ctx_->GetCatalog();
+  auto *index_info = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info->table_name_);
 
-auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+  const auto *key_schema = index_info->index_->GetKeySchema();
+  std::optional<Tuple> low;
+  std::optional<Tuple> high;
+  if (plan_->low_key_.has_value()) {
+    low.emplace(std::vector<Value>{*plan_->low_key_}, key_schema);
+  }
+  if (plan_->high_key_.has_value()) {
+    high.emplace(std::vector<Value>{*plan_->high_key_}, key_schema);
+  }
+  scan_ = index_info->index_->ScanRange(low.has_value() ? &*low : nullptr, high.has_value() ? &*high : nullptr,
+                                        plan_->inclusivity_, plan_->direction_, BATCH_SIZE,
+                                        exec_ctx_->GetTransaction());
+  rids_.clear();
+  entries_.clear();
+  cursor_ = 0;
+  entry_schema_ = index_info->index_->GetEntrySchema();
+  entry_attrs_ = index_info->index_->GetEntryAttrs();
+}
+
+auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (plan_->index_only_) {
+    if (cursor_ == rids_.size()) {
+      cursor_ = 0;
+      if (!scan_->NextEntryBatch(&rids_, &entries_)) {
+        return false;
+      }
+    }
+    // columns the index does not store stay NULL, nothing above reads them
+    const auto &output_schema = GetOutputSchema();
+    std::vector<Value> values;
+    values.reserve(output_schema.GetColumnCount());
+    for (const auto &column : output_schema.GetColumns()) {
+      values.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+    }
+    const auto &entry = entries_[cursor_];
+    for (uint32_t i = 0; i < entry_attrs_.size(); i++) {
+      values[entry_attrs_[i]] = entry.GetValue(entry_schema_, i);
+    }
+    *tuple = Tuple(values, &output_schema);
+    *rid = rids_[cursor_++];
+    return true;
+  }
+  while (true) {
+    if (cursor_ == rids_.size()) {
+      cursor_ = 0;
+      if (!scan_->NextBatch(&rids_)) {
+        return false;
+      }
+    }
+    *rid = rids_[cursor_++];
+    if (table_info_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction())) {
+      return true;
+    }
+  }
+}
 
 }  // namespace bustub
@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.cpp
+//
+// Identification: src/execution/merge_join_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/merge_join_executor.h"
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+MergeJoinExecutor::MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                                     std::unique_ptr<AbstractExecutor> &&left_child,
+                                     std::unique_ptr<AbstractExecutor> &&right_child)
+    : AbstractExecutor(exec_ctx), plan_(plan) {
+  if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
+    throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
+  }
+  left_.child_ = std::move(left_child);
+  right_.child_ = std::move(right_child);
+}
+
+void MergeJoinExecutor::Init() {
+  for (auto *input : {&left_, &right_}) {
+    input->child_->Init();
+    input->batch_.Reset();
+    input->cursor_ = 0;
+    input->has_key_ = false;
+    input->exhausted_ = false;
+  }
+  has_left_ = false;
+  run_.clear();
+  has_run_ = false;
+  matched_ = false;
+  run_cursor_ = 0;
+}
+
+auto MergeJoinExecutor::Peek(Input *input) -> Tuple * {
+  while (input->cursor_ == input->batch_.Size()) {
+    // 孩子读完时批次被清空，游标也要归零，之后一直停在空批次的末尾
+    input->cursor_ = 0;
+    if (input->exhausted_ || !input->child_->NextBatch(&input->batch_)) {
+      input->batch_.Reset();
+      input->exhausted_ = true;
+      return nullptr;
+    }
+  }
+  return &input->batch_.GetTuple(input->cursor_);
+}
+
+auto MergeJoinExecutor::AdvanceLeft() -> bool {
+  auto *left = Peek(&left_);
+  if (left == nullptr) {
+    has_left_ = false;
+    return false;
+  }
+  left_tuple_ = std::move(*left);
+  Advance(&left_);
+  left_key_ = plan_->LeftJoinKeyExpression().Evaluate(&left_tuple_, left_.child_->GetOutputSchema());
+  has_left_ = true;
+  matched_ = false;
+  run_cursor_ = 0;
+  if (left_key_.IsNull()) {
+    return true;
+  }
+  // 左键和上一段相同就直接复用，否则右边先跳过更小的键（和 NULL），再收集等于左键的一段
+  if (!has_run_ || run_key_.CompareEquals(left_key_) != CmpBool::CmpTrue) {
+    run_.clear();
+    run_key_ = left_key_;
+    has_run_ = true;
+    for (auto *right = Peek(&right_); right != nullptr; right = Peek(&right_)) {
+      if (!right_.has_key_) {
+        right_.key_ = plan_->RightJoinKeyExpression().Evaluate(right, right_.child_->GetOutputSchema());
+        right_.has_key_ = true;
+      }
+      if (!right_.key_.IsNull() && right_.key_.CompareLessThan(left_key_) != CmpBool::CmpTrue) {
+        if (right_.key_.CompareEquals(left_key_) != CmpBool::CmpTrue) {
+          break;
+        }
+        run_.push_back(std::move(*right));
+      }
+      Advance(&right_);
+    }
+  }
+  matched_ = !run_.empty();
+  return true;
+}
+
+auto MergeJoinExecutor::MakeOutputTuple(const Tuple &left_tuple, const Tuple *right_tuple) const -> Tuple {
+  const auto &left_schema = left_.child_->GetOutputSchema();
+  const auto &right_schema = right_.child_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(GetOutputSchema().GetColumnCount());
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    values.push_back(left_tuple.GetValue(&left_schema, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    values.push_back(right_tuple != nullptr ? right_tuple->GetValue(&right_schema, i)
+                                            : ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+  }
+  return Tuple{std::move(values), &GetOutputSchema()};
+}
+
+auto MergeJoinExecutor::NextJoined(Tuple *tuple) -> bool {
+  while (true) {
+    if (has_left_ && matched_ && run_cursor_ < run_.size()) {
+      *tuple = MakeOutputTuple(left_tuple_, &run_[run_cursor_++]);
+      return true;
+    }
+    if (!AdvanceLeft()) {
+      return false;
+    }
+    if (!matched_ && plan_->GetJoinType() == JoinType::LEFT) {
+      *tuple = MakeOutputTuple(left_tuple_, nullptr);
+      return true;
+    }
+  }
+}
+
+auto MergeJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextJoined(tuple); }
+
+auto MergeJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset();
+  Tuple tuple;
+  while (!batch->IsFull() && NextJoined(&tuple)) {
+    batch->Append(std::move(tuple), RID{});
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
@@ -394,23 +394,48 @@ MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlan
 void MockScanExecutor::Init() {
   // Reset the cursor
   cursor_ = 0;
+  end_ = size_;
+  morsels_ = exec_ctx_->GetSharedState<MorselQueue>(plan_);
+  if (morsels_ != nullptr) {
+    // 并行扫描时从第一个领到的 morsel 开始
+    end_ = 0;
+  }
+}
+
+auto MockScanExecutor::HasNext() -> bool {
+  if (cursor_ == end_ && morsels_ != nullptr) {
+    morsels_->Next(&cursor_, &end_);
+  }
+  return cursor_ < end_;
+}
+
+auto MockScanExecutor::MakeTuple() const -> Tuple {
+  // 各 worker 的打乱顺序各不相同，并行扫描按 morsel 范围原序输出
+  if (shuffled_idx_.empty() || morsels_ != nullptr) {
+    return func_(cursor_);
+  }
+  return func_(shuffled_idx_[cursor_]);
 }
 
 auto MockScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (cursor_ == size_) {
+  if (!HasNext()) {
     // Scan complete
     return EXECUTOR_EXHAUSTED;
   }
-  if (shuffled_idx_.empty()) {
-    *tuple = func_(cursor_);
-  } else {
-    *tuple = func_(shuffled_idx_[cursor_]);
-  }
+  *tuple = MakeTuple();
   ++cursor_;
   *rid = MakeDummyRID();
   return EXECUTOR_ACTIVE;
 }
 
+auto MockScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset();
+  for (; !batch->IsFull() && HasNext(); ++cursor_) {
+    batch->Append(MakeTuple(), MakeDummyRID());
+  }
+  return !batch->IsEmpty();
+}
+
 auto MockScanExecutor::MakeDummyRID() -> RID { return RID{0}; }
 
 }  // namespace bustub
@@ -11,20 +11,101 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/nested_index_join_executor.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  inner_table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+  outer_batch_.Reset();
+  inner_rids_.clear();
+  outer_cursor_ = 0;
+  inner_cursor_ = 0;
+  matched_ = false;
+}
+
+auto NestIndexJoinExecutor::FetchBatch() -> bool {
+  outer_cursor_ = 0;
+  inner_cursor_ = 0;
+  matched_ = false;
+  if (!child_executor_->NextBatch(&outer_batch_)) {
+    return false;
+  }
+
+  // Probe the index once for the whole batch; null keys never match anything, so they are left out
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  auto *key_schema = index_info_->index_->GetKeySchema();
+  std::vector<Tuple> keys;
+  std::vector<size_t> probed;
+  for (size_t i = 0; i < outer_batch_.Size(); i++) {
+    auto key_value = plan_->KeyPredicate()->Evaluate(&outer_batch_.GetTuple(i), outer_schema);
+    if (!key_value.IsNull()) {
+      keys.emplace_back(std::vector<Value>{key_value}, key_schema);
+      probed.push_back(i);
+    }
+  }
+  std::vector<std::vector<RID>> probe_results;
+  index_info_->index_->ScanKeys(keys, &probe_results, exec_ctx_->GetTransaction());
+  inner_rids_.assign(outer_batch_.Size(), {});
+  for (size_t i = 0; i < probed.size(); i++) {
+    inner_rids_[probed[i]] = std::move(probe_results[i]);
+  }
+  return true;
+}
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto NestIndexJoinExecutor::MakeOutputTuple(const Tuple &outer_tuple, const Tuple *inner_tuple) const -> Tuple {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  std::vector<Value> values;
+  values.reserve(GetOutputSchema().GetColumnCount());
+  for (uint32_t i = 0; i < outer_schema.GetColumnCount(); i++) {
+    values.push_back(outer_tuple.GetValue(&outer_schema, i));
+  }
+  for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+    values.push_back(inner_tuple != nullptr ? inner_tuple->GetValue(&inner_schema, i)
+                                            : ValueFactory::GetNullValueByType(inner_schema.GetColumn(i).GetType()));
+  }
+  return Tuple{values, &GetOutputSchema()};
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (outer_cursor_ == outer_batch_.Size() && !FetchBatch()) {
+      return false;
+    }
+    const auto &outer_tuple = outer_batch_.GetTuple(outer_cursor_);
+    const auto &rids = inner_rids_[outer_cursor_];
+    while (inner_cursor_ < rids.size()) {
+      Tuple inner_tuple;
+      if (inner_table_info_->table_->GetTuple(rids[inner_cursor_++], &inner_tuple, exec_ctx_->GetTransaction())) {
+        matched_ = true;
+        *tuple = MakeOutputTuple(outer_tuple, &inner_tuple);
+        return true;
+      }
+    }
+    // the current outer tuple is done
+    bool emit_null = !matched_ && plan_->GetJoinType() == JoinType::LEFT;
+    if (emit_null) {
+      *tuple = MakeOutputTuple(outer_tuple, nullptr);
+    }
+    outer_cursor_++;
+    inner_cursor_ = 0;
+    matched_ = false;
+    if (emit_null) {
+      return true;
+    }
+  }
+}
 
 }  // namespace bustub
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_pipeline.cpp
+//
+// Identification: src/execution/parallel_pipeline.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/parallel_pipeline.h"
+
+#include <memory>
+
+#include "execution/executor_factory.h"
+#include "execution/executors/hash_join_executor.h"
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/morsel_queue.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+
+namespace bustub {
+
+auto ParallelPipeline::IsPipeline(const AbstractPlanNode &plan) -> bool {
+  switch (plan.GetType()) {
+    case PlanType::SeqScan:
+    case PlanType::MockScan:
+      return true;
+    case PlanType::Filter:
+    case PlanType::Projection:
+      return IsPipeline(*plan.GetChildAt(0));
+    case PlanType::HashJoin:
+      // 只有探测侧（左孩子）是流式的，建表侧在 worker 启动前建好共享
+      return IsPipeline(*plan.GetChildAt(0));
+    default:
+      return false;
+  }
+}
+
+auto ParallelPipeline::CanRun(ExecutorContext *exec_ctx, const AbstractPlanNode &plan) -> bool {
+  return exec_ctx->GetWorkerPool() != nullptr && exec_ctx->GetParallelism() > 1 && IsPipeline(plan);
+}
+
+void ParallelPipeline::Publish(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan,
+                               std::vector<const AbstractPlanNode *> *published) {
+  switch (plan->GetType()) {
+    case PlanType::MockScan: {
+      const auto *mock_plan = dynamic_cast<const MockScanPlanNode *>(plan.get());
+      exec_ctx->SetSharedState(plan.get(), std::make_shared<MorselQueue>(GetSizeOf(mock_plan), MOCK_MORSEL_SIZE));
+      break;
+    }
+    case PlanType::SeqScan: {
+      const auto *scan_plan = dynamic_cast<const SeqScanPlanNode *>(plan.get());
+      auto num_pages = exec_ctx->GetCatalog()->GetTable(scan_plan->GetTableOid())->table_->GetNumPages();
+      exec_ctx->SetSharedState(plan.get(), std::make_shared<MorselQueue>(num_pages, TABLE_MORSEL_PAGES));
+      break;
+    }
+    case PlanType::HashJoin: {
+      const auto *join_plan = dynamic_cast<const HashJoinPlanNode *>(plan.get());
+      exec_ctx->SetSharedState(plan.get(), HashJoinExecutor::BuildHashTable(exec_ctx, join_plan));
+      Publish(exec_ctx, join_plan->GetLeftPlan(), published);
+      break;
+    }
+    default:
+      Publish(exec_ctx, plan->GetChildAt(0), published);
+      return;
+  }
+  published->push_back(plan.get());
+}
+
+void ParallelPipeline::Run(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan,
+                           const std::function<void(size_t, TupleBatch *)> &consume) {
+  std::vector<const AbstractPlanNode *> published;
+  auto withdraw = [&] {
+    for (const auto *node : published) {
+      exec_ctx->SetSharedState(node, nullptr);
+    }
+  };
+  try {
+    Publish(exec_ctx, plan, &published);
+    exec_ctx->GetWorkerPool()->Run(exec_ctx->GetParallelism(), [&](size_t worker_id) {
+      // 每个 worker 自己建一套执行器，扫描节点从共享的 morsel 队列领活
+      auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
+      executor->Init();
+      TupleBatch batch;
+      while (executor->NextBatch(&batch)) {
+        consume(worker_id, &batch);
+      }
+    });
+  } catch (...) {
+    withdraw();
+    throw;
+  }
+  withdraw();
+}
+
+}  // namespace bustub
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_sort.cpp
+//
+// Identification: src/execution/parallel_sort.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/parallel_sort.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void ParallelSort::Sort(ExecutorContext *exec_ctx, const SortKeyEncoder &encoder, const std::vector<char> &keys,
+                        const std::vector<Tuple> &tuples, std::vector<uint32_t> *order) {
+  size_t num_rows = tuples.size();
+  auto key_size = encoder.GetKeySize();
+  // 前缀不同直接按整数比，相同才去比完整的键
+  auto less = [&](const Entry &left, const Entry &right) {
+    if (left.prefix_ != right.prefix_) {
+      return left.prefix_ < right.prefix_;
+    }
+    return encoder.Compare(keys.data() + left.row_ * key_size, tuples[left.row_],
+                           keys.data() + right.row_ * key_size, tuples[right.row_]) < 0;
+  };
+  auto make_entry = [&](size_t row) {
+    return Entry{encoder.GetPrefix(keys.data() + row * key_size), static_cast<uint32_t>(row)};
+  };
+
+  auto *pool = exec_ctx->GetWorkerPool();
+  size_t num_workers = std::min(exec_ctx->GetParallelism(), num_rows / MIN_ROWS_PER_WORKER);
+  order->resize(num_rows);
+  if (pool == nullptr || num_workers <= 1) {
+    std::vector<Entry> entries;
+    entries.reserve(num_rows);
+    for (size_t row = 0; row < num_rows; row++) {
+      entries.push_back(make_entry(row));
+    }
+    std::stable_sort(entries.begin(), entries.end(), less);
+    for (size_t i = 0; i < num_rows; i++) {
+      (*order)[i] = entries[i].row_;
+    }
+    return;
+  }
+
+  // 每个 worker 负责输入中连续的一段，桶的顺序和段的顺序都不打乱，相同的键保持输入顺序
+  auto chunk_begin = [&](size_t worker) { return num_rows * worker / num_workers; };
+  std::vector<Entry> entries(num_rows);
+  pool->Run(num_workers, [&](size_t worker) {
+    for (size_t row = chunk_begin(worker); row < chunk_begin(worker + 1); row++) {
+      entries[row] = make_entry(row);
+    }
+  });
+
+  // 均匀取样排序，每 OVERSAMPLING 个样本取一个分隔点，等于分隔点的都落在它后面的桶
+  size_t num_samples = num_workers * OVERSAMPLING;
+  std::vector<Entry> samples;
+  samples.reserve(num_samples);
+  for (size_t i = 0; i < num_samples; i++) {
+    samples.push_back(entries[num_rows * i / num_samples]);
+  }
+  std::sort(samples.begin(), samples.end(), less);
+  std::vector<Entry> splitters;
+  for (size_t bucket = 1; bucket < num_workers; bucket++) {
+    splitters.push_back(samples[bucket * OVERSAMPLING]);
+  }
+
+  std::vector<uint32_t> buckets(num_rows);
+  std::vector<std::vector<size_t>> offsets(num_workers, std::vector<size_t>(num_workers, 0));
+  pool->Run(num_workers, [&](size_t worker) {
+    for (size_t row = chunk_begin(worker); row < chunk_begin(worker + 1); row++) {
+      auto bucket = std::upper_bound(splitters.begin(), splitters.end(), entries[row], less) - splitters.begin();
+      buckets[row] = static_cast<uint32_t>(bucket);
+      offsets[worker][bucket]++;
+    }
+  });
+  // 按桶、再按段做前缀和，得到每个 worker 在每个桶里写入的起点
+  std::vector<size_t> bucket_starts(num_workers + 1, 0);
+  size_t offset = 0;
+  for (size_t bucket = 0; bucket < num_workers; bucket++) {
+    bucket_starts[bucket] = offset;
+    for (size_t worker = 0; worker < num_workers; worker++) {
+      auto count = offsets[worker][bucket];
+      offsets[worker][bucket] = offset;
+      offset += count;
+    }
+  }
+  bucket_starts[num_workers] = offset;
+
+  std::vector<Entry> scattered(num_rows);
+  pool->Run(num_workers, [&](size_t worker) {
+    auto &cursors = offsets[worker];
+    for (size_t row = chunk_begin(worker); row < chunk_begin(worker + 1); row++) {
+      scattered[cursors[buckets[row]]++] = entries[row];
+    }
+  });
+  pool->Run(num_workers, [&](size_t bucket) {
+    auto begin = scattered.begin() + bucket_starts[bucket];
+    auto end = scattered.begin() + bucket_starts[bucket + 1];
+    std::stable_sort(begin, end, less);
+    for (auto iter = begin; iter != end; ++iter) {
+      (*order)[iter - scattered.begin()] = iter->row_;
+    }
+  });
+}
+
+}  // namespace bustub
@@ -33,4 +33,26 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset();
+  // 每行输出一行，子节点的批不能比输出的批大
+  if (child_batch_.GetCapacity() != batch->GetCapacity()) {
+    child_batch_ = TupleBatch(batch->GetCapacity());
+  }
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    return false;
+  }
+  const auto &child_schema = child_executor_->GetOutputSchema();
+  for (size_t i = 0; i < child_batch_.Size(); i++) {
+    std::vector<Value> values{};
+    values.reserve(GetOutputSchema().GetColumnCount());
+    for (const auto &expr : plan_->GetExpressions()) {
+      values.push_back(expr->Evaluate(&child_batch_.GetTuple(i), child_schema));
+    }
+    batch->Append(Tuple{std::move(values), &GetOutputSchema()}, child_batch_.GetRid(i));
+  }
+  return true;
+}
+
 }  // namespace bustub
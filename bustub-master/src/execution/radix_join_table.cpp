@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// radix_join_table.cpp
+//
+// Identification: src/execution/radix_join_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/radix_join_table.h"
+
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void RadixJoinTable::Insert(Tuple &&tuple, const Value &key) {
+  rows_.push_back(std::move(tuple));
+  keys_.push_back(key);
+  hashes_.push_back(HashOf(key));
+}
+
+void RadixJoinTable::Append(RadixJoinTable &&other) {
+  if (rows_.empty()) {
+    rows_ = std::move(other.rows_);
+    keys_ = std::move(other.keys_);
+    hashes_ = std::move(other.hashes_);
+    return;
+  }
+  rows_.insert(rows_.end(), std::make_move_iterator(other.rows_.begin()), std::make_move_iterator(other.rows_.end()));
+  keys_.insert(keys_.end(), std::make_move_iterator(other.keys_.begin()), std::make_move_iterator(other.keys_.end()));
+  hashes_.insert(hashes_.end(), other.hashes_.begin(), other.hashes_.end());
+}
+
+void RadixJoinTable::Build() {
+  size_t num_rows = rows_.size();
+  BUSTUB_ENSURE(num_rows < std::numeric_limits<uint32_t>::max(), "too many rows for a join hash table");
+  radix_bits_ = 0;
+  while ((num_rows >> radix_bits_) > PARTITION_ROWS && radix_bits_ < MAX_RADIX_BITS) {
+    radix_bits_++;
+  }
+  radix_mask_ = (static_cast<hash_t>(1) << radix_bits_) - 1;
+  size_t num_partitions = static_cast<size_t>(1) << radix_bits_;
+
+  // 第一遍数每个分区有多少行，前缀和得到各分区的起点
+  std::vector<size_t> starts(num_partitions + 1, 0);
+  for (auto hash : hashes_) {
+    starts[PartitionOf(hash) + 1]++;
+  }
+  for (size_t p = 0; p < num_partitions; p++) {
+    starts[p + 1] += starts[p];
+  }
+
+  // 第二遍把行散到各自分区的位置上，分区内保持插入顺序
+  if (num_partitions > 1) {
+    std::vector<size_t> cursors(starts.begin(), starts.end() - 1);
+    std::vector<uint32_t> order(num_rows);
+    for (size_t row = 0; row < num_rows; row++) {
+      order[cursors[PartitionOf(hashes_[row])]++] = static_cast<uint32_t>(row);
+    }
+    std::vector<Tuple> rows;
+    std::vector<Value> keys;
+    std::vector<hash_t> hashes;
+    rows.reserve(num_rows);
+    keys.reserve(num_rows);
+    hashes.reserve(num_rows);
+    for (auto row : order) {
+      rows.push_back(std::move(rows_[row]));
+      keys.push_back(std::move(keys_[row]));
+      hashes.push_back(hashes_[row]);
+    }
+    rows_ = std::move(rows);
+    keys_ = std::move(keys);
+    hashes_ = std::move(hashes);
+  }
+
+  // 每个分区一张开放寻址表，槽数是行数的两倍以上，线性探测
+  partitions_.clear();
+  size_t num_slots = 0;
+  for (size_t p = 0; p < num_partitions; p++) {
+    size_t capacity = 1;
+    while (capacity < 2 * (starts[p + 1] - starts[p])) {
+      capacity <<= 1;
+    }
+    partitions_.push_back(Partition{num_slots, capacity - 1});
+    num_slots += capacity;
+  }
+  slots_.assign(num_slots, Slot{0, 0});
+  next_.assign(num_rows, 0);
+  for (size_t p = 0; p < num_partitions; p++) {
+    const auto &partition = partitions_[p];
+    // 每个不同的键只占一个槽，重复键的行挂在链上；倒着插入到链头，链上就是插入顺序
+    for (size_t row = starts[p + 1]; row-- > starts[p];) {
+      auto tag = TagOf(hashes_[row]);
+      size_t pos = HomeOf(hashes_[row], partition);
+      while (true) {
+        auto &slot = slots_[partition.begin_ + pos];
+        if (slot.row_ == 0) {
+          slot = Slot{tag, static_cast<uint32_t>(row + 1)};
+          break;
+        }
+        if (slot.tag_ == tag && keys_[slot.row_ - 1].CompareEquals(keys_[row]) == CmpBool::CmpTrue) {
+          next_[row] = slot.row_;
+          slot.row_ = static_cast<uint32_t>(row + 1);
+          break;
+        }
+        pos = (pos + 1) & partition.mask_;
+      }
+    }
+  }
+}
+
+void RadixJoinTable::Find(const Value &key, hash_t hash, std::vector<uint32_t> *rows) const {
+  const auto &partition = partitions_[PartitionOf(hash)];
+  auto tag = TagOf(hash);
+  // 标签相同才去比较键，大部分冲突不用碰行数据；找到键的槽后只沿链走匹配的行
+  for (size_t pos = HomeOf(hash, partition);; pos = (pos + 1) & partition.mask_) {
+    const auto &slot = slots_[partition.begin_ + pos];
+    if (slot.row_ == 0) {
+      return;
+    }
+    if (slot.tag_ == tag && keys_[slot.row_ - 1].CompareEquals(key) == CmpBool::CmpTrue) {
+      for (auto row = slot.row_; row != 0; row = next_[row - 1]) {
+        rows->push_back(row - 1);
+      }
+      return;
+    }
+  }
+}
+
+}  // namespace bustub
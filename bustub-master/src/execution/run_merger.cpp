@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// run_merger.cpp
+//
+// Identification: src/execution/run_merger.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/run_merger.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace bustub {
+
+RunMerger::RunMerger(const SortKeyEncoder *encoder, std::vector<TmpTupleRun> runs) : encoder_(encoder) {
+  sources_.reserve(runs.size());
+  for (auto &run : runs) {
+    sources_.emplace_back(std::move(run));
+  }
+  exhausted_.resize(sources_.size());
+  for (size_t i = 0; i < sources_.size(); i++) {
+    exhausted_[i] = !Fill(&sources_[i]);
+  }
+  tree_.resize(std::max<size_t>(sources_.size(), 1));
+  if (!sources_.empty()) {
+    tree_[0] = Play(1);
+  }
+}
+
+auto RunMerger::Fill(Source *source) -> bool {
+  while (source->cursor_ == source->tuples_.size()) {
+    if (source->next_page_ == source->run_.GetNumPages()) {
+      source->tuples_.clear();
+      source->cursor_ = 0;
+      return false;
+    }
+    source->tuples_.clear();
+    source->cursor_ = 0;
+    source->run_.ReadPage(source->next_page_++, &source->tuples_);
+    auto key_size = encoder_->GetKeySize();
+    source->keys_.resize(source->tuples_.size() * key_size);
+    for (size_t i = 0; i < source->tuples_.size(); i++) {
+      encoder_->Encode(source->tuples_[i], source->keys_.data() + i * key_size);
+    }
+  }
+  return true;
+}
+
+auto RunMerger::Less(size_t left, size_t right) const -> bool {
+  if (exhausted_[left] || exhausted_[right]) {
+    return !exhausted_[left] && exhausted_[right];
+  }
+  const auto &l = sources_[left];
+  const auto &r = sources_[right];
+  auto key_size = encoder_->GetKeySize();
+  int result = encoder_->Compare(l.keys_.data() + l.cursor_ * key_size, l.tuples_[l.cursor_],
+                                 r.keys_.data() + r.cursor_ * key_size, r.tuples_[r.cursor_]);
+  // 键相同时排在前面的 run 先出，保证归并是稳定的
+  return result < 0 || (result == 0 && left < right);
+}
+
+auto RunMerger::Play(size_t node) -> size_t {
+  if (node >= sources_.size()) {
+    return node - sources_.size();
+  }
+  auto left = Play(2 * node);
+  auto right = Play(2 * node + 1);
+  if (Less(right, left)) {
+    tree_[node] = left;
+    return right;
+  }
+  tree_[node] = right;
+  return left;
+}
+
+auto RunMerger::Next(Tuple *tuple) -> bool {
+  if (sources_.empty()) {
+    return false;
+  }
+  auto winner = tree_[0];
+  if (exhausted_[winner]) {
+    return false;
+  }
+  auto &source = sources_[winner];
+  *tuple = std::move(source.tuples_[source.cursor_++]);
+  exhausted_[winner] = !Fill(&source);
+  // 只重赛胜者叶子到根路径上的比赛，每个节点上输的留下，赢的继续往上
+  for (size_t node = (winner + sources_.size()) / 2; node > 0; node /= 2) {
+    if (Less(tree_[node], winner)) {
+      std::swap(tree_[node], winner);
+    }
+  }
+  tree_[0] = winner;
+  return true;
+}
+
+}  // namespace bustub
@@ -1,23 +1,92 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() { throw NotImplementedException("SeqScanExecutor is not implemented"); }
-
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+#include <utility>
+
+#include "common/exception.h"
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void SeqScanExecutor::Init() {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  page_ids_ = table_info_->table_->GetPageIds();
+  runtime_filters_ = exec_ctx_->GetRuntimeFilters(plan_);
+  keep_ = nullptr;
+  if (plan_->filter_predicate_ != nullptr || !runtime_filters_.empty()) {
+    keep_ = [this](const Tuple &tuple) { return Matches(tuple); };
+  }
+  morsels_ = exec_ctx_->GetSharedState<MorselQueue>(plan_);
+  next_page_ = 0;
+  // 串行扫描就是一个覆盖全部页的范围，并行扫描从领到的第一个 morsel 开始
+  end_page_ = morsels_ == nullptr ? page_ids_.size() : 0;
+  page_tuples_.clear();
+  tuple_cursor_ = 0;
+}
+
+auto SeqScanExecutor::FillBuffer() -> bool {
+  while (tuple_cursor_ == page_tuples_.size()) {
+    if (next_page_ == end_page_ && (morsels_ == nullptr || !morsels_->Next(&next_page_, &end_page_))) {
+      return false;
+    }
+    page_tuples_.clear();
+    tuple_cursor_ = 0;
+    // 取不到页时不能当成空页跳过，否则查询会悄悄少返回行
+    if (!table_info_->table_->GetPageTuples(page_ids_[next_page_++], &page_tuples_, exec_ctx_->GetTransaction(),
+                                            keep_)) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame in the buffer pool to scan a table page");
+    }
+  }
+  return true;
+}
+
+auto SeqScanExecutor::Matches(const Tuple &tuple) const -> bool {
+  // 先查布隆过滤器，比谓词便宜；NULL 键在内连接里不会有匹配
+  for (const auto &runtime_filter : runtime_filters_) {
+    auto key = tuple.GetValue(&GetOutputSchema(), runtime_filter.column_idx_);
+    if (key.IsNull() || !runtime_filter.filter_->MayContain(HashUtil::HashValue(&key))) {
+      return false;
+    }
+  }
+  if (plan_->filter_predicate_ == nullptr) {
+    return true;
+  }
+  auto value = plan_->filter_predicate_->Evaluate(&tuple, GetOutputSchema());
+  return !value.IsNull() && value.GetAs<bool>();
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (!FillBuffer()) {
+    return false;
+  }
+  *tuple = std::move(page_tuples_[tuple_cursor_++]);
+  *rid = tuple->GetRid();
+  return true;
+}
+
+auto SeqScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  // 过滤在读页时已经做完，缓冲里的都是要输出的元组
+  batch->Reset();
+  while (!batch->IsFull() && FillBuffer()) {
+    auto &tuple = page_tuples_[tuple_cursor_++];
+    RID rid = tuple.GetRid();
+    batch->Append(std::move(tuple), rid);
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
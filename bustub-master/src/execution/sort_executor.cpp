@@ -1,13 +1,111 @@
 #include "execution/executors/sort_executor.h"
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
 namespace bustub {
 
 SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      encoder_(plan->GetOrderBy(), &child_executor_->GetOutputSchema()) {}
+
+void SortExecutor::Init() {
+  child_executor_->Init();
+  tuples_.clear();
+  keys_.clear();
+  order_.clear();
+  cursor_ = 0;
+  runs_.clear();
+  merger_.reset();
+
+  // 边读边编码排序键，超出内存预算就把已经缓存的排好序写成一个 run
+  auto key_size = encoder_.GetKeySize();
+  size_t num_bytes = 0;
+  TupleBatch batch;
+  while (child_executor_->NextBatch(&batch)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      auto &tuple = batch.GetTuple(i);
+      keys_.resize(keys_.size() + key_size);
+      encoder_.Encode(tuple, keys_.data() + keys_.size() - key_size);
+      num_bytes += tuple.GetLength();
+      tuples_.push_back(std::move(tuple));
+      if (Footprint(num_bytes) > exec_ctx_->GetMemoryBudget()) {
+        SpillBuffered();
+        num_bytes = 0;
+      }
+    }
+  }
+  if (runs_.empty()) {
+    SortBuffered();
+    return;
+  }
+
+  // 最后一段也写出去，然后每趟把相邻的 fan-in 个 run 归并成一个，保持 run 的先后顺序，排序才是稳定的
+  if (!tuples_.empty()) {
+    SpillBuffered();
+  }
+  auto fan_in = GetMergeFanIn();
+  while (runs_.size() > fan_in) {
+    std::vector<TmpTupleRun> merged_runs;
+    for (size_t begin = 0; begin < runs_.size(); begin += fan_in) {
+      auto end = std::min(begin + fan_in, runs_.size());
+      if (end - begin == 1) {
+        merged_runs.push_back(std::move(runs_[begin]));
+        continue;
+      }
+      RunMerger merger(&encoder_, std::vector<TmpTupleRun>(std::make_move_iterator(runs_.begin() + begin),
+                                                           std::make_move_iterator(runs_.begin() + end)));
+      TmpTupleRun merged(exec_ctx_->GetBufferPoolManager());
+      Tuple tuple;
+      while (merger.Next(&tuple)) {
+        merged.Append(tuple);
+      }
+      merged.Finish();
+      merged_runs.push_back(std::move(merged));
+    }
+    runs_ = std::move(merged_runs);
+  }
+  merger_ = std::make_unique<RunMerger>(&encoder_, std::move(runs_));
+  runs_.clear();
+}
+
+auto SortExecutor::GetMergeFanIn() const -> size_t {
+  return std::max<size_t>(exec_ctx_->GetMemoryBudget() / BUSTUB_PAGE_SIZE, 2);
+}
+
+void SortExecutor::SortBuffered() { ParallelSort::Sort(exec_ctx_, encoder_, keys_, tuples_, &order_); }
 
-void SortExecutor::Init() { throw NotImplementedException("SortExecutor is not implemented"); }
+void SortExecutor::SpillBuffered() {
+  SortBuffered();
+  TmpTupleRun run(exec_ctx_->GetBufferPoolManager());
+  for (auto row : order_) {
+    run.Append(tuples_[row]);
+  }
+  run.Finish();
+  runs_.push_back(std::move(run));
+  tuples_.clear();
+  keys_.clear();
+  order_.clear();
+}
 
-auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (merger_ != nullptr) {
+    if (!merger_->Next(tuple)) {
+      return false;
+    }
+    *rid = tuple->GetRid();
+    return true;
+  }
+  if (cursor_ == order_.size()) {
+    return false;
+  }
+  *tuple = std::move(tuples_[order_[cursor_++]]);
+  *rid = tuple->GetRid();
+  return true;
+}
 
 }  // namespace bustub
@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.cpp
+//
+// Identification: src/execution/sort_key.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/sort_key.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+namespace {
+
+/** Write the low `width` bytes of `bits` to `out`, most significant first */
+void StoreBigEndian(uint64_t bits, size_t width, char *out) {
+  for (size_t i = 0; i < width; i++) {
+    out[width - 1 - i] = static_cast<char>(bits & 0xFF);
+    bits >>= 8;
+  }
+}
+
+}  // namespace
+
+SortKeyEncoder::SortKeyEncoder(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys,
+                               const Schema *schema)
+    : schema_(schema) {
+  first_inexact_ = order_bys.size();
+  for (const auto &[order_by_type, expr] : order_bys) {
+    auto type = expr->GetReturnType();
+    auto width = WidthOf(type);
+    if (first_inexact_ == order_bys.size() && (type == TypeId::VARCHAR || width == 0)) {
+      first_inexact_ = columns_.size();
+      compared_size_ = key_size_ + 1 + width;
+    }
+    columns_.push_back(KeyColumn{expr, type, order_by_type == OrderByType::DESC, key_size_, width});
+    key_size_ += 1 + width;
+  }
+  if (first_inexact_ == columns_.size()) {
+    compared_size_ = key_size_;
+  }
+  prefix_size_ = std::min(compared_size_, sizeof(uint64_t));
+}
+
+auto SortKeyEncoder::WidthOf(TypeId type) -> size_t {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return 1;
+    case TypeId::SMALLINT:
+      return 2;
+    case TypeId::INTEGER:
+      return 4;
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+    case TypeId::TIMESTAMP:
+      return 8;
+    case TypeId::VARCHAR:
+      return VARCHAR_PREFIX_SIZE;
+    default:
+      return 0;
+  }
+}
+
+void SortKeyEncoder::Encode(const Tuple &tuple, char *key) const {
+  for (const auto &column : columns_) {
+    char *out = key + column.offset_;
+    auto value = column.expr_->Evaluate(&tuple, *schema_);
+    memset(out, 0, 1 + column.width_);
+    if (!value.IsNull() && column.width_ > 0) {
+      if (value.GetTypeId() != column.type_) {
+        value = value.CastAs(column.type_);
+      }
+      out[0] = 1;
+      // 有符号整数翻转符号位，浮点数负数全部取反、非负数翻转符号位，之后按无符号大端比较就是数值顺序
+      switch (column.type_) {
+        case TypeId::BOOLEAN:
+          out[1] = static_cast<char>(value.GetAs<int8_t>());
+          break;
+        case TypeId::TINYINT:
+          StoreBigEndian(static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80U, 1, out + 1);
+          break;
+        case TypeId::SMALLINT:
+          StoreBigEndian(static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000U, 2, out + 1);
+          break;
+        case TypeId::INTEGER:
+          StoreBigEndian(static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, 4, out + 1);
+          break;
+        case TypeId::BIGINT:
+          StoreBigEndian(static_cast<uint64_t>(value.GetAs<int64_t>()) ^ (1ULL << 63), 8, out + 1);
+          break;
+        case TypeId::DECIMAL: {
+          // -0.0 和 0.0 相等，编码也要相同
+          double number = value.GetAs<double>() == 0 ? 0.0 : value.GetAs<double>();
+          uint64_t bits;
+          memcpy(&bits, &number, sizeof(bits));
+          StoreBigEndian((bits >> 63) != 0 ? ~bits : bits ^ (1ULL << 63), 8, out + 1);
+          break;
+        }
+        case TypeId::TIMESTAMP:
+          StoreBigEndian(value.GetAs<uint64_t>(), 8, out + 1);
+          break;
+        case TypeId::VARCHAR:
+          // 长度包括结尾的 '\0'，不足前缀长度的补零
+          memcpy(out + 1, value.GetData(), std::min<size_t>(value.GetLength() - 1, VARCHAR_PREFIX_SIZE));
+          break;
+        default:
+          break;
+      }
+    } else if (!value.IsNull()) {
+      out[0] = 1;
+    }
+    if (column.descending_) {
+      for (size_t i = 0; i <= column.width_; i++) {
+        out[i] = static_cast<char>(~out[i]);
+      }
+    }
+  }
+}
+
+auto SortKeyEncoder::CompareValues(const Tuple &left, const Tuple &right) const -> int {
+  for (size_t i = first_inexact_; i < columns_.size(); i++) {
+    const auto &column = columns_[i];
+    auto left_value = column.expr_->Evaluate(&left, *schema_);
+    auto right_value = column.expr_->Evaluate(&right, *schema_);
+    int result = 0;
+    if (left_value.IsNull() || right_value.IsNull()) {
+      result = static_cast<int>(right_value.IsNull()) - static_cast<int>(left_value.IsNull());
+    } else if (left_value.CompareLessThan(right_value) == CmpBool::CmpTrue) {
+      result = -1;
+    } else if (left_value.CompareGreaterThan(right_value) == CmpBool::CmpTrue) {
+      result = 1;
+    }
+    if (result != 0) {
+      return column.descending_ ? -result : result;
+    }
+  }
+  return 0;
+}
+
+}  // namespace bustub
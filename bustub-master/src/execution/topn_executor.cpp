@@ -1,13 +1,77 @@
 #include "execution/executors/topn_executor.h"
 
+#include <algorithm>
+#include <utility>
+
 namespace bustub {
 
 TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      encoder_(plan->GetOrderBy(), &child_executor_->GetOutputSchema()) {}
+
+void TopNExecutor::Init() {
+  child_executor_->Init();
+  tuples_.clear();
+  keys_.clear();
+  order_.clear();
+  bounded_ = false;
+  cursor_ = 0;
+
+  auto n = plan_->GetN();
+  if (n == 0) {
+    return;
+  }
+  auto key_size = encoder_.GetKeySize();
+  auto compact_rows = std::max(2 * n, COMPACT_MIN_ROWS);
+  std::vector<char> key(key_size);
+  TupleBatch batch;
+  while (child_executor_->NextBatch(&batch)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      auto &tuple = batch.GetTuple(i);
+      encoder_.Encode(tuple, key.data());
+      // 不排在第 N 个之前的元组不可能进前 N，键相同的也是先来的优先
+      if (bounded_ && encoder_.Compare(key.data(), tuple, keys_.data() + (n - 1) * key_size, tuples_[n - 1]) >= 0) {
+        continue;
+      }
+      keys_.insert(keys_.end(), key.begin(), key.end());
+      tuples_.push_back(std::move(tuple));
+      if (tuples_.size() >= compact_rows) {
+        Compact();
+      }
+    }
+  }
+  Compact();
+}
 
-void TopNExecutor::Init() { throw NotImplementedException("TopNExecutor is not implemented"); }
+void TopNExecutor::Compact() {
+  ParallelSort::Sort(exec_ctx_, encoder_, keys_, tuples_, &order_);
+  auto n = std::min(plan_->GetN(), tuples_.size());
+  auto key_size = encoder_.GetKeySize();
+  std::vector<Tuple> tuples;
+  std::vector<char> keys;
+  tuples.reserve(n);
+  keys.reserve(n * key_size);
+  for (size_t i = 0; i < n; i++) {
+    auto row = order_[i];
+    tuples.push_back(std::move(tuples_[row]));
+    keys.insert(keys.end(), keys_.begin() + row * key_size, keys_.begin() + (row + 1) * key_size);
+  }
+  tuples_ = std::move(tuples);
+  keys_ = std::move(keys);
+  order_.clear();
+  bounded_ = tuples_.size() == plan_->GetN();
+}
 
-auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (cursor_ == tuples_.size()) {
+    return false;
+  }
+  *tuple = std::move(tuples_[cursor_++]);
+  *rid = tuple->GetRid();
+  return true;
+}
 
 }  // namespace bustub
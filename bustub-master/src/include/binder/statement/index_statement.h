@@ -21,7 +21,9 @@ namespace bustub {
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundColumnRef>> cols, bool is_unique,
+                          std::vector<std::unique_ptr<BoundColumnRef>> include_cols = {},
+                          size_t bloom_filter_bits_per_key = 0, std::string index_type = "btree");
 
   /** Name of the index */
   std::string index_name_;
@@ -32,6 +34,18 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** CREATE UNIQUE INDEX, otherwise several rows may share a key */
+  bool is_unique_;
+
+  /** Columns stored in the index besides the key, so that scans reading only them can skip the table */
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols_;
+
+  /** Bits per key of the index's bloom filter, 0 for none */
+  size_t bloom_filter_bits_per_key_;
+
+  /** `CREATE INDEX ... USING <index_type>`, "btree" or "hash" */
+  std::string index_type_;
+
   auto ToString() const -> std::string override;
 };
 
@@ -35,6 +35,9 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/** The data structures an index can be built on */
+enum class IndexType { BPlusTreeIndex, HashTableIndex };
+
 /**
  * The TableInfo class maintains metadata about a table.
  */
@@ -70,15 +73,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The data structure of the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +96,8 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The data structure of the index; only B+ tree indexes keep their keys in order */
+  const IndexType index_type_;
 };
 
 /**
@@ -196,12 +203,18 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param is_unique Whether the index holds at most one entry per key
+   * @param include_attrs Columns stored in the index entries besides the key, for index-only scans
+   * @param bloom_filter_bits_per_key Size of the in-memory bloom filter over the keys, 0 for none
+   * @param index_type The data structure of the index; include_attrs and the bloom filter need a B+ tree
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, bool is_unique = true,
+                   const std::vector<uint32_t> &include_attrs = {}, size_t bloom_filter_bits_per_key = 0,
+                   IndexType index_type = IndexType::BPlusTreeIndex) -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -218,29 +231,42 @@ class Catalog {
     }
 
     // Construct index metdata
-    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, is_unique, include_attrs);
 
     // Construct the index, take ownership of metadata
     // TODO(Kyle): We should update the API for CreateIndex
     // to allow specification of the index type itself, not
     // just the key, value, and comparator types
 
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::HashTableIndex) {
+      BUSTUB_ASSERT(include_attrs.empty() && bloom_filter_bits_per_key == 0, "hash indexes store keys only");
+      index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                            hash_function);
+    } else {
+      auto btree_index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+      if (bloom_filter_bits_per_key > 0) {
+        btree_index->EnableBloomFilter(bloom_filter_bits_per_key);
+      }
+      index = std::move(btree_index);
+    }
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap, as one batch
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
+    std::vector<std::pair<Tuple, RID>> entries;
     for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+      entries.emplace_back(tuple->KeyFromTuple(schema, *index->GetEntrySchema(), index->GetEntryAttrs()),
+                           tuple->GetRid());
     }
+    index->InsertEntries(entries, txn);
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
@@ -298,7 +324,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
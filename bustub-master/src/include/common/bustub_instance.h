@@ -40,6 +40,7 @@ class LogManager;
 class CheckpointManager;
 class Catalog;
 class ExecutionEngine;
+class WorkerPool;
 
 class ResultWriter {
  public:
@@ -250,6 +251,8 @@ class BustubInstance {
   CheckpointManager *checkpoint_manager_;
   Catalog *catalog_;
   ExecutionEngine *execution_engine_;
+  /** The threads shared by the parallel pipelines of all queries */
+  WorkerPool *worker_pool_;
   std::shared_mutex catalog_lock_;
 
   auto GetSessionVariable(const std::string &key) -> std::string {
@@ -264,11 +267,25 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /**
+   * @return the number of workers a parallel pipeline is split across, set by `SET execution_parallelism = n`.
+   * Queries run serially (1) unless it is set, as parallel pipelines do not keep the order of their input.
+   */
+  auto GetParallelism() -> size_t;
+
+  /**
+   * @return the bytes an executor may hold in memory before spilling to disk, set by
+   * `SET execution_memory_budget = n`, EXECUTION_MEMORY_BUDGET unless it is set
+   */
+  auto GetMemoryBudget() -> size_t;
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
+  /** @return the session variable as a positive integer, `default_value` if it is not set to one */
+  auto GetSizeVariable(const std::string &key, size_t default_value) -> size_t;
   std::unordered_map<std::string, std::string> session_variables_;
 };
 
@@ -46,4 +46,6 @@ using oid_t = uint16_t;
 
 static constexpr int VARCHAR_DEFAULT_LENGTH = 128;  // default length for varchar when constructing the column
 
+static constexpr size_t EXECUTION_MEMORY_BUDGET = 64 << 20;  // bytes an executor may hold before spilling to disk
+
 }  // namespace bustub
@@ -13,9 +13,16 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
 
 #include "common/macros.h"
 #include "type/value.h"
@@ -24,39 +31,149 @@ namespace bustub {
 
 using hash_t = std::size_t;
 
+/** The byte hash functions HashUtil offers. */
+enum class HashFamily {
+  /** wyhash-style: 64-bit multiply-fold over 8/16/48-byte strides, the default */
+  WyHash,
+  /** CRC32C via SSE4.2 when the CPU has it (WyHash otherwise), finished with the integer mixer */
+  Crc32c,
+};
+
 class HashUtil {
  private:
   static const hash_t PRIME_FACTOR = 10000019;
 
+  // wyhash secrets
+  static constexpr uint64_t WY_P0 = 0xa0761d6478bd642fULL;
+  static constexpr uint64_t WY_P1 = 0xe7037ed1a0b428dbULL;
+  static constexpr uint64_t WY_P2 = 0x8ebc6af09c88c6e3ULL;
+  static constexpr uint64_t WY_P3 = 0x589965cc75374cc3ULL;
+
+  /** Multiply into 128 bits and fold the halves together */
+  static inline auto Mum(uint64_t a, uint64_t b) -> uint64_t {
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+  }
+
+  static inline auto Read64(const uint8_t *p) -> uint64_t {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  static inline auto Read32(const uint8_t *p) -> uint64_t {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  static inline auto WyHashBytes(const char *bytes, size_t length) -> hash_t {
+    const auto *p = reinterpret_cast<const uint8_t *>(bytes);
+    uint64_t seed = WY_P0;
+    uint64_t a;
+    uint64_t b;
+    if (length <= 16) {
+      if (length >= 4) {
+        // 两次重叠的4字节读覆盖4~16字节
+        const size_t shift = (length >> 3) << 2;
+        a = (Read32(p) << 32) | Read32(p + shift);
+        b = (Read32(p + length - 4) << 32) | Read32(p + length - 4 - shift);
+      } else if (length > 0) {
+        a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+        b = 0;
+      } else {
+        a = b = 0;
+      }
+    } else {
+      size_t i = length;
+      if (i > 48) {
+        // 三条独立的乘法链，CPU可以并行执行
+        uint64_t see1 = seed;
+        uint64_t see2 = seed;
+        do {
+          seed = Mum(Read64(p) ^ WY_P1, Read64(p + 8) ^ seed);
+          see1 = Mum(Read64(p + 16) ^ WY_P2, Read64(p + 24) ^ see1);
+          see2 = Mum(Read64(p + 32) ^ WY_P3, Read64(p + 40) ^ see2);
+          p += 48;
+          i -= 48;
+        } while (i > 48);
+        seed ^= see1 ^ see2;
+      }
+      while (i > 16) {
+        seed = Mum(Read64(p) ^ WY_P1, Read64(p + 8) ^ seed);
+        p += 16;
+        i -= 16;
+      }
+      a = Read64(p + i - 16);
+      b = Read64(p + i - 8);
+    }
+    return Mum(WY_P1 ^ length, Mum(a ^ WY_P1, b ^ seed));
+  }
+
+#if defined(__x86_64__)
+  __attribute__((target("sse4.2"))) static inline auto Crc32cBytes(const char *bytes, size_t length) -> hash_t {
+    const auto *p = reinterpret_cast<const uint8_t *>(bytes);
+    uint64_t crc = ~0ULL;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+      crc = _mm_crc32_u64(crc, Read64(p + i));
+    }
+    for (; i < length; i++) {
+      crc = _mm_crc32_u8(static_cast<uint32_t>(crc), p[i]);
+    }
+    // CRC只有32位，高位靠长度和整数混合补上
+    return MixInt((crc << 32) ^ length);
+  }
+
+  static inline auto HasCrc32c() -> bool {
+    static const bool has_crc32c = __builtin_cpu_supports("sse4.2");
+    return has_crc32c;
+  }
+#endif
+
  public:
+  /** Hash `length` bytes with the given family. */
+  template <HashFamily family = HashFamily::WyHash>
   static inline auto HashBytes(const char *bytes, size_t length) -> hash_t {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+#if defined(__x86_64__)
+    if constexpr (family == HashFamily::Crc32c) {
+      if (HasCrc32c()) {
+        return Crc32cBytes(bytes, length);
+      }
     }
-    return hash;
+#endif
+    return WyHashBytes(bytes, length);
   }
 
-  static inline auto CombineHashes(hash_t l, hash_t r) -> hash_t {
-    hash_t both[2] = {};
-    both[0] = l;
-    both[1] = r;
-    return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
+  /** Mix all bits of an integer into all bits of its hash, so that masking off low bits is safe. */
+  static inline auto MixInt(uint64_t value) -> hash_t {
+    // MurmurHash3的fmix64：两轮xorshift-乘法，连续和等间隔的整数也能打散到低位
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
   }
 
+  static inline auto CombineHashes(hash_t l, hash_t r) -> hash_t { return MixInt(MixInt(l) + r); }
+
   static inline auto SumHashes(hash_t l, hash_t r) -> hash_t {
     return (l % PRIME_FACTOR + r % PRIME_FACTOR) % PRIME_FACTOR;
   }
 
   template <typename T>
   static inline auto Hash(const T *ptr) -> hash_t {
-    return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t)) {
+      return MixInt(static_cast<uint64_t>(*ptr));
+    } else {
+      return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    }
   }
 
   template <typename T>
   static inline auto HashPtr(const T *ptr) -> hash_t {
-    return HashBytes(reinterpret_cast<const char *>(&ptr), sizeof(void *));
+    return MixInt(reinterpret_cast<uintptr_t>(ptr));
   }
 
   /** @return the hash of the value */
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool.h
+//
+// Identification: src/include/common/worker_pool.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * A fixed set of threads shared by all queries of a BustubInstance.
+ *
+ * Work is handed to the pool with Run(), which fans one task out to several workers and returns once all of them
+ * are done. The calling thread takes part as worker 0, and while it waits for the others it runs queued tasks
+ * itself, so a task may call Run() again (e.g. a pipeline that builds a hash table in parallel) without the pool
+ * running out of threads.
+ */
+class WorkerPool {
+ public:
+  /** @param num_threads the number of threads in the pool, not counting the threads that call Run() */
+  explicit WorkerPool(size_t num_threads);
+
+  ~WorkerPool();
+
+  DISALLOW_COPY_AND_MOVE(WorkerPool);
+
+  /** @return the number of threads in the pool */
+  auto GetNumThreads() const -> size_t { return threads_.size(); }
+
+  /**
+   * Run `task(worker_id)` for every worker_id in [0, num_workers) and wait for all of them.
+   * If a task throws, the first exception is rethrown here after every task has finished.
+   */
+  void Run(size_t num_workers, const std::function<void(size_t)> &task);
+
+ private:
+  /** The tasks of one Run() call */
+  struct Job;
+
+  void WorkerLoop();
+
+  /** Run one queued task if there is any. `lock` holds latch_ and is released while the task runs. */
+  auto RunQueued(std::unique_lock<std::mutex> *lock) -> bool;
+
+  std::vector<std::thread> threads_;
+  std::mutex latch_;
+  /** Signalled when a task is queued, a task finishes, or the pool shuts down */
+  std::condition_variable cv_;
+  /** Queued tasks: the job they belong to and the worker id to run */
+  std::deque<std::pair<Job *, size_t>> queue_;
+  bool shutdown_{false};
+};
+
+}  // namespace bustub
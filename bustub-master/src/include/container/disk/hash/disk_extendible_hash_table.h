@@ -30,6 +30,10 @@ namespace bustub {
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * Lookups, inserts and removes hold the table latch in read mode plus the latch of the one bucket page they touch,
+ * so operations on different buckets run in parallel. Splits and merges change the directory and hold the table
+ * latch in write mode. The directory lives in a single page, which bounds it to DIRECTORY_ARRAY_SIZE entries.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -50,9 +54,10 @@ class DiskExtendibleHashTable {
    * @param transaction the current transaction
    * @param key the key to create
    * @param value the value to be associated with the key
+   * @param unique if true, fail when the key is already present, checked atomically with the insert
    * @return true if insert succeeded, false otherwise
    */
-  auto Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
+  auto Insert(Transaction *transaction, const KeyType &key, const ValueType &value, bool unique = false) -> bool;
 
   /**
    * Deletes the associated value for the given key.
@@ -142,25 +147,33 @@ class DiskExtendibleHashTable {
    * @param transaction a pointer to the current transaction
    * @param key the key to insert
    * @param value the value to insert
+   * @param unique whether to fail when the key is already present
    * @return whether or not the insertion was successful
    */
-  auto SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
+  auto SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value, bool unique) -> bool;
 
   /**
    * Optionally merges an empty bucket into it's pair.  This is called by Remove,
    * if Remove makes a bucket empty.
    *
    * There are three conditions under which we skip the merge:
-   * 1. The bucket is no longer empty.
+   * 1. Neither the bucket nor its split image is empty (any longer).
    * 2. The bucket has local depth 0.
    * 3. The bucket's local depth doesn't match its split image's local depth.
    *
+   * After a merge the merged bucket is checked against its own split image in turn.
+   *
    * @param transaction a pointer to the current transaction
    * @param key the key that was removed
    * @param value the value that was removed
    */
   void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
 
+  /**
+   * @return whether the bucket page holds no key/value pair. Only called with the table latch held in write mode.
+   */
+  auto IsBucketEmpty(page_id_t bucket_page_id) -> bool;
+
   // member variables
   page_id_t directory_page_id_;
   BufferPoolManager *buffer_pool_manager_;
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
 #include "storage/page/hash_table_block_page.h"
@@ -26,10 +27,34 @@ namespace bustub {
 
 #define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
 
+/** Probe length statistics of a LinearProbeHashTable, over the entries of its current table. */
+struct LinearProbeStats {
+  /** Entries in the current table */
+  size_t num_entries_{0};
+  /** Sum over those entries of the distance between their slot and the slot their key hashes to */
+  size_t total_distance_{0};
+  /** The longest distance any entry was placed at since the current table was created */
+  size_t max_distance_{0};
+};
+
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Entries are placed Robin Hood style: an insert that has probed further than the entry in a slot takes the slot and
+ * carries that entry on instead, so distances from the home slot stay short and even, and a lookup stops as soon as
+ * it meets an entry closer to home than itself. A remove shifts the following entries of the cluster back by one
+ * slot (across block pages) instead of leaving a tombstone, so probe lengths do not grow under insert/remove churn.
+ *
+ * Growing is incremental. A resize only allocates the block pages of a table twice the size and makes it the
+ * current one; the old table stays around until every slot has been moved over. Each insert and remove moves the
+ * next RESIZE_STEP_SLOTS slots of the old table, and lookups and removes check both tables in the meantime. No
+ * single operation ever rehashes the whole table. The old table is never shifted: moved and removed entries only
+ * leave tombstones in it, so the entries not moved yet stay reachable.
+ *
+ * Lookups hold the table latch in read mode. Inserts and removes move entries between slots and hold it in write
+ * mode.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable {
@@ -73,11 +98,22 @@ class LinearProbeHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Resizes the table to at least twice the initial size provided. The new table is allocated right away, the
+   * entries move over incrementally (see the class comment).
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
 
+  /**
+   * @return whether entries of a previous, smaller table are still being moved over
+   */
+  auto IsResizing() -> bool;
+
+  /**
+   * @return probe length statistics of the current table
+   */
+  auto GetProbeStats() -> LinearProbeStats;
+
   /**
    * Gets the size of the hash table
    * @return current size of the hash table
@@ -85,21 +121,106 @@ class LinearProbeHashTable {
   auto GetSize() -> size_t;
 
  private:
-  auto GetHeaderPage() -> HashTableHeaderPage *;
+  /** Slots of the old table moved over by each insert or remove during a resize */
+  static constexpr size_t RESIZE_STEP_SLOTS = 64;
+  /** A resize starts once more than 3/4 of the slots hold entries */
+  static constexpr size_t MAX_LOAD_NUMERATOR = 3;
+  static constexpr size_t MAX_LOAD_DENOMINATOR = 4;
+
+  /** Keeps the block page of the slot visited last pinned while walking a table slot by slot. */
+  class SlotCursor {
+   public:
+    SlotCursor(BufferPoolManager *buffer_pool_manager, HashTableHeaderPage *header_page, bool dirty)
+        : buffer_pool_manager_(buffer_pool_manager), header_page_(header_page), dirty_(dirty) {}
+    ~SlotCursor() {
+      if (block_page_ != nullptr) {
+        buffer_pool_manager_->UnpinPage(block_page_id_, dirty_);
+      }
+    }
+    DISALLOW_COPY_AND_MOVE(SlotCursor);
+
+    /** @return the block page holding `slot`, the slot's offset in it is slot % BLOCK_ARRAY_SIZE */
+    auto Seek(size_t slot) -> HASH_TABLE_BLOCK_TYPE * {
+      page_id_t block_page_id = header_page_->GetBlockPageId(slot / BLOCK_ARRAY_SIZE);
+      if (block_page_id != block_page_id_) {
+        if (block_page_ != nullptr) {
+          buffer_pool_manager_->UnpinPage(block_page_id_, dirty_);
+        }
+        block_page_id_ = block_page_id;
+        block_page_ =
+            reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(buffer_pool_manager_->FetchPage(block_page_id)->GetData());
+      }
+      return block_page_;
+    }
+
+   private:
+    BufferPoolManager *buffer_pool_manager_;
+    HashTableHeaderPage *header_page_;
+    bool dirty_;
+    page_id_t block_page_id_{INVALID_PAGE_ID};
+    HASH_TABLE_BLOCK_TYPE *block_page_{nullptr};
+  };
+
+  auto GetHeaderPage(page_id_t header_page_id) -> HashTableHeaderPage *;
   auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
-  void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
+
+  /** @return the slot `key` hashes to in a table of `size` slots */
+  auto Home(const KeyType &key, size_t size) -> size_t;
+  /** @return how far the entry in slot `slot` of a table of `size` slots sits from its home slot */
+  auto Distance(HASH_TABLE_BLOCK_TYPE *block_page, size_t slot, size_t size) -> size_t;
+
+  /**
+   * Walk the probe sequence of `key` in one table, calling `visit(block_page, offset, slot)` on each occupied slot
+   * that may hold the key. The walk ends when `visit` returns true, at the first unoccupied slot, or at the first
+   * entry closer to its home slot than `key` would be.
+   * @param dirty whether `visit` may modify the block pages
+   * @return true if `visit` ended the walk
+   */
+  template <typename Visitor>
+  auto Probe(HashTableHeaderPage *header_page, const KeyType &key, bool dirty, Visitor &&visit) -> bool;
+
+  /**
+   * Insert into the current table without looking for duplicates, displacing entries Robin Hood style. Needs the
+   * table latch in write mode.
+   * @return false if the table is full
+   */
+  auto RobinHoodInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value) -> bool;
+  /** Remove the entry in `slot` of the current table by shifting the rest of its cluster back. */
+  void ShiftBackward(HashTableHeaderPage *header_page, size_t slot);
   void DeleteBlockPages(HashTableHeaderPage *old_header_page);
   void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
-  auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  /**
+   * Make a table of at least `size` slots the current one, after finishing any resize still in progress. Needs the
+   * table latch in write mode.
+   * @return false if the header page cannot hold the block pages of a larger table
+   */
+  auto StartResize(size_t size) -> bool;
+  /** Move the next `num_slots` slots of the old table over. Needs the table latch in write mode. */
+  void MoveSlots(size_t num_slots);
+  /**
+   * Move a step of slots if a resize is in progress, and start one if the current table is too full. Needs the
+   * table latch in write mode.
+   */
+  void MaintainResize();
+  /** @return the number of slots of the current table. Needs the table latch. */
+  auto GetSizeLatchFree() -> size_t;
 
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Readers are lookups, writers are inserts and removes (which also move slots and start resizes)
   ReaderWriterLatch table_latch_;
 
+  // The table being moved into header_page_id_'s, INVALID_PAGE_ID when no resize is in progress
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  // The first slot of the old table that has not been moved yet
+  size_t next_move_slot_{0};
+  // Entries and probe distances of the current table
+  LinearProbeStats stats_;
+
   // Hash function
   HashFunction<KeyType> hash_fn_;
 };
@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_table.h
+//
+// Identification: src/include/execution/aggregation_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/util/hash_util.h"
+#include "execution/plans/aggregation_plan.h"
+#include "storage/table/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * How the groups of an aggregation are keyed and how its aggregates are accumulated, shared by all the
+ * AggregationTables of one aggregation.
+ *
+ * A group key is the group-by values serialized back to back, fixed-size values in their type's size and VARCHARs
+ * with their length, and NULLs as the NULL value of their type, so that equal keys have equal bytes.
+ */
+class AggregationLayout {
+ public:
+  /**
+   * @param plan the aggregation
+   * @param input_schema the schema of the tuples being aggregated
+   */
+  AggregationLayout(const AggregationPlanNode *plan, const Schema *input_schema);
+
+  /**
+   * Serialize the group key of a tuple.
+   * @param[out] key the key, replacing its contents
+   * @return the hash of the key
+   */
+  auto EncodeKey(const Tuple &tuple, std::vector<char> *key) const -> hash_t;
+
+  /** @return the hash of a group key */
+  static auto HashKey(const char *key, size_t key_size) -> hash_t { return HashUtil::HashBytes(key, key_size); }
+
+ private:
+  friend class AggregationTable;
+
+  /** How an aggregate keeps its running value: a count, an int64_t, a double, or a Value for any other type */
+  enum class Accumulator : uint8_t { COUNT, INTEGER, DECIMAL, VALUE };
+
+  const AggregationPlanNode *plan_;
+  const Schema *input_schema_;
+  std::vector<TypeId> key_types_;
+  std::vector<Accumulator> accumulators_;
+  /** The input type of each aggregate, and for VALUE aggregates their slot among the Values of a group */
+  std::vector<TypeId> input_types_;
+  std::vector<uint32_t> value_slots_;
+  size_t num_values_{0};
+};
+
+/**
+ * An open-addressing hash table from group keys to running aggregates, for one partition of an aggregation.
+ *
+ * A group is a row of flat arrays instead of a std::vector<Value> of its own: its key bytes in a shared arena, and
+ * one 8-byte accumulator per aggregate holding a count, an int64_t or a double, with a flag per accumulator that is
+ * set once it is not NULL. Only aggregates over other types, e.g. MIN of a TIMESTAMP, keep a Value. The slots are
+ * 8 bytes, a hash tag and a group number, so a lookup touches the key of a group only when the tags match.
+ *
+ * Tables are thread-local while they are filled. Partial tables of the same partition are merged with MergeFrom(),
+ * either directly or after being spilled to a run of temporary pages with WriteTo().
+ */
+class AggregationTable {
+ public:
+  explicit AggregationTable(const AggregationLayout *layout) : layout_(layout) {}
+
+  /**
+   * Find the group of a key, inserting it with initial aggregates if it is new.
+   * @return the number of the group
+   */
+  auto FindOrInsert(const char *key, size_t key_size, hash_t hash) -> uint32_t;
+
+  /** Accumulate the aggregates of an input tuple into a group. */
+  void Accumulate(uint32_t group, const Tuple &tuple);
+
+  /** Merge every group of another table of the same aggregation into this one. */
+  void MergeFrom(const AggregationTable &other);
+
+  /** Append every group to a run as a partial aggregate tuple. */
+  void WriteTo(TmpTupleRun *run) const;
+
+  /** Merge a partial aggregate tuple, as written by WriteTo(), into this table. */
+  void MergeFrom(const Tuple &partial);
+
+  /** @return the number of groups */
+  auto GetNumGroups() const -> size_t { return hashes_.size(); }
+
+  /** @return an estimate of the memory the table takes */
+  auto GetMemoryUsage() const -> size_t;
+
+  /** @return the output tuple of a group: its group-by values, then its aggregates */
+  auto MakeOutputTuple(uint32_t group, const Schema *output_schema) const -> Tuple;
+
+  /** Remove every group, releasing the memory of the table */
+  void Clear();
+
+ private:
+  struct Slot {
+    uint32_t tag_;
+    /** The group number plus one, 0 for an empty slot */
+    uint32_t group_;
+  };
+
+  static auto TagOf(hash_t hash) -> uint32_t { return static_cast<uint32_t>(hash >> 32); }
+
+  /** @return a pointer to the key of a group, and its size */
+  auto KeyOf(uint32_t group) const -> const char * { return keys_.data() + key_offsets_[group]; }
+  auto KeySizeOf(uint32_t group) const -> size_t { return key_offsets_[group + 1] - key_offsets_[group]; }
+
+  /** Double the slots, or allocate the first ones */
+  void Grow();
+
+  /** Combine a count, an int64_t or the bits of a double into an accumulator of a group */
+  void CombineWord(uint32_t group, size_t aggregate, int64_t word);
+
+  /** Combine a Value into an aggregate of a group that is kept as a Value */
+  void CombineValue(uint32_t group, size_t aggregate, const Value &value);
+
+  /**
+   * Merge the accumulators of a partial group into a group.
+   * @param valid the flags of the partial accumulators that are not NULL
+   * @param values the Values of the partial group
+   */
+  void MergeAccumulators(uint32_t group, const uint8_t *valid, const int64_t *accumulators, const Value *values);
+
+  const AggregationLayout *layout_;
+  std::vector<Slot> slots_;
+  /** The key of group i is keys_[key_offsets_[i], key_offsets_[i + 1]) */
+  std::vector<char> keys_;
+  std::vector<uint32_t> key_offsets_{0};
+  std::vector<hash_t> hashes_;
+  /** One int64_t per aggregate and group, doubles stored bit for bit, and whether each one is not NULL */
+  std::vector<int64_t> accumulators_;
+  std::vector<uint8_t> valid_;
+  /** The aggregates kept as Values, AggregationLayout::num_values_ per group */
+  std::vector<Value> values_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <iterator>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -19,7 +21,9 @@
 #include "concurrency/transaction_manager.h"
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
+#include "execution/parallel_pipeline.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 namespace bustub {
 
@@ -49,23 +53,40 @@ class ExecutionEngine {
    */
   auto Execute(const AbstractPlanNodeRef &plan, std::vector<Tuple> *result_set, Transaction *txn,
                ExecutorContext *exec_ctx) -> bool {
+    // A plan that is a single pipeline runs on all workers, each collecting its own share of the result.
+    // An exception thrown by a worker is rethrown here once every worker has stopped. Like one thrown by an executor
+    // of a serial plan, it propagates to the caller instead of passing for a partial result.
+    if (ParallelPipeline::CanRun(exec_ctx, *plan)) {
+      std::vector<std::vector<Tuple>> worker_results(exec_ctx->GetParallelism());
+      ParallelPipeline::Run(exec_ctx, plan, [&](size_t worker_id, TupleBatch *batch) {
+        for (size_t i = 0; i < batch->Size(); i++) {
+          worker_results[worker_id].push_back(std::move(batch->GetTuple(i)));
+        }
+      });
+      if (result_set != nullptr) {
+        for (auto &tuples : worker_results) {
+          result_set->insert(result_set->end(), std::make_move_iterator(tuples.begin()),
+                             std::make_move_iterator(tuples.end()));
+        }
+      }
+      return true;
+    }
+
     // Construct and executor for the plan
     auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
 
     // Prepare the root executor
     executor->Init();
 
-    // Execute the query plan
-    try {
-      Tuple tuple;
-      RID rid;
-      while (executor->Next(&tuple, &rid)) {
-        if (result_set != nullptr) {
-          result_set->push_back(tuple);
+    // Execute the query plan, pulling the root a batch at a time; executors that support it pass whole batches down
+    // the tree
+    TupleBatch batch;
+    while (executor->NextBatch(&batch)) {
+      if (result_set != nullptr) {
+        for (size_t i = 0; i < batch.Size(); i++) {
+          result_set->push_back(std::move(batch.GetTuple(i)));
         }
       }
-    } catch (Exception &e) {
-      // TODO(student): handle exceptions
     }
 
     return true;
@@ -12,15 +12,34 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "catalog/catalog.h"
+#include "common/worker_pool.h"
 #include "concurrency/transaction.h"
+#include "execution/plans/abstract_plan.h"
+#include "storage/index/blocked_bloom_filter.h"
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
+
+/**
+ * A bloom filter over the join keys of a hash join build side, pushed down to a scan on the probe side so the scan
+ * drops the rows that cannot find a match before they go anywhere.
+ */
+struct RuntimeFilter {
+  /** The column of the scan's output schema holding the probe side join key */
+  uint32_t column_idx_;
+  /** The filter over HashUtil::HashValue() of the build side join keys */
+  std::shared_ptr<const BlockedBloomFilter> filter_;
+};
+
 /**
  * ExecutorContext stores all the context necessary to run an executor.
  */
@@ -33,10 +52,21 @@ class ExecutorContext {
    * @param bpm The buffer pool manager that the executor uses
    * @param txn_mgr The transaction manager that the executor uses
    * @param lock_mgr The lock manager that the executor uses
+   * @param worker_pool The threads that run parallel pipelines, nullptr to run everything on the calling thread
+   * @param parallelism The number of workers a parallel pipeline is split across
+   * @param memory_budget The bytes an executor may hold in memory before it spills to disk
    */
   ExecutorContext(Transaction *transaction, Catalog *catalog, BufferPoolManager *bpm, TransactionManager *txn_mgr,
-                  LockManager *lock_mgr)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, txn_mgr_(txn_mgr), lock_mgr_(lock_mgr) {}
+                  LockManager *lock_mgr, WorkerPool *worker_pool = nullptr, size_t parallelism = 1,
+                  size_t memory_budget = EXECUTION_MEMORY_BUDGET)
+      : transaction_(transaction),
+        catalog_{catalog},
+        bpm_{bpm},
+        txn_mgr_(txn_mgr),
+        lock_mgr_(lock_mgr),
+        worker_pool_(worker_pool),
+        parallelism_(worker_pool == nullptr ? 1 : std::max<size_t>(parallelism, 1)),
+        memory_budget_(memory_budget) {}
 
   ~ExecutorContext() = default;
 
@@ -60,6 +90,60 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /** @return the worker pool, nullptr if the query runs on the calling thread only */
+  auto GetWorkerPool() -> WorkerPool * { return worker_pool_; }
+
+  /** @return the number of workers a parallel pipeline is split across, 1 means serial execution */
+  auto GetParallelism() const -> size_t { return parallelism_; }
+
+  /** @return the bytes an executor may hold in memory, e.g. for a hash table, before it spills to disk */
+  auto GetMemoryBudget() const -> size_t { return memory_budget_; }
+
+  /**
+   * The workers of a parallel pipeline each build their own executors for the same plan nodes. State those
+   * executors must share, such as the morsel queue of a scan or the hash table of a join build, is published
+   * here under the plan node by whoever sets the pipeline up.
+   * @return the state published for `plan`, or nullptr if there is none
+   */
+  template <typename T>
+  auto GetSharedState(const AbstractPlanNode *plan) -> std::shared_ptr<T> {
+    std::scoped_lock lock(shared_state_latch_);
+    auto iter = shared_state_.find(plan);
+    return iter == shared_state_.end() ? nullptr : std::static_pointer_cast<T>(iter->second);
+  }
+
+  /** Publish the state shared by the executors of `plan`, or withdraw it by passing nullptr. */
+  void SetSharedState(const AbstractPlanNode *plan, std::shared_ptr<void> state) {
+    std::scoped_lock lock(shared_state_latch_);
+    if (state == nullptr) {
+      shared_state_.erase(plan);
+    } else {
+      shared_state_[plan] = std::move(state);
+    }
+  }
+
+  /**
+   * Publish a runtime filter of `join` for `scan`, replacing the one `join` published before. A scan picks up its
+   * filters in Init(), so the join publishes before it initializes its probe side.
+   */
+  void SetRuntimeFilter(const AbstractPlanNode *scan, const AbstractPlanNode *join, RuntimeFilter filter) {
+    std::scoped_lock lock(shared_state_latch_);
+    runtime_filters_[scan][join] = std::move(filter);
+  }
+
+  /** @return the runtime filters published for `scan` */
+  auto GetRuntimeFilters(const AbstractPlanNode *scan) -> std::vector<RuntimeFilter> {
+    std::scoped_lock lock(shared_state_latch_);
+    std::vector<RuntimeFilter> filters;
+    auto iter = runtime_filters_.find(scan);
+    if (iter != runtime_filters_.end()) {
+      for (const auto &[join, filter] : iter->second) {
+        filters.push_back(filter);
+      }
+    }
+    return filters;
+  }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +155,17 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The threads parallel pipelines run on, and how many of them one pipeline uses */
+  WorkerPool *worker_pool_;
+  size_t parallelism_;
+  /** The memory an executor may use before spilling */
+  size_t memory_budget_;
+  /** State shared by the per-worker executors of a plan node */
+  std::mutex shared_state_latch_;
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<void>> shared_state_;
+  /** Runtime filters by the scan they apply to and the join that published them */
+  std::unordered_map<const AbstractPlanNode *, std::unordered_map<const AbstractPlanNode *, RuntimeFilter>>
+      runtime_filters_;
 };
 
 }  // namespace bustub
@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <utility>
+
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -20,6 +23,11 @@ namespace bustub {
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ *
+ * Executors can also be pulled a batch at a time through NextBatch(). Every
+ * executor supports it through an adapter over Next(); the scans, filters,
+ * projections, joins and aggregations that move many rows implement it natively.
+ * A consumer drives an executor through either Next() or NextBatch(), not both.
  */
 class AbstractExecutor {
  public:
@@ -46,6 +54,21 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor.
+   * @param[out] batch The batch to fill, it is reset first
+   * @return `true` if the batch holds at least one tuple, `false` if there are no more tuples
+   */
+  virtual auto NextBatch(TupleBatch *batch) -> bool {
+    batch->Reset();
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->Append(std::move(tuple), rid);
+    }
+    return !batch->IsEmpty();
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
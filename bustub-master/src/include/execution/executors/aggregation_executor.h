@@ -13,140 +13,29 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include "common/util/hash_util.h"
-#include "container/hash/hash_function.h"
+#include "execution/aggregation_table.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/aggregation_plan.h"
+#include "storage/table/tmp_tuple_run.h"
 #include "storage/table/tuple.h"
-#include "type/value_factory.h"
 
 namespace bustub {
 
-/**
- * A simplified hash table that has all the necessary functionality for aggregations.
- */
-class SimpleAggregationHashTable {
- public:
-  /**
-   * Construct a new SimpleAggregationHashTable instance.
-   * @param agg_exprs the aggregation expressions
-   * @param agg_types the types of aggregations
-   */
-  SimpleAggregationHashTable(const std::vector<AbstractExpressionRef> &agg_exprs,
-                             const std::vector<AggregationType> &agg_types)
-      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
-
-  /** @return The initial aggregrate value for this aggregation executor */
-  auto GenerateInitialAggregateValue() -> AggregateValue {
-    std::vector<Value> values{};
-    for (const auto &agg_type : agg_types_) {
-      switch (agg_type) {
-        case AggregationType::CountStarAggregate:
-          // Count start starts at zero.
-          values.emplace_back(ValueFactory::GetIntegerValue(0));
-          break;
-        case AggregationType::CountAggregate:
-        case AggregationType::SumAggregate:
-        case AggregationType::MinAggregate:
-        case AggregationType::MaxAggregate:
-          // Others starts at null.
-          values.emplace_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
-          break;
-      }
-    }
-    return {values};
-  }
-
-  /**
-   * TODO(Student)
-   *
-   * Combines the input into the aggregation result.
-   * @param[out] result The output aggregate value
-   * @param input The input value
-   */
-  void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
-    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
-      switch (agg_types_[i]) {
-        case AggregationType::CountStarAggregate:
-        case AggregationType::CountAggregate:
-        case AggregationType::SumAggregate:
-        case AggregationType::MinAggregate:
-        case AggregationType::MaxAggregate:
-          break;
-      }
-    }
-  }
-
-  /**
-   * Inserts a value into the hash table and then combines it with the current aggregation.
-   * @param agg_key the key to be inserted
-   * @param agg_val the value to be inserted
-   */
-  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht_.count(agg_key) == 0) {
-      ht_.insert({agg_key, GenerateInitialAggregateValue()});
-    }
-    CombineAggregateValues(&ht_[agg_key], agg_val);
-  }
-
-  /**
-   * Clear the hash table
-   */
-  void Clear() { ht_.clear(); }
-
-  /** An iterator over the aggregation hash table */
-  class Iterator {
-   public:
-    /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
-
-    /** @return The key of the iterator */
-    auto Key() -> const AggregateKey & { return iter_->first; }
-
-    /** @return The value of the iterator */
-    auto Val() -> const AggregateValue & { return iter_->second; }
-
-    /** @return The iterator before it is incremented */
-    auto operator++() -> Iterator & {
-      ++iter_;
-      return *this;
-    }
-
-    /** @return `true` if both iterators are identical */
-    auto operator==(const Iterator &other) -> bool { return this->iter_ == other.iter_; }
-
-    /** @return `true` if both iterators are different */
-    auto operator!=(const Iterator &other) -> bool { return this->iter_ != other.iter_; }
-
-   private:
-    /** Aggregates map */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
-  };
-
-  /** @return Iterator to the start of the hash table */
-  auto Begin() -> Iterator { return Iterator{ht_.cbegin()}; }
-
-  /** @return Iterator to the end of the hash table */
-  auto End() -> Iterator { return Iterator{ht_.cend()}; }
-
- private:
-  /** The hash table is just a map from aggregate keys to aggregate values */
-  std::unordered_map<AggregateKey, AggregateValue> ht_{};
-  /** The aggregate expressions that we have */
-  const std::vector<AbstractExpressionRef> &agg_exprs_;
-  /** The types of aggregations that we have */
-  const std::vector<AggregationType> &agg_types_;
-};
-
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX)
  * over the tuples produced by a child executor.
+ *
+ * The aggregation runs in two phases. First every worker, or the calling thread if the child is not a pipeline that
+ * can run in parallel, aggregates its share of the input into thread-local AggregationTables, one per partition of
+ * the group key hashes. A worker whose tables outgrow its share of the memory budget spills them, as partial
+ * aggregates, to one run per partition and starts over with empty tables. Then the partial tables of each partition
+ * are merged into one. Without spills the workers merge the partitions in parallel before the first output tuple;
+ * otherwise one partition at a time is merged, from the tables and runs, when the output reaches it.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
@@ -170,39 +59,67 @@ class AggregationExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the aggregation.
+   * @param[out] batch The batch of tuples produced by the aggregation
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the aggregation */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
   /** Do not use or remove this function, otherwise you will get zero points. */
   auto GetChildExecutor() const -> const AbstractExecutor *;
 
- private:
-  /** @return The tuple as an AggregateKey */
-  auto MakeAggregateKey(const Tuple *tuple) -> AggregateKey {
-    std::vector<Value> keys;
-    for (const auto &expr : plan_->GetGroupBys()) {
-      keys.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
-    }
-    return {keys};
-  }
-
-  /** @return The tuple as an AggregateValue */
-  auto MakeAggregateValue(const Tuple *tuple) -> AggregateValue {
-    std::vector<Value> vals;
-    for (const auto &expr : plan_->GetAggregates()) {
-      vals.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
-    }
-    return {vals};
-  }
+  /** The group key hashes are split into this many partitions, by their highest bits */
+  static constexpr size_t PARTITION_BITS = 4;
+  static constexpr size_t NUM_PARTITIONS = 1 << PARTITION_BITS;
 
  private:
+  /** The tables of one worker, one per partition, and the runs its partial aggregates were spilled to */
+  struct LocalAggregation {
+    std::vector<AggregationTable> tables_;
+    std::vector<TmpTupleRun> runs_;
+    /** The group key being encoded */
+    std::vector<char> key_;
+    bool spilled_{false};
+  };
+
+  static auto PartitionOf(hash_t hash) -> size_t { return static_cast<uint64_t>(hash) >> (64 - PARTITION_BITS); }
+
+  /** @return empty tables and runs for a worker */
+  auto MakeLocalAggregation() -> LocalAggregation;
+
+  /** Aggregate a batch of the child's tuples into the tables of a worker, spilling them if they outgrow `budget` */
+  void Accumulate(LocalAggregation *local, TupleBatch *batch, size_t budget);
+
+  /** Spill every table of a worker to its run and clear it */
+  void Spill(LocalAggregation *local);
+
+  /** Merge the partial aggregates of a partition, in memory and spilled, into partitions_ */
+  void MergePartition(size_t partition);
+
+  /** @return The output tuple of the group the cursor is at (group-by values, then aggregates), and move past it */
+  auto MakeOutputTuple() -> Tuple;
+
+  /** @return whether the cursor is at a group, moving it to the next partition, merged if needed, at the end of one */
+  auto Advance() -> bool;
+
   /** The aggregation plan node */
   const AggregationPlanNode *plan_;
   /** The child executor that produces tuples over which the aggregation is computed */
   std::unique_ptr<AbstractExecutor> child_;
-  /** Simple aggregation hash table */
-  // TODO(Student): Uncomment SimpleAggregationHashTable aht_;
-  /** Simple aggregation hash table iterator */
-  // TODO(Student): Uncomment SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** How the groups are keyed and aggregated */
+  AggregationLayout layout_;
+  /** The tables of the workers, kept until their partitions are merged */
+  std::vector<LocalAggregation> locals_;
+  /** The merged table of each partition */
+  std::vector<AggregationTable> partitions_;
+  /** Whether any worker spilled, so that the partitions are merged one at a time */
+  bool spilled_{false};
+  /** The partition and group of the next output tuple */
+  size_t partition_{0};
+  uint32_t group_{0};
 };
 }  // namespace bustub
@@ -13,17 +13,42 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/radix_join_table.h"
+#include "storage/table/tmp_tuple_run.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * HashJoinExecutor executes an equi-JOIN on two tables with an in-memory hash table.
+ *
+ * Init() builds the hash table over the right child, a RadixJoinTable whose partitions fit in cache. Next() and
+ * NextBatch() then probe it with the tuples of the left child, pulled a batch at a time, so a LEFT join keeps every
+ * left tuple. The tuples of a left batch are hashed in one pass and probed grouped by the partition they fall into,
+ * so a partition is probed while it is in cache; the order of the output within a batch is not kept.
+ *
+ * If the hash table outgrows the memory budget of the executor context, the join turns into a grace hash join: the
+ * right input, then the left input, are partitioned by the hash of their join keys into runs of temporary pages,
+ * and the partitions are joined one at a time. A partition whose right side still does not fit is partitioned
+ * again on the next bits of the hash, up to GRACE_MAX_DEPTH times (beyond that it is one huge key, and is joined in
+ * memory anyway).
+ *
+ * An INNER join whose build fits in memory also builds a bloom filter over the build keys and publishes it, through
+ * the executor context, to the SeqScan its probe key comes from (see PublishRuntimeFilter()). The probe side is
+ * initialized only after that, so the scan can drop the rows without a match before they are even copied out of
+ * their pages.
+ *
+ * When the right child is a pipeline, the workers of the context build thread-local tables that are merged
+ * afterwards. When the join itself is part of a parallel pipeline, the table is built once by the pipeline and
+ * published in the executor context, and the executors of all workers probe it. Both parallel builds stay in
+ * memory.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -48,12 +73,121 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The batch of tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the join */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
+  /**
+   * Build the hash table of a join over its right input in memory, in parallel if the right input is a pipeline,
+   * and publish its runtime filter. The memory budget does not apply.
+   */
+  static auto BuildHashTable(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan)
+      -> std::shared_ptr<RadixJoinTable>;
+
  private:
-  /** The NestedLoopJoin plan node to be executed. */
+  /** A grace hash join splits its inputs into 2^GRACE_FANOUT_BITS partitions at each level */
+  static constexpr size_t GRACE_FANOUT_BITS = 4;
+  static constexpr size_t GRACE_FANOUT = 1 << GRACE_FANOUT_BITS;
+  static constexpr size_t GRACE_MAX_DEPTH = 3;
+  /** Bits a runtime filter spends on each build row, for about 1% false positives */
+  static constexpr size_t RUNTIME_FILTER_BITS_PER_KEY = 10;
+
+  /** The right and left tuples whose join keys fall into one partition of a grace hash join */
+  struct JoinPartition {
+    TmpTupleRun right_;
+    TmpTupleRun left_;
+    /** The partitioning level that produced the partition */
+    size_t depth_;
+  };
+
+  /** @return the memory the hash table needs for `num_tuples` tuples with `num_bytes` bytes of data */
+  static auto Footprint(size_t num_bytes, size_t num_tuples) -> size_t {
+    return num_bytes + num_tuples * RadixJoinTable::ROW_OVERHEAD;
+  }
+
+  /** @return the partition of a join key hash at a partitioning level, taken from the next high bits of the hash */
+  static auto PartitionOf(hash_t hash, size_t depth) -> size_t;
+
+  /**
+   * Publish a bloom filter over the build keys for the scan on the probe side, if the join is an INNER join and its
+   * probe key is a column that can be traced down to a SeqScan through filters, projections and the probe sides of
+   * other hash joins.
+   */
+  static void PublishRuntimeFilter(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan, const RadixJoinTable &ht);
+
+  /** Build the hash table over the right child, or partition it if it exceeds the memory budget */
+  void BuildOrPartition();
+
+  /** Partition the left child along the right one, once the join has spilled */
+  void PartitionLeft();
+
+  /** @return GRACE_FANOUT empty partitions of a partitioning level */
+  auto MakePartitions(size_t depth) const -> std::vector<JoinPartition>;
+
+  /** Unpin the pages the runs of the partitions are appending to, so they hold no frames between batches */
+  void FinishRuns(std::vector<JoinPartition> *partitions);
+
+  /** Queue the partitions that can produce output, completing their runs */
+  void PushPartitions(std::vector<JoinPartition> *partitions);
+
+  /** Split a partition whose right side does not fit in memory one level further */
+  void Repartition(JoinPartition *partition);
+
+  /** Move to the next queued partition, loading its right side into the hash table */
+  auto NextPartition() -> bool;
+
+  /** Pull the next batch of left tuples to probe with, from the left child or from the partitions */
+  auto NextLeftBatch() -> bool;
+
+  /** Move the tuples of a batch of the right input into the hash table under their join keys */
+  static void InsertBatch(const HashJoinPlanNode *plan, const Schema &right_schema, TupleBatch *batch,
+                          RadixJoinTable *ht);
+
+  /** Hash the join keys of a new left batch and order its tuples by the partition they probe */
+  void PrepareLeftBatch();
+
+  /** Produce the next joined tuple, shared by Next() and NextBatch(). */
+  auto NextJoined(Tuple *tuple) -> bool;
+
+  /** @return The left values followed by the right ones, or NULLs when `right_tuple` is nullptr */
+  auto MakeOutputTuple(const Tuple &left_tuple, const Tuple *right_tuple) const -> Tuple;
+
+  /** The HashJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
+  /** The child executors of the probe (left) and build (right) sides */
+  std::unique_ptr<AbstractExecutor> left_child_;
+  std::unique_ptr<AbstractExecutor> right_child_;
+
+  /** The hash table over the right child, possibly shared with the executors of other workers */
+  std::shared_ptr<const RadixJoinTable> ht_;
+
+  /** Whether the join spilled, probing partitions instead of the left child */
+  bool spilled_{false};
+  /** The partitions left to join, and the one being joined with the page of its left side to probe next */
+  std::vector<JoinPartition> pending_;
+  std::optional<JoinPartition> current_;
+  size_t left_page_{0};
+  /** Tuples read from a page of a partition */
+  std::vector<Tuple> page_tuples_;
+
+  /** The batch of left tuples being probed, with the join key and hash of every tuple */
+  TupleBatch left_batch_;
+  std::vector<Value> left_keys_;
+  std::vector<hash_t> left_hashes_;
+  /** The tuples of the left batch in the order they probe, and how far the join is */
+  std::vector<uint32_t> probe_order_;
+  std::vector<size_t> partition_starts_;
+  size_t left_cursor_{0};
+  /** Whether the current left tuple has been looked up yet, and the rows of the table it matches */
+  bool probed_{false};
+  std::vector<uint32_t> matches_;
+  size_t match_cursor_{0};
 };
 
 }  // namespace bustub
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "catalog/catalog.h"
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -42,7 +44,22 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Number of RIDs fetched from the index at a time */
+  static constexpr size_t BATCH_SIZE = 128;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  /** The scanned table */
+  TableInfo *table_info_{nullptr};
+  /** The open range scan over the index */
+  std::unique_ptr<IndexRangeScan> scan_;
+  /** The current batch of RIDs and the next one to emit */
+  std::vector<RID> rids_;
+  size_t cursor_{0};
+  /** For an index-only scan: the index entries of the current batch */
+  std::vector<Tuple> entries_;
+  /** For an index-only scan: the entry schema of the index and the output column of each entry column */
+  const Schema *entry_schema_{nullptr};
+  std::vector<uint32_t> entry_attrs_;
 };
 }  // namespace bustub
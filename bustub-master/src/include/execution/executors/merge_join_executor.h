@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.h
+//
+// Identification: src/include/execution/executors/merge_join_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/merge_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * MergeJoinExecutor executes an equi-JOIN of two children that produce their tuples in ascending order of the join
+ * keys.
+ *
+ * The join walks both children side by side. For each left tuple it skips the right tuples with smaller keys and
+ * collects the run of right tuples with an equal key, which it keeps for as long as the following left tuples have
+ * that key too. Memory is bounded by the longest run of duplicate right keys, never by the size of an input. Tuples
+ * with a NULL key match nothing, wherever the children put them; a LEFT join still produces its left ones.
+ */
+class MergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new MergeJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The merge join plan to be executed
+   * @param left_child The child executor that produces tuples for the left side of join
+   * @param right_child The child executor that produces tuples for the right side of join
+   */
+  MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&left_child, std::unique_ptr<AbstractExecutor> &&right_child);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join
+   * @param[out] rid The next tuple RID produced by the join, not meaningful for joined tuples
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The batch of tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /** @return The output schema for the join */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /** One child of the join, read a batch at a time */
+  struct Input {
+    std::unique_ptr<AbstractExecutor> child_;
+    TupleBatch batch_;
+    /** The current tuple of the batch, and its join key once computed */
+    size_t cursor_{0};
+    Value key_;
+    bool has_key_{false};
+    bool exhausted_{false};
+  };
+
+  /** @return The current tuple of an input, pulling the next batch if needed, or nullptr at its end */
+  static auto Peek(Input *input) -> Tuple *;
+
+  /** Move an input past its current tuple */
+  static void Advance(Input *input) {
+    input->cursor_++;
+    input->has_key_ = false;
+  }
+
+  /** Take the next left tuple and line the right input up with it, collecting the run of right tuples it matches */
+  auto AdvanceLeft() -> bool;
+
+  /** Produce the next joined tuple, shared by Next() and NextBatch(). */
+  auto NextJoined(Tuple *tuple) -> bool;
+
+  /** @return The left values followed by the right ones, or NULLs when `right_tuple` is nullptr */
+  auto MakeOutputTuple(const Tuple &left_tuple, const Tuple *right_tuple) const -> Tuple;
+
+  /** The MergeJoin plan node to be executed. */
+  const MergeJoinPlanNode *plan_;
+  Input left_;
+  Input right_;
+
+  /** The left tuple being joined, and its join key */
+  Tuple left_tuple_;
+  Value left_key_;
+  bool has_left_{false};
+  /** The right tuples whose key is run_key_, whether the left tuple matches them, and the next one to join with */
+  std::vector<Tuple> run_;
+  Value run_key_;
+  bool has_run_{false};
+  bool matched_{false};
+  size_t run_cursor_{0};
+};
+
+}  // namespace bustub
@@ -13,11 +13,13 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel_queue.h"
 #include "execution/plans/mock_scan_plan.h"
 #include "storage/table/tuple.h"
 
@@ -25,9 +27,13 @@ namespace bustub {
 
 extern const char *mock_table_list[];
 auto GetMockTableSchemaOf(const std::string &table) -> Schema;
+auto GetSizeOf(const MockScanPlanNode *plan) -> size_t;
 
 /**
  * The MockScanExecutor executor executes a sequential table scan for tests.
+ *
+ * When the scan is part of a parallel pipeline, a MorselQueue is published for its plan node in the executor
+ * context and the executor only produces the rows of the morsels it claims from it.
  */
 class MockScanExecutor : public AbstractExecutor {
  public:
@@ -49,6 +55,13 @@ class MockScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan.
+   * @param[out] batch The batch of tuples produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -59,6 +72,12 @@ class MockScanExecutor : public AbstractExecutor {
   /** @return A dummy RID value */
   static auto MakeDummyRID() -> RID;
 
+  /** @return `true` if there is a row at the cursor, claiming the next morsel if the current one is done */
+  auto HasNext() -> bool;
+
+  /** @return The row at the cursor */
+  auto MakeTuple() const -> Tuple;
+
   /** MockScanExecutor::Next() returns `true` when scan is incomplete */
   constexpr static const bool EXECUTOR_ACTIVE{true};
 
@@ -71,6 +90,12 @@ class MockScanExecutor : public AbstractExecutor {
   /** The cursor for the current mock scan */
   std::size_t cursor_{0};
 
+  /** One past the last row the cursor may reach, the end of the current morsel for a parallel scan */
+  std::size_t end_{0};
+
+  /** The morsels shared with the other workers of a parallel scan, nullptr for a serial scan */
+  std::shared_ptr<MorselQueue> morsels_;
+
   /** The table function */
   std::function<Tuple(std::size_t)> func_;
 
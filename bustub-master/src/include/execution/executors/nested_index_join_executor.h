@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "catalog/catalog.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
@@ -48,7 +49,30 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Number of outer tuples whose keys are looked up in the index together */
+  static constexpr size_t BATCH_SIZE = 256;
+
+  /** Pull the next batch of outer tuples and probe the index with all of their join keys at once. */
+  auto FetchBatch() -> bool;
+
+  /** Build an output tuple from `outer_tuple` and `inner_tuple`, or nulls for an unmatched left join. */
+  auto MakeOutputTuple(const Tuple &outer_tuple, const Tuple *inner_tuple) const -> Tuple;
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  /** The outer table */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The inner table and the index on its join column */
+  TableInfo *inner_table_info_{nullptr};
+  IndexInfo *index_info_{nullptr};
+
+  /** The current batch of outer tuples, and the inner RIDs matching each of them */
+  TupleBatch outer_batch_{BATCH_SIZE};
+  std::vector<std::vector<RID>> inner_rids_;
+  /** Position in the batch: the outer tuple being joined and its next inner RID */
+  size_t outer_cursor_{0};
+  size_t inner_cursor_{0};
+  /** Whether the current outer tuple produced any output yet (for left join) */
+  bool matched_{false};
 };
 }  // namespace bustub
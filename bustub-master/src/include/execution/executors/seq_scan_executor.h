@@ -12,10 +12,14 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "catalog/catalog.h"
+#include "execution/morsel_queue.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "storage/table/tuple.h"
 
@@ -23,6 +27,13 @@ namespace bustub {
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * The scan walks the page directory of the table heap and reads a whole page at a time into a tuple buffer. The
+ * predicate pushed down by the optimizer (see OptimizeMergeFilterScan) and the runtime filters published by hash
+ * joins above the scan are applied to the tuples in place on the page, so only the survivors are copied out of it.
+ * In a parallel pipeline each
+ * worker has its own SeqScanExecutor, buffer and predicate evaluation, and the executors claim disjoint page ranges
+ * from the MorselQueue published for the plan node, so together they read every page once.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -44,11 +55,40 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan.
+   * @param[out] batch The batch of tuples produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** @return `true` if the tuple passes the runtime filters and satisfies the pushed-down filter predicate */
+  auto Matches(const Tuple &tuple) const -> bool;
+
+  /** @return `true` if the page buffer has a tuple left, reading the next page (or morsel) into it if needed */
+  auto FillBuffer() -> bool;
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The table being scanned */
+  const TableInfo *table_info_{nullptr};
+  /** The runtime filters published for the scan, as of Init() */
+  std::vector<RuntimeFilter> runtime_filters_;
+  /** Matches(), if the scan filters at all */
+  std::function<bool(const Tuple &)> keep_;
+  /** The page directory of the table, as of Init() */
+  std::vector<page_id_t> page_ids_;
+  /** The page ranges shared with the other workers of a parallel scan, nullptr for a serial scan */
+  std::shared_ptr<MorselQueue> morsels_;
+  /** The next page to read, and one past the last page of the current range, as indexes into page_ids_ */
+  size_t next_page_{0};
+  size_t end_page_{0};
+  /** The tuples of the page read last, and the next one to return */
+  std::vector<Tuple> page_tuples_;
+  size_t tuple_cursor_{0};
 };
 }  // namespace bustub
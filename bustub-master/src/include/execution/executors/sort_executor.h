@@ -18,13 +18,24 @@
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/parallel_sort.h"
 #include "execution/plans/sort_plan.h"
+#include "execution/run_merger.h"
+#include "execution/sort_key.h"
+#include "storage/table/tmp_tuple_run.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The SortExecutor executor executes a sort.
+ *
+ * Init() pulls the child a batch at a time and encodes the ORDER BY keys of every tuple with a SortKeyEncoder, so
+ * sorting compares bytes. While the buffered tuples fit in the memory budget of the executor context they are
+ * sorted in memory, by the workers of the context (see ParallelSort). Otherwise each budget's worth of tuples is
+ * sorted and spilled as a run of temporary pages, and the runs are merged with a loser tree: in passes that merge
+ * each GetMergeFanIn() adjacent runs into one, then the last ones while Next() pulls from them. The sort is stable,
+ * in memory and spilled alike.
  */
 class SortExecutor : public AbstractExecutor {
  public:
@@ -50,7 +61,33 @@ class SortExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** @return the memory the buffered tuples take with `num_bytes` bytes of tuple data */
+  auto Footprint(size_t num_bytes) const -> size_t {
+    return num_bytes + tuples_.size() * (sizeof(Tuple) + encoder_.GetKeySize() + ParallelSort::ROW_OVERHEAD);
+  }
+
+  /** @return the number of runs merged at once, one page of each is held in memory */
+  auto GetMergeFanIn() const -> size_t;
+
+  /** Sort the buffered tuples into order_ */
+  void SortBuffered();
+
+  /** Sort the buffered tuples and write them out as a run, emptying the buffer */
+  void SpillBuffered();
+
   /** The sort plan node to be executed */
   const SortPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  SortKeyEncoder encoder_;
+
+  /** The tuples buffered in memory, their encoded keys, and their sorted order once SortBuffered() ran */
+  std::vector<Tuple> tuples_;
+  std::vector<char> keys_;
+  std::vector<uint32_t> order_;
+  size_t cursor_{0};
+
+  /** The sorted runs spilled so far, and the merge of the last ones once the input is sorted */
+  std::vector<TmpTupleRun> runs_;
+  std::unique_ptr<RunMerger> merger_;
 };
 }  // namespace bustub
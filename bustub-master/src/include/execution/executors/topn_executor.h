@@ -17,14 +17,22 @@
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/parallel_sort.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/topn_plan.h"
+#include "execution/sort_key.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The TopNExecutor executor executes a topn.
+ *
+ * The executor buffers tuples with their ORDER BY keys encoded by a SortKeyEncoder, like SortExecutor. Whenever the
+ * buffer grows to twice N (or COMPACT_MIN_ROWS) tuples it is sorted with ParallelSort and cut back to the first N,
+ * and the N-th tuple becomes a bound: later tuples that do not sort before it are dropped right away. So the memory
+ * stays proportional to N, a small N costs little more than a heap, and a large N is sorted in parallel. Ties keep
+ * their input order.
  */
 class TopNExecutor : public AbstractExecutor {
  public:
@@ -50,7 +58,23 @@ class TopNExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** The buffer is compacted once it holds this many tuples, even for a smaller N */
+  static constexpr size_t COMPACT_MIN_ROWS = 1024;
+
+  /** Sort the buffered tuples into order_ and keep only the first N of them */
+  void Compact();
+
   /** The topn plan node to be executed */
   const TopNPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  SortKeyEncoder encoder_;
+
+  /** The buffered tuples and their encoded keys, the first N in sorted order after Compact() */
+  std::vector<Tuple> tuples_;
+  std::vector<char> keys_;
+  std::vector<uint32_t> order_;
+  /** Whether the buffer was compacted to N tuples, whose last one bounds the tuples that can still make it */
+  bool bounded_{false};
+  size_t cursor_{0};
 };
 }  // namespace bustub
@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.h
+//
+// Identification: src/include/execution/morsel_queue.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * Splits the input of a scan into morsels, small consecutive ranges of its units (rows of a mock table, pages of a
+ * table heap), and hands them out to the workers of a parallel pipeline. A worker asks for the next morsel as soon
+ * as it is done with the last one, so a slow worker simply ends up scanning fewer morsels.
+ */
+class MorselQueue {
+ public:
+  /**
+   * @param num_units the number of units in the scan
+   * @param morsel_size the number of units in a morsel
+   */
+  MorselQueue(size_t num_units, size_t morsel_size) : num_units_(num_units), morsel_size_(morsel_size) {}
+
+  /**
+   * Claim the next morsel.
+   * @param[out] begin the first unit of the morsel
+   * @param[out] end one past the last unit of the morsel
+   * @return false if the whole input has been handed out
+   */
+  auto Next(size_t *begin, size_t *end) -> bool {
+    size_t start = next_.fetch_add(morsel_size_, std::memory_order_relaxed);
+    if (start >= num_units_) {
+      return false;
+    }
+    *begin = start;
+    *end = std::min(start + morsel_size_, num_units_);
+    return true;
+  }
+
+ private:
+  const size_t num_units_;
+  const size_t morsel_size_;
+  std::atomic<size_t> next_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_pipeline.h
+//
+// Identification: src/include/execution/parallel_pipeline.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * Morsel-driven execution of a pipeline on the worker pool of the executor context.
+ *
+ * A pipeline is a plan fragment whose tuples stream from a scan to the next pipeline breaker without being
+ * materialized: a scan, optionally under filters, projections and the probe side of hash joins. Every worker builds
+ * its own executors for the fragment and pulls batches from them; the scan executors claim morsels of their input
+ * from a MorselQueue shared through the executor context, so together the workers read the input exactly once.
+ * The hash tables of the joins along the pipeline are built once, before the workers start, and shared read-only.
+ *
+ * The breaker that consumes the pipeline (the root of the query, an aggregation, a hash join build) receives the
+ * batches of each worker separately, keeps per-worker state and merges it once Run() returns.
+ */
+class ParallelPipeline {
+ public:
+  /** The number of rows of a mock table in one morsel */
+  static constexpr size_t MOCK_MORSEL_SIZE = 16384;
+  /** The number of table heap pages in one morsel */
+  static constexpr size_t TABLE_MORSEL_PAGES = 16;
+
+  /** @return whether `plan` is a pipeline and the context allows running it on more than one worker */
+  static auto CanRun(ExecutorContext *exec_ctx, const AbstractPlanNode &plan) -> bool;
+
+  /**
+   * Run the pipeline rooted at `plan` on GetParallelism() workers.
+   * @param consume called with each batch the pipeline produces and the id of the worker producing it, in
+   * [0, GetParallelism()). Calls for the same worker id never overlap.
+   */
+  static void Run(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan,
+                  const std::function<void(size_t, TupleBatch *)> &consume);
+
+ private:
+  static auto IsPipeline(const AbstractPlanNode &plan) -> bool;
+
+  /** Publish the shared state of the executors of the pipeline, recording the plan nodes it was published for. */
+  static void Publish(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan,
+                      std::vector<const AbstractPlanNode *> *published);
+};
+
+}  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_sort.h
+//
+// Identification: src/include/execution/parallel_sort.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/sort_key.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * Sorts rows held in memory by the keys a SortKeyEncoder encoded for them.
+ *
+ * The sort does not move the rows: it sorts (key prefix, row offset) entries, comparing the 8-byte prefixes as
+ * integers and going to SortKeyEncoder::Compare() only when two prefixes are equal. With more than one worker in the
+ * executor context and enough rows, it runs as a sample sort: splitters picked from a sorted sample cut the entries
+ * into one bucket per worker, the workers scatter their share of the entries to the buckets, and then sort one
+ * bucket each. Every step keeps the input order of equal keys, so the sort is stable either way.
+ */
+class ParallelSort {
+ public:
+  /** A worker gets at least this many rows to sort, fewer rows are sorted on the calling thread */
+  static constexpr size_t MIN_ROWS_PER_WORKER = 4096;
+  /** The sample holds this many entries per bucket */
+  static constexpr size_t OVERSAMPLING = 32;
+
+  /** A row to sort: the prefix of its encoded key, and its offset */
+  struct Entry {
+    uint64_t prefix_;
+    uint32_t row_;
+  };
+
+  /** The memory the sort takes per row, on top of the rows and their keys */
+  static constexpr size_t ROW_OVERHEAD = 2 * sizeof(Entry) + 2 * sizeof(uint32_t);
+
+  /**
+   * Sort rows by their keys.
+   * @param exec_ctx the executor context, whose workers sort in parallel
+   * @param encoder the encoder of the keys
+   * @param keys the encoded keys, GetKeySize() bytes per row
+   * @param tuples the rows
+   * @param[out] order the offsets of the rows in sorted order
+   */
+  static void Sort(ExecutorContext *exec_ctx, const SortKeyEncoder &encoder, const std::vector<char> &keys,
+                   const std::vector<Tuple> &tuples, std::vector<uint32_t> *order);
+};
+
+}  // namespace bustub
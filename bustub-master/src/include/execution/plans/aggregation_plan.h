@@ -104,6 +104,10 @@ struct AggregateKey {
    */
   auto operator==(const AggregateKey &other) const -> bool {
     for (uint32_t i = 0; i < other.group_bys_.size(); i++) {
+      // NULL group-by values all fall into the same group
+      if (group_bys_[i].IsNull() && other.group_bys_[i].IsNull()) {
+        continue;
+      }
       if (group_bys_[i].CompareEquals(other.group_bys_[i]) != CmpBool::CmpTrue) {
         return false;
       }
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -21,17 +22,35 @@
 
 namespace bustub {
 /**
- * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
+ * IndexScanPlanNode identifies a table that should be scanned through an index, in ascending or descending index key
+ * order. The scan may be restricted to a key range, e.g. `WHERE k BETWEEN a AND b` on an indexed column k.
+ *
+ * An index-only scan reads every column it produces from the index entries (key and included columns) and never
+ * touches the table. The columns the index does not store come out as NULL; the optimizer only plans such a scan
+ * when nothing above it reads them.
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
   /**
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
-   * @param table_oid the identifier of table to be scanned
+   * @param index_oid the identifier of the index to scan
+   * @param low_key the lower bound of the scanned key range, std::nullopt for none
+   * @param high_key the upper bound of the scanned key range, std::nullopt for none
+   * @param inclusivity whether each bound itself belongs to the range
+   * @param direction BACKWARD to produce tuples in descending key order
+   * @param index_only whether to produce tuples from the index entries alone
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, std::optional<Value> low_key = std::nullopt,
+                    std::optional<Value> high_key = std::nullopt, RangeInclusivity inclusivity = {},
+                    ScanDirection direction = ScanDirection::FORWARD, bool index_only = false)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        low_key_(std::move(low_key)),
+        high_key_(std::move(high_key)),
+        inclusivity_(inclusivity),
+        direction_(direction),
+        index_only_(index_only) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
@@ -40,12 +59,31 @@ class IndexScanPlanNode : public AbstractPlanNode {
 
   BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(IndexScanPlanNode);
 
-  /** The table whose tuples should be scanned. */
+  /** The index whose tuples should be scanned. */
   index_oid_t index_oid_;
 
+  /** The key range to scan; an unset bound leaves that end of the index open. */
+  std::optional<Value> low_key_;
+  std::optional<Value> high_key_;
+  RangeInclusivity inclusivity_;
+
+  /** The order in which the index is scanned. */
+  ScanDirection direction_;
+
+  /** Whether the table is skipped, see the class comment. */
+  bool index_only_;
+
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    std::string range;
+    if (low_key_.has_value() || high_key_.has_value()) {
+      range = fmt::format(", range={}{}, {}{}", low_key_.has_value() && inclusivity_.low_inclusive_ ? "[" : "(",
+                          low_key_.has_value() ? low_key_->ToString() : "-inf",
+                          high_key_.has_value() ? high_key_->ToString() : "+inf",
+                          high_key_.has_value() && inclusivity_.high_inclusive_ ? "]" : ")");
+    }
+    return fmt::format("IndexScan {{ index_oid={}{}{}{} }}", index_oid_, range,
+                       direction_ == ScanDirection::BACKWARD ? ", desc" : "", index_only_ ? ", index_only" : "");
   }
 };
 
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_plan.h
+//
+// Identification: src/include/execution/plans/merge_join_plan.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/table_ref/bound_join_ref.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * Merge join performs an equi-JOIN of two inputs that both arrive in ascending order of their join keys, by walking
+ * them side by side. The optimizer plans it (see OptimizeHashJoinAsMergeJoin) only when both children already
+ * provide that order, e.g. index scans or sorts on the join keys.
+ */
+class MergeJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new MergeJoinPlanNode instance.
+   * @param output_schema The output schema for the JOIN
+   * @param left The child plan producing the left tuples, ordered by the left JOIN key
+   * @param right The child plan producing the right tuples, ordered by the right JOIN key
+   * @param left_key_expression The expression for the left JOIN key
+   * @param right_key_expression The expression for the right JOIN key
+   * @param join_type The join type, INNER or LEFT
+   */
+  MergeJoinPlanNode(SchemaRef output_schema, AbstractPlanNodeRef left, AbstractPlanNodeRef right,
+                    AbstractExpressionRef left_key_expression, AbstractExpressionRef right_key_expression,
+                    JoinType join_type)
+      : AbstractPlanNode(std::move(output_schema), {std::move(left), std::move(right)}),
+        left_key_expression_{std::move(left_key_expression)},
+        right_key_expression_{std::move(right_key_expression)},
+        join_type_(join_type) {}
+
+  /** @return The type of the plan node */
+  auto GetType() const -> PlanType override { return PlanType::MergeJoin; }
+
+  /** @return The expression to compute the left join key */
+  auto LeftJoinKeyExpression() const -> const AbstractExpression & { return *left_key_expression_; }
+
+  /** @return The expression to compute the right join key */
+  auto RightJoinKeyExpression() const -> const AbstractExpression & { return *right_key_expression_; }
+
+  /** @return The left plan node of the merge join */
+  auto GetLeftPlan() const -> AbstractPlanNodeRef {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return The right plan node of the merge join */
+  auto GetRightPlan() const -> AbstractPlanNodeRef {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+  /** @return The join type used in the merge join */
+  auto GetJoinType() const -> JoinType { return join_type_; };
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(MergeJoinPlanNode);
+
+  /** The expression to compute the left JOIN key */
+  AbstractExpressionRef left_key_expression_;
+  /** The expression to compute the right JOIN key */
+  AbstractExpressionRef right_key_expression_;
+
+  /** The join type */
+  JoinType join_type_;
+
+ protected:
+  auto PlanNodeToString() const -> std::string override {
+    return fmt::format("MergeJoin {{ type={}, left_key={}, right_key={} }}", join_type_, left_key_expression_,
+                       right_key_expression_);
+  }
+};
+
+}  // namespace bustub
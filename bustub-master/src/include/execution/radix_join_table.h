@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// radix_join_table.h
+//
+// Identification: src/include/execution/radix_join_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * The hash table of an in-memory hash join over the rows of its build side.
+ *
+ * Rows are inserted with their join keys first, then Build() radix-partitions them on the low bits of the key hash
+ * with a histogram pass and a scatter pass, so each partition's rows are contiguous and small enough to stay in
+ * cache while it is probed. Every partition gets its own open-addressing table of 8-byte slots holding a hash tag
+ * and a row offset into the partitioned row array; a lookup only touches the key of a row whose tag matches.
+ * There is one slot per distinct key, pointing to the first row with that key, and the rows with equal keys are
+ * chained in insertion order, so duplicate keys cost neither the build nor the probes of other keys.
+ *
+ * A built table is read-only and may be probed by several threads at once.
+ */
+class RadixJoinTable {
+ public:
+  /** The number of build rows a partition should hold at most, so its slots and keys fit in the L2 cache */
+  static constexpr size_t PARTITION_ROWS = 2048;
+  /** The table splits into at most 2^MAX_RADIX_BITS partitions */
+  static constexpr size_t MAX_RADIX_BITS = 10;
+  /** The memory a row takes besides its tuple data: the Tuple, its key, hash and chain link, and two slots */
+  static constexpr size_t ROW_OVERHEAD =
+      sizeof(Tuple) + sizeof(Value) + sizeof(hash_t) + sizeof(uint32_t) + 2 * 2 * sizeof(uint32_t);
+
+  /** @return the hash of a join key, used for the partitions and slots of the table */
+  static auto HashOf(const Value &key) -> hash_t { return HashUtil::HashValue(&key); }
+
+  /** Add a row of the build side under its join key, which must not be NULL. Only before Build(). */
+  void Insert(Tuple &&tuple, const Value &key);
+
+  /** Move the rows of another table that has not been built into this one. Only before Build(). */
+  void Append(RadixJoinTable &&other);
+
+  /** Partition the rows and build the slots of every partition. */
+  void Build();
+
+  /** @return the number of rows in the table */
+  auto GetNumRows() const -> size_t { return rows_.size(); }
+
+  /** @return a row of the table, and its join key and hash; offsets change when the table is built */
+  auto GetRow(size_t row) const -> const Tuple & { return rows_[row]; }
+  auto GetKey(size_t row) const -> const Value & { return keys_[row]; }
+  auto GetHash(size_t row) const -> hash_t { return hashes_[row]; }
+
+  /** @return the number of partitions of the built table */
+  auto GetNumPartitions() const -> size_t { return partitions_.size(); }
+
+  /** @return the partition a key with the given hash falls into */
+  auto PartitionOf(hash_t hash) const -> size_t { return hash & radix_mask_; }
+
+  /**
+   * Find the rows of the built table whose join key equals `key`.
+   * @param hash HashOf(key)
+   * @param[out] rows the offsets of the matching rows are appended, in insertion order
+   */
+  void Find(const Value &key, hash_t hash, std::vector<uint32_t> *rows) const;
+
+ private:
+  /**
+   * A slot of a partition: the high bits of the key's hash, and the offset plus one of the first row with the key,
+   * 0 for an empty slot
+   */
+  struct Slot {
+    uint32_t tag_;
+    uint32_t row_;
+  };
+
+  /** The slots of a partition: slots_[begin_, begin_ + mask_ + 1) */
+  struct Partition {
+    size_t begin_;
+    size_t mask_;
+  };
+
+  static auto TagOf(hash_t hash) -> uint32_t { return static_cast<uint32_t>(hash >> 32); }
+
+  /** @return the slot within its partition where the probe for a hash starts */
+  auto HomeOf(hash_t hash, const Partition &partition) const -> size_t {
+    return (hash >> radix_bits_) & partition.mask_;
+  }
+
+  /** The rows, their join keys and their hashes, grouped by partition once the table is built */
+  std::vector<Tuple> rows_;
+  std::vector<Value> keys_;
+  std::vector<hash_t> hashes_;
+  /** The offset plus one of the next row with the same key, 0 for the last one; only once the table is built */
+  std::vector<uint32_t> next_;
+
+  std::vector<Slot> slots_;
+  std::vector<Partition> partitions_;
+  size_t radix_bits_{0};
+  hash_t radix_mask_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// run_merger.h
+//
+// Identification: src/include/execution/run_merger.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/sort_key.h"
+#include "storage/table/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * Merges runs of tuples that are each sorted by the keys of a SortKeyEncoder into one sorted stream.
+ *
+ * The runs are read back one page at a time, and the keys of a page are encoded as it is read. The smallest current
+ * tuple is picked with a loser tree: every inner node holds the run that lost the match played there, so replacing
+ * the winner replays only the matches on the path from its leaf to the root, about log2(k) comparisons for k runs.
+ * Ties go to the earlier run, so the merge is stable when the runs are in input order.
+ */
+class RunMerger {
+ public:
+  /**
+   * @param encoder the sort keys the runs are sorted by
+   * @param runs the runs to merge, owned by the merger from now on
+   */
+  RunMerger(const SortKeyEncoder *encoder, std::vector<TmpTupleRun> runs);
+
+  /**
+   * Yield the next tuple of the merged runs.
+   * @param[out] tuple the next tuple
+   * @return `true` if a tuple was produced, `false` if every run is exhausted
+   */
+  auto Next(Tuple *tuple) -> bool;
+
+ private:
+  /** A run being merged, with its current page read back and encoded */
+  struct Source {
+    explicit Source(TmpTupleRun &&run) : run_(std::move(run)) {}
+
+    TmpTupleRun run_;
+    size_t next_page_{0};
+    std::vector<Tuple> tuples_;
+    std::vector<char> keys_;
+    size_t cursor_{0};
+  };
+
+  /** Read the next page of a source if its current one is used up. @return whether the source has a tuple left */
+  auto Fill(Source *source) -> bool;
+
+  /** @return whether source `left` goes before source `right`; exhausted sources go last */
+  auto Less(size_t left, size_t right) const -> bool;
+
+  /** Play the matches of the subtree under `node`, recording the losers. @return the winner of the subtree */
+  auto Play(size_t node) -> size_t;
+
+  const SortKeyEncoder *encoder_;
+  std::vector<Source> sources_;
+  std::vector<bool> exhausted_;
+  /** tree_[0] is the overall winner, tree_[i] the loser of inner node i; leaf j is node sources_.size() + j */
+  std::vector<size_t> tree_;
+};
+
+}  // namespace bustub
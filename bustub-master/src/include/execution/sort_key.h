@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.h
+//
+// Identification: src/include/execution/sort_key.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+#include "type/type_id.h"
+
+namespace bustub {
+
+/**
+ * Encodes the ORDER BY keys of a tuple into a fixed-size byte string that compares with memcmp() the way the keys
+ * compare, so sorts compare raw bytes instead of going through Value::CompareLessThan() for every pair.
+ *
+ * Each key gets a byte that puts NULL first, then its value: integers big-endian with the sign bit flipped, doubles
+ * with the sign bit flipped or all bits inverted when negative, and the first VARCHAR_PREFIX_SIZE bytes of a string,
+ * zero padded. The bytes of a DESC key are inverted, which also puts its NULLs last. A string longer than its prefix
+ * is not fully encoded, so when two keys tie up to and including the first VARCHAR key, Compare() falls back to
+ * comparing the values of that key and the ones after it.
+ */
+class SortKeyEncoder {
+ public:
+  /** The bytes of a VARCHAR key that go into the encoded key */
+  static constexpr size_t VARCHAR_PREFIX_SIZE = 16;
+
+  /**
+   * @param order_bys the ORDER BY keys, evaluated against tuples of `schema`
+   * @param schema the schema of the tuples being sorted
+   */
+  SortKeyEncoder(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys, const Schema *schema);
+
+  /** @return the size of an encoded key */
+  auto GetKeySize() const -> size_t { return key_size_; }
+
+  /** Encode the ORDER BY keys of `tuple` into the GetKeySize() bytes at `key`. */
+  void Encode(const Tuple &tuple, char *key) const;
+
+  /**
+   * @return the first bytes of an encoded key as a big-endian number, so that two keys whose prefixes differ
+   * compare as their prefixes do, and only keys with equal prefixes need Compare()
+   */
+  auto GetPrefix(const char *key) const -> uint64_t {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < sizeof(prefix); i++) {
+      prefix = (prefix << 8) | (i < prefix_size_ ? static_cast<uint8_t>(key[i]) : 0);
+    }
+    return prefix;
+  }
+
+  /**
+   * Compare two tuples by their ORDER BY keys.
+   * @param left_key the encoded keys of `left`
+   * @param right_key the encoded keys of `right`
+   * @return a negative number, zero or a positive number if `left` sorts before, with or after `right`
+   */
+  auto Compare(const char *left_key, const Tuple &left, const char *right_key, const Tuple &right) const -> int {
+    int result = memcmp(left_key, right_key, compared_size_);
+    if (result != 0 || first_inexact_ == columns_.size()) {
+      return result;
+    }
+    return CompareValues(left, right);
+  }
+
+ private:
+  struct KeyColumn {
+    AbstractExpressionRef expr_;
+    TypeId type_;
+    bool descending_;
+    /** Where the NULL byte of the key is in the encoded key, followed by width_ bytes of value */
+    size_t offset_;
+    size_t width_;
+  };
+
+  /** @return the bytes a value of the type takes in an encoded key, 0 if only its NULL byte is encoded */
+  static auto WidthOf(TypeId type) -> size_t;
+
+  /** Compare the keys from first_inexact_ on by their values */
+  auto CompareValues(const Tuple &left, const Tuple &right) const -> int;
+
+  const Schema *schema_;
+  std::vector<KeyColumn> columns_;
+  size_t key_size_{0};
+  /** The first key whose encoding may be a prefix of its value, and the bytes of the encoding up to its end */
+  size_t first_inexact_{0};
+  size_t compared_size_{0};
+  /** The bytes of an encoded key that go into its prefix, at most compared_size_ */
+  size_t prefix_size_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * A batch of tuples passed between executors by AbstractExecutor::NextBatch().
+ *
+ * The rows are stored once and their storage is reused from batch to batch. A selection vector lists the rows that
+ * are still part of the batch, in order, so a filter drops rows by shrinking the selection instead of copying the
+ * survivors. All accessors index the selected rows.
+ */
+class TupleBatch {
+ public:
+  /** The number of rows executors put into one batch */
+  static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+  explicit TupleBatch(size_t capacity = DEFAULT_CAPACITY) : tuples_(capacity), rids_(capacity) {
+    selection_.reserve(capacity);
+  }
+
+  /** Empty the batch, keeping its storage. */
+  void Reset() {
+    num_rows_ = 0;
+    selection_.clear();
+  }
+
+  /** @return the number of rows the batch can hold */
+  auto GetCapacity() const -> size_t { return tuples_.size(); }
+
+  /** @return whether no more rows can be appended */
+  auto IsFull() const -> bool { return num_rows_ == tuples_.size(); }
+
+  /** @return the number of selected rows */
+  auto Size() const -> size_t { return selection_.size(); }
+
+  /** @return whether no row is selected */
+  auto IsEmpty() const -> bool { return selection_.empty(); }
+
+  /** Append a row and select it. The batch must not be full. */
+  void Append(Tuple &&tuple, RID rid) {
+    BUSTUB_ASSERT(!IsFull(), "tuple batch is full");
+    tuples_[num_rows_] = std::move(tuple);
+    rids_[num_rows_] = rid;
+    selection_.push_back(static_cast<uint32_t>(num_rows_++));
+  }
+
+  /** @return the i-th selected tuple */
+  auto GetTuple(size_t i) -> Tuple & { return tuples_[selection_[i]]; }
+  auto GetTuple(size_t i) const -> const Tuple & { return tuples_[selection_[i]]; }
+
+  /** @return the RID of the i-th selected tuple */
+  auto GetRid(size_t i) const -> RID { return rids_[selection_[i]]; }
+
+  /** Keep only the selected rows for which `keep(tuple)` returns true, in their order. */
+  template <typename Predicate>
+  void Select(Predicate &&keep) {
+    size_t num_selected = 0;
+    for (uint32_t row : selection_) {
+      if (keep(tuples_[row])) {
+        selection_[num_selected++] = row;
+      }
+    }
+    selection_.resize(num_selected);
+  }
+
+ private:
+  std::vector<Tuple> tuples_;
+  std::vector<RID> rids_;
+  /** Rows of tuples_ that are part of the batch */
+  std::vector<uint32_t> selection_;
+  /** Rows of tuples_ filled since the last Reset() */
+  size_t num_rows_{0};
+};
+
+}  // namespace bustub
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -50,6 +52,15 @@ class Optimizer {
    */
   auto OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief optimize hash join into merge join when both children already produce their tuples in ascending order of
+   * the join keys, e.g. index scans or sorts on them. Runs after the rules that plan index scans.
+   */
+  auto OptimizeHashJoinAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief check if the plan produces its tuples in ascending order of the output column `col_idx` */
+  auto IsOrderedBy(const AbstractPlanNode &plan, uint32_t col_idx) -> bool;
+
   /**
    * @brief optimize nested loop join into index join.
    */
@@ -85,8 +96,26 @@ class Optimizer {
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
-  /** @brief check if the index can be matched */
-  auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
+  /**
+   * @brief optimize a filter over a seq scan as an index range scan, e.g. `WHERE k BETWEEN a AND b` or `WHERE k > a`
+   * when there's an index on k. Conjuncts that don't bound the indexed column stay in a filter above the scan.
+   */
+  auto OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief turn an index scan into an index-only scan when the index stores (as key or included columns) every
+   * column the plan above the scan reads.
+   * @param needed_columns the output columns of `plan` read further up, std::nullopt if they all may be
+   */
+  auto OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan,
+                             const std::optional<std::set<uint32_t>> &needed_columns = std::nullopt)
+      -> AbstractPlanNodeRef;
+
+  /**
+   * @brief check if the index can be matched
+   * @param ordered whether the index must keep its keys in order (for range scans), which hash indexes do not
+   */
+  auto MatchIndex(const std::string &table_name, uint32_t index_key_idx, bool ordered = false)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
 
   /**
@@ -10,8 +10,10 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <optional>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "concurrency/transaction.h"
@@ -28,7 +30,7 @@ namespace bustub {
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) We only support unique key; BPlusTreeIndex builds non-unique indexes on top by suffixing keys with the RID
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
@@ -48,12 +50,26 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr) -> bool;
 
+  // Insert a batch of key-value pairs, best sorted by key: consecutive entries that fall into the same leaf are
+  // inserted with one descent. Duplicate keys are skipped. Returns the number of entries inserted.
+  auto InsertBatch(const std::vector<std::pair<KeyType, ValueType>> &entries, Transaction *transaction = nullptr)
+      -> size_t;
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
   // return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
 
+  // return the value associated with each of the keys, which must be sorted; (*results)[i] is empty if keys[i] is
+  // missing. The tree is walked once for the whole batch instead of once per key.
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                 Transaction *transaction = nullptr);
+
+  // return all values whose key lies in each of the [low, high] ranges, which must be sorted and not overlap
+  void GetValueRanges(const std::vector<std::pair<KeyType, KeyType>> &ranges,
+                      std::vector<std::vector<ValueType>> *results, Transaction *transaction = nullptr);
+
   // return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
@@ -61,6 +77,9 @@ class BPlusTree {
   auto Begin() -> INDEXITERATOR_TYPE;
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
   auto End() -> INDEXITERATOR_TYPE;
+  // iterators for scanning backwards with operator--: the last entry, or the last entry whose key <= key
+  auto RBegin() -> INDEXITERATOR_TYPE;
+  auto RBegin(const KeyType &key) -> INDEXITERATOR_TYPE;
 
   // print the B+ tree
   void Print(BufferPoolManager *bpm);
@@ -83,37 +102,43 @@ class BPlusTree {
 
   auto GetLeafNode(const KeyType &key, int iter = 0) -> LeafPage *;
 
+  // descend to the leaf of key, keeping every page on the way pinned in the transaction page set
+  auto GetLeafNodeWithPath(const KeyType &key, Transaction *transaction) -> LeafPage *;
+
+  // unpin what is left of the descent path and drop the pages freed by merges
+  void ReleasePath(Transaction *transaction, bool is_dirty);
+
   void ApplyNewRootPage(const KeyType &key, const ValueType &value);
 
-  auto InsertLeafInternal(const KeyType &key, const ValueType &value) -> bool;
+  auto InsertLeafInternal(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool;
 
-  template <class PageType>
-  auto Split(PageType *leaf_page) -> PageType *;
+  // append fast path: insert a key larger than every key in the tree straight into the cached rightmost leaf, as
+  // long as that does not split it. Returns false if the key has to go through the regular descent.
+  auto TryAppendToRightmostLeaf(const KeyType &key, const ValueType &value) -> bool;
 
-  void InsertKeyToParentPage(BPlusTreePage *left_page, BPlusTreePage *right_page, const KeyType &key);
+  // the separator bounding the leaf at the end of the descent path from above, or std::nullopt for the rightmost leaf
+  auto GetLeafUpperFence(Transaction *transaction) -> std::optional<KeyType>;
 
+  // split off the upper half of a full page; an append split keeps ~90% in the left page instead, since keys
+  // arriving in increasing order will never land there again
   template <class PageType>
-  auto MergeOrRedistribute(PageType *old_page) -> bool;
+  auto Split(PageType *leaf_page, bool append = false) -> PageType *;
+
+  // point the prev link of leaf page_id (if any) at prev_page_id, after a split or merge changed its left neighbour
+  void RelinkPrevPageId(page_id_t page_id, page_id_t prev_page_id);
+
+  void InsertKeyToParentPage(BPlusTreePage *left_page, BPlusTreePage *right_page, const KeyType &key,
+                             Transaction *transaction, bool append = false);
 
   template <class PageType>
-  void AdjustRoot(PageType *old_root_page);
+  void MergeOrRedistribute(PageType *old_page, Transaction *transaction);
+
+  void AdjustRoot(BPlusTreePage *old_root_page, Transaction *transaction);
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
   void ToString(BPlusTreePage *page, BufferPoolManager *bpm) const;
 
-  auto FindBrothers(BPlusTreePage *cur_page, BPlusTreePage **left_page, BPlusTreePage **right_page)
-      -> std::pair<int, int>;
-
-  auto SpecialFetchPage(page_id_t page_id) -> BPlusTreePage *;
-
-  void Merge(InternalPage *original_page, BPlusTreePage *target, int index, bool is_left);
-
-  void Merge(LeafPage *original_page, BPlusTreePage *target_page, int index, bool is_left);
-
-  template <class PageType>
-  void Redistribute(PageType *original_page, BPlusTreePage *target_page, int index, bool IsLeft);
-
   // member variable
   std::string index_name_;
   page_id_t root_page_id_;
@@ -121,6 +146,12 @@ class BPlusTree {
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  // the last leaf of the tree, where monotonically increasing keys (ids, timestamps) end up; reset whenever pages
+  // are freed, since the cached page might be one of them
+  page_id_t rightmost_leaf_page_id_{INVALID_PAGE_ID};
+  // the last key of that leaf as of the last insert into it, so that inserts of smaller keys skip fetching it; a
+  // remove may leave it larger than the actual last key, which only makes the append fast path miss
+  std::optional<KeyType> rightmost_last_key_;
 };
 
 }  // namespace bustub
@@ -11,19 +11,38 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <optional>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/blocked_bloom_filter.h"
 #include "storage/index/index.h"
 
 namespace bustub {
 
 #define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeyType, ValueType, KeyComparator>
 
+/**
+ * BPlusTreeIndex wraps a BPlusTree as a table index.
+ *
+ * The tree itself only stores unique keys. A non-unique index (see IndexMetadata::IsUnique) appends the RID of
+ * the tuple to every key, so entries with equal column values are still distinct and sit next to each other in
+ * RID order; ScanKey then collects them with a range scan. KeyType must have room for the key columns plus a RID.
+ *
+ * A covering index (see IndexMetadata::GetIncludeAttrs) additionally stores the included columns behind the key
+ * columns and the RID suffix. The comparator never looks at them, and index-only scans read them back through
+ * IndexRangeScan::NextEntryBatch.
+ *
+ * Optionally (EnableBloomFilter) the index keeps a bloom filter over its key columns in memory, so that looking up
+ * a key that is not there usually costs no descent at all. Removed keys stay in the filter until it is rebuilt from
+ * the leaves, which happens lazily before the next lookup once too many of them piled up or the index outgrew it.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
  public:
@@ -31,32 +50,128 @@ class BPlusTreeIndex : public Index {
 
   void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
+  void InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) override;
+
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  auto ScanRange(const Tuple *low, const Tuple *high, RangeInclusivity inclusivity, ScanDirection direction,
+                 size_t batch_size, Transaction *transaction) -> std::unique_ptr<IndexRangeScan> override;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
 
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
+  /** @return the entry (a tuple over GetEntrySchema) stored in an index key */
+  auto EntryFromKey(const KeyType &index_key) const -> Tuple;
+
+  /**
+   * Check ScanKey / ScanKeys against a bloom filter over the keys before searching the tree.
+   * @param bits_per_key memory spent per key, 10 gives about 1% false positives
+   */
+  void EnableBloomFilter(size_t bits_per_key = 10);
+
+  /** @return the number of key lookups the bloom filter answered without descending the tree */
+  auto GetAvoidedDescents() const -> size_t { return avoided_descents_; }
+
  protected:
+  /** @return the key schema, after checking that the key has room for the RID suffix and the included columns */
+  static auto CheckKeySchema(IndexMetadata *metadata) -> Schema *;
+
+  /** Build the index key of a tuple key (with its included columns, if any), suffixed with `rid` in a non-unique
+   * index */
+  auto MakeKey(const Tuple &key, const RID &rid) const -> KeyType;
+
+  /** @return the bloom filter hash of the key columns of an index key */
+  auto HashKey(const KeyType &index_key) const -> hash_t;
+
+  /** @return false if the bloom filter rules out the key; counts the avoided descent */
+  auto BloomFilterMayContain(const KeyType &index_key) -> bool;
+
+  /** Record an inserted key in the bloom filter */
+  void BloomFilterInsert(const KeyType &index_key);
+
+  /** Size a new bloom filter for the current keys and fill it from the leaves; bloom_latch_ is held exclusively */
+  void RebuildBloomFilter();
+
   // comparator for key
   KeyComparator comparator_;
+  // where the included columns start in a key: after the key columns and the RID suffix
+  uint32_t include_offset_;
+  // guards the bloom filter and its counters: lookups hold it shared, inserts, deletes and rebuilds exclusively
+  std::shared_mutex bloom_latch_;
+  // bloom filter over the key columns, nullptr unless enabled
+  std::unique_ptr<BlockedBloomFilter> bloom_filter_;
+  size_t bloom_bits_per_key_{0};
+  // the filter is rebuilt before the next lookup
+  bool bloom_stale_{false};
+  // keys added to / removed from the index since the filter was built
+  size_t bloom_keys_{0};
+  size_t bloom_removed_keys_{0};
+  std::atomic<size_t> avoided_descents_{0};
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
 };
 
+/**
+ * BPlusTreeRangeScan walks the leaf chain of a BPlusTreeIndex from the first key of a range towards its other end,
+ * forwards through the next links or backwards through the prev links. Between two batches only the leaf the scan
+ * stopped in stays pinned (by the underlying IndexIterator); it is released as soon as the range is exhausted.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeRangeScan : public IndexRangeScan {
+ public:
+  /**
+   * @param iter iterator positioned at the first entry of the range in scan order
+   * @param stop_key the bound at which the scan ends, or std::nullopt to scan to the end of the index
+   * @param stop_inclusive whether an entry equal to stop_key is part of the range
+   * @param direction whether the scan runs towards larger or smaller keys
+   * @param index the scanned index, which decodes the entries for NextEntryBatch
+   */
+  BPlusTreeRangeScan(INDEXITERATOR_TYPE &&iter, std::optional<KeyType> stop_key, bool stop_inclusive,
+                     ScanDirection direction, size_t batch_size, const KeyComparator &comparator,
+                     const BPLUSTREE_INDEX_TYPE *index);
+
+  auto NextBatch(std::vector<RID> *result) -> bool override;
+
+  auto NextEntryBatch(std::vector<RID> *result, std::vector<Tuple> *entries) -> bool override;
+
+ private:
+  /** Advance over the next batch, also decoding the entries unless `entries` is nullptr */
+  auto Advance(std::vector<RID> *result, std::vector<Tuple> *entries) -> bool;
+
+  INDEXITERATOR_TYPE iter_;
+  std::optional<KeyType> stop_key_;
+  bool stop_inclusive_;
+  ScanDirection direction_;
+  size_t batch_size_;
+  KeyComparator comparator_;
+  const BPLUSTREE_INDEX_TYPE *index_;
+};
+
 /** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
 
 constexpr static const auto INTEGER_SIZE = 4;
-using IntegerKeyType = GenericKey<INTEGER_SIZE>;
+/** The integer followed by the RID suffix of a non-unique index, rounded up to an instantiated GenericKey size */
+constexpr static const auto INTEGER_KEY_SIZE = 16;
+using IntegerKeyType = GenericKey<INTEGER_KEY_SIZE>;
 using IntegerValueType = RID;
-using IntegerComparatorType = GenericComparator<INTEGER_SIZE>;
+using IntegerComparatorType = GenericComparator<INTEGER_KEY_SIZE>;
 using BPlusTreeIndexForOneIntegerColumn = BPlusTreeIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using BPlusTreeIndexIteratorForOneIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+/** An integer index whose entries carry included columns as well, up to the largest instantiated GenericKey */
+constexpr static const auto COVERING_KEY_SIZE = 64;
+using CoveringKeyType = GenericKey<COVERING_KEY_SIZE>;
+using CoveringComparatorType = GenericComparator<COVERING_KEY_SIZE>;
+using CoveringHashFunctionType = HashFunction<CoveringKeyType>;
+
 }  // namespace bustub
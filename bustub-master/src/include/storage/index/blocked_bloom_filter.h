@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// blocked_bloom_filter.h
+//
+// Identification: src/include/storage/index/blocked_bloom_filter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+/**
+ * An in-memory blocked bloom filter over key hashes.
+ *
+ * The bit array is cut into 256-bit blocks, and a key sets 8 bits, one in each 32-bit word of a single block (the
+ * "split block" layout). A lookup therefore touches one cache line instead of k random ones. The filter may report
+ * false positives but never false negatives, and keys cannot be removed from it; the owner rebuilds it instead.
+ */
+class BlockedBloomFilter {
+ public:
+  /**
+   * @param expected_keys the number of keys the filter is sized for
+   * @param bits_per_key bits spent on each of those keys, 10 gives about 1% false positives
+   */
+  BlockedBloomFilter(size_t expected_keys, size_t bits_per_key)
+      : blocks_(std::max<size_t>(1, (expected_keys * bits_per_key + BLOCK_BITS - 1) / BLOCK_BITS)),
+        capacity_(expected_keys) {}
+
+  /** Add a key, given by its hash. */
+  void Insert(hash_t hash) {
+    auto &block = blocks_[BlockIndex(hash)];
+    const auto masks = Masks(hash);
+    for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      block[i] |= masks[i];
+    }
+  }
+
+  /** @return false if the key with this hash was definitely never inserted */
+  auto MayContain(hash_t hash) const -> bool {
+    const auto &block = blocks_[BlockIndex(hash)];
+    const auto masks = Masks(hash);
+    for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      if ((block[i] & masks[i]) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** @return the number of keys the filter was sized for */
+  auto GetCapacity() const -> size_t { return capacity_; }
+
+ private:
+  static constexpr size_t WORDS_PER_BLOCK = 8;
+  static constexpr size_t BLOCK_BITS = WORDS_PER_BLOCK * 32;
+  /** Odd multipliers deriving the bit of each word from the low half of the hash */
+  static constexpr std::array<uint32_t, WORDS_PER_BLOCK> SALTS = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU,
+                                                                  0xa2b7289dU, 0x705495c7U, 0x2df1424bU,
+                                                                  0x9efc4947U, 0x5c6bfb31U};
+
+  using Block = std::array<uint32_t, WORDS_PER_BLOCK>;
+
+  /** The caller's hash may spread short keys poorly, so mix it once more before using its bits */
+  static auto Mix(hash_t hash) -> uint64_t { return HashUtil::MixInt(hash); }
+
+  auto BlockIndex(hash_t hash) const -> size_t {
+    // the high half of the hash picks the block, scaled into range without a division
+    return static_cast<size_t>(((Mix(hash) >> 32) * blocks_.size()) >> 32);
+  }
+
+  static auto Masks(hash_t hash) -> Block {
+    const auto key = static_cast<uint32_t>(Mix(hash));
+    Block masks;
+    for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      masks[i] = 1U << ((key * SALTS[i]) >> 27);
+    }
+    return masks;
+  }
+
+  std::vector<Block> blocks_;
+  size_t capacity_;
+};
+
+}  // namespace bustub
@@ -25,6 +25,10 @@ namespace bustub {
 
 #define HASH_TABLE_INDEX_TYPE ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>
 
+/**
+ * A hash index over a DiskExtendibleHashTable. It only answers equality lookups (ScanKey, and ScanRange over a single
+ * key), each with a directory page and a bucket page access, and keeps no key order.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class ExtendibleHashTableIndex : public Index {
  public:
@@ -14,6 +14,8 @@
 
 #include <cstring>
 
+#include "common/macros.h"
+#include "common/rid.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -35,22 +37,41 @@ class GenericKey {
     memcpy(data_, tuple.GetData(), tuple.GetLength());
   }
 
+  /**
+   * Store a RID right after the key columns. Non-unique indexes suffix every key with the RID of its tuple, so
+   * duplicate column values still form distinct keys (see GenericComparator).
+   */
+  inline void SetRid(const RID &rid, uint32_t offset) {
+    BUSTUB_ASSERT(offset + sizeof(RID) <= KeySize, "no room for the RID suffix");
+    memcpy(data_ + offset, &rid, sizeof(RID));
+  }
+
+  inline auto GetRid(uint32_t offset) const -> RID {
+    RID rid;
+    memcpy(&rid, data_ + offset, sizeof(RID));
+    return rid;
+  }
+
   // NOTE: for test purpose only
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
     memcpy(data_, &key, sizeof(int64_t));
   }
 
-  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
+  /**
+   * @param schema the schema of the columns stored at `base` (the key columns at 0, or e.g. included columns further
+   * back)
+   */
+  inline auto ToValue(Schema *schema, uint32_t column_idx, uint32_t base = 0) const -> Value {
     const char *data_ptr;
     const auto &col = schema->GetColumn(column_idx);
     const TypeId column_type = col.GetType();
     const bool is_inlined = col.IsInlined();
     if (is_inlined) {
-      data_ptr = (data_ + col.GetOffset());
+      data_ptr = (data_ + base + col.GetOffset());
     } else {
-      int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + col.GetOffset()));
-      data_ptr = (data_ + offset);
+      int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + base + col.GetOffset()));
+      data_ptr = (data_ + base + offset);
     }
     return Value::DeserializeFrom(data_ptr, column_type);
   }
@@ -90,17 +111,59 @@ class GenericComparator {
         return 1;
       }
     }
+    if (rid_offset_ >= 0) {
+      // equal columns, order by the RID suffix
+      const RID lhs_rid = lhs.GetRid(rid_offset_);
+      const RID rhs_rid = rhs.GetRid(rid_offset_);
+      if (lhs_rid.GetPageId() != rhs_rid.GetPageId()) {
+        return lhs_rid.GetPageId() < rhs_rid.GetPageId() ? -1 : 1;
+      }
+      if (lhs_rid.GetSlotNum() != rhs_rid.GetSlotNum()) {
+        return lhs_rid.GetSlotNum() < rhs_rid.GetSlotNum() ? -1 : 1;
+      }
+    }
     // equals
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_},
+        integer_key_width_{other.integer_key_width_},
+        rid_offset_{other.rid_offset_} {}
+
+  /**
+   * @param key_schema schema of the key columns
+   * @param rid_suffix whether keys carry the RID of their tuple after the columns (non-unique indexes), which then
+   * breaks ties between equal column values
+   */
+  explicit GenericComparator(Schema *key_schema, bool rid_suffix = false) : key_schema_(key_schema) {
+    if (rid_suffix) {
+      BUSTUB_ASSERT(key_schema_->GetLength() + sizeof(RID) <= KeySize, "no room for the RID suffix");
+      rid_offset_ = static_cast<int>(key_schema_->GetLength());
+    }
+    // a single INTEGER / BIGINT column is stored at offset 0 of the key, so such keys can be compared as raw
+    // integers (see storage/index/key_search.h)
+    if (key_schema_ != nullptr && key_schema_->GetColumnCount() == 1) {
+      const auto type = key_schema_->GetColumn(0).GetType();
+      if (type == TypeId::INTEGER && KeySize >= sizeof(int32_t)) {
+        integer_key_width_ = sizeof(int32_t);
+      } else if (type == TypeId::BIGINT && KeySize >= sizeof(int64_t)) {
+        integer_key_width_ = sizeof(int64_t);
+      }
+    }
+  }
+
+  /** @return byte width of the key if it is a single integer column, 0 otherwise */
+  inline auto GetIntegerKeyWidth() const -> int { return integer_key_width_; }
 
-  // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  /** @return true if keys are suffixed with a RID */
+  inline auto HasRidSuffix() const -> bool { return rid_offset_ >= 0; }
 
  private:
   Schema *key_schema_;
+  int integer_key_width_{0};
+  /** offset of the RID suffix inside the key, -1 if there is none */
+  int rid_offset_{-1};
 };
 
 }  // namespace bustub
@@ -12,12 +12,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -43,11 +45,21 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param is_unique Whether the index holds at most one entry per key
+   * @param include_attrs The base table columns stored in each entry besides the key (CREATE INDEX ... INCLUDE)
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, bool is_unique = true, std::vector<uint32_t> include_attrs = {})
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        is_unique_(is_unique),
+        include_attrs_(std::move(include_attrs)) {
     key_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, key_attrs_));
+    include_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, include_attrs_));
+    entry_attrs_ = key_attrs_;
+    entry_attrs_.insert(entry_attrs_.end(), include_attrs_.begin(), include_attrs_.end());
+    entry_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, entry_attrs_));
   }
 
   ~IndexMetadata() = default;
@@ -72,6 +84,21 @@ class IndexMetadata {
   /** @return The mapping relation between indexed columns and base table columns */
   inline auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
 
+  /** @return Whether the index holds at most one entry per key; otherwise several tuples may share a key */
+  inline auto IsUnique() const -> bool { return is_unique_; }
+
+  /** @return The base table columns stored in each entry besides the key, not used for ordering */
+  inline auto GetIncludeAttrs() const -> const std::vector<uint32_t> & { return include_attrs_; }
+
+  /** @return A schema object pointer that represents the included columns */
+  inline auto GetIncludeSchema() const -> Schema * { return include_schema_.get(); }
+
+  /** @return The base table columns of a whole entry: the key columns followed by the included columns */
+  inline auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return entry_attrs_; }
+
+  /** @return A schema object pointer that represents a whole entry, the same as the key schema without INCLUDE */
+  inline auto GetEntrySchema() const -> Schema * { return entry_schema_.get(); }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -79,8 +106,12 @@ class IndexMetadata {
     os << "IndexMetadata["
        << "Name = " << name_ << ", "
        << "Type = B+Tree, "
+       << "Unique = " << (is_unique_ ? "true" : "false") << ", "
        << "Table name = " << table_name_ << "] :: ";
     os << key_schema_->ToString();
+    if (!include_attrs_.empty()) {
+      os << " INCLUDE " << include_schema_->ToString();
+    }
 
     return os.str();
   }
@@ -92,8 +123,76 @@ class IndexMetadata {
   std::string table_name_;
   /** The mapping relation between key schema and tuple schema */
   const std::vector<uint32_t> key_attrs_;
+  /** Whether the index holds at most one entry per key */
+  const bool is_unique_;
   /** The schema of the indexed key */
   std::shared_ptr<Schema> key_schema_;
+  /** The mapping relation between included columns and tuple schema */
+  const std::vector<uint32_t> include_attrs_;
+  /** The schema of the included columns */
+  std::shared_ptr<Schema> include_schema_;
+  /** key_attrs_ followed by include_attrs_ */
+  std::vector<uint32_t> entry_attrs_;
+  /** The schema of key and included columns together */
+  std::shared_ptr<Schema> entry_schema_;
+};
+
+/** Which ends of an index range scan include their bound key */
+struct RangeInclusivity {
+  bool low_inclusive_{true};
+  bool high_inclusive_{true};
+};
+
+/** The order in which a range scan visits keys */
+enum class ScanDirection { FORWARD, BACKWARD };
+
+/**
+ * class IndexRangeScan - An open range scan over an index (see Index::ScanRange)
+ *
+ * The scan hands out the RIDs of the range in key order (or reverse key order), a bounded batch at a time, so that a caller never has to
+ * materialize the whole range. Between two batches the scan holds on to as little of the index as possible.
+ */
+class IndexRangeScan {
+ public:
+  virtual ~IndexRangeScan() = default;
+
+  /**
+   * Fetch the next batch of the range.
+   * @param[out] result Cleared, then filled with the next (at most batch_size) RIDs in scan order
+   * @return false if the range is exhausted, in which case result is empty
+   */
+  virtual auto NextBatch(std::vector<RID> *result) -> bool = 0;
+
+  /**
+   * Fetch the next batch of the range together with the entries themselves, so that an index-only scan never has
+   * to read the table.
+   * @param[out] result As for NextBatch
+   * @param[out] entries Cleared, then filled with one tuple over Index::GetEntrySchema per RID
+   * @return false if the range is exhausted, in which case both outputs are empty
+   */
+  virtual auto NextEntryBatch(std::vector<RID> *result, std::vector<Tuple> *entries) -> bool {
+    throw NotImplementedException("index-only scan is not supported by this index");
+  }
+};
+
+/**
+ * class MaterializedRangeScan - A range scan over RIDs collected up front, e.g. all entries of a single key
+ */
+class MaterializedRangeScan : public IndexRangeScan {
+ public:
+  MaterializedRangeScan(std::vector<RID> rids, size_t batch_size) : rids_(std::move(rids)), batch_size_(batch_size) {}
+
+  auto NextBatch(std::vector<RID> *result) -> bool override {
+    auto end = rids_.begin() + std::min(rids_.size(), next_ + batch_size_);
+    result->assign(rids_.begin() + next_, end);
+    next_ = end - rids_.begin();
+    return !result->empty();
+  }
+
+ private:
+  std::vector<RID> rids_;
+  size_t batch_size_;
+  size_t next_{0};
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -139,6 +238,18 @@ class Index {
   /** @return The index key attributes */
   auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetKeyAttrs(); }
 
+  /** @return Whether the index holds at most one entry per key */
+  auto IsUnique() const -> bool { return metadata_->IsUnique(); }
+
+  /** @return The base table columns stored in each entry besides the key */
+  auto GetIncludeAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetIncludeAttrs(); }
+
+  /** @return The schema of a whole entry, key columns followed by included columns */
+  auto GetEntrySchema() const -> Schema * { return metadata_->GetEntrySchema(); }
+
+  /** @return The base table columns of a whole entry */
+  auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetEntryAttrs(); }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -153,16 +264,27 @@ class Index {
 
   /**
    * Insert an entry into the index.
-   * @param key The index key
-   * @param rid The RID associated with the key (unused)
+   * @param key The index key, which must carry the included columns as well (a tuple over GetEntrySchema)
+   * @param rid The RID associated with the key (also part of the entry in a non-unique index)
    * @param transaction The transaction context
    */
   virtual void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
 
+  /**
+   * Insert a batch of entries, e.g. when building the index over an existing table.
+   * @param entries The (index key, RID) pairs, in any order; keys carry the included columns as for InsertEntry
+   * @param transaction The transaction context
+   */
+  virtual void InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+    for (const auto &[key, rid] : entries) {
+      InsertEntry(key, rid, transaction);
+    }
+  }
+
   /**
    * Delete an index entry by key.
    * @param key The index key
-   * @param rid The RID associated with the key (unused)
+   * @param rid The RID associated with the key (selects the entry to delete in a non-unique index)
    * @param transaction The transaction context
    */
   virtual void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
@@ -170,12 +292,60 @@ class Index {
   /**
    * Search the index for the provided key.
    * @param key The index key
-   * @param result The collection of RIDs that is populated with results of the search
+   * @param result The collection of RIDs the results of the search are appended to, all of the tuples with this
+   * key for a non-unique index
    * @param transaction The transaction context
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /**
+   * Search the index for a batch of keys, e.g. the join keys of a batch of outer tuples.
+   * @param keys The index keys, in any order and possibly repeated
+   * @param[out] results Resized to keys.size(); (*results)[i] holds the RIDs found for keys[i]
+   * @param transaction The transaction context
+   */
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                        Transaction *transaction) {
+    results->assign(keys.size(), {});
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*results)[i], transaction);
+    }
+  }
+
+  /**
+   * Open a scan over all entries whose key lies between `low` and `high`, in key order.
+   * @param low The lower bound key, or nullptr for a scan from the smallest key
+   * @param high The upper bound key, or nullptr for a scan to the largest key
+   * @param inclusivity Whether each bound itself belongs to the range
+   * @param direction FORWARD to scan in ascending key order, BACKWARD in descending order
+   * @param batch_size The maximum number of RIDs returned by one IndexRangeScan::NextBatch
+   * @param transaction The transaction context
+   * @return The open scan
+   */
+  virtual auto ScanRange(const Tuple *low, const Tuple *high, RangeInclusivity inclusivity, ScanDirection direction,
+                         size_t batch_size, Transaction *transaction) -> std::unique_ptr<IndexRangeScan> {
+    // An index without key order (e.g. a hash index) still serves a range that holds a single key
+    if (low != nullptr && high != nullptr && inclusivity.low_inclusive_ && inclusivity.high_inclusive_ &&
+        IsSameKey(*low, *high)) {
+      std::vector<RID> rids;
+      ScanKey(*low, &rids, transaction);
+      return std::make_unique<MaterializedRangeScan>(std::move(rids), batch_size);
+    }
+    throw NotImplementedException("range scan is not supported by this index");
+  }
+
  private:
+  /** @return true if both tuples over the key schema hold the same key */
+  auto IsSameKey(const Tuple &lhs, const Tuple &rhs) const -> bool {
+    const auto *key_schema = GetKeySchema();
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      if (lhs.GetValue(key_schema, i).CompareEquals(rhs.GetValue(key_schema, i)) != CmpBool::CmpTrue) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
 };
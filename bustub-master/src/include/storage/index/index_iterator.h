@@ -27,25 +27,33 @@ class IndexIterator {
   IndexIterator(B_PLUS_TREE_LEAF_PAGE_TYPE *start, int index, BufferPoolManager *buf);
   ~IndexIterator();  // NOLINT
 
+  // 迭代器持有当前叶子页的pin，只能移动不能拷贝
+  IndexIterator(const IndexIterator &) = delete;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
+  IndexIterator(IndexIterator &&other) noexcept;
+  auto operator=(IndexIterator &&other) noexcept -> IndexIterator &;
+
   auto IsEnd() -> bool;
 
   auto operator*() -> const MappingType &;
 
   auto operator++() -> IndexIterator &;
 
+  // 反向移动，越过第一个元素后变成End()
+  auto operator--() -> IndexIterator &;
+
   auto operator==(const IndexIterator &itr) const -> bool {
     return (leaf_page_ == itr.leaf_page_) && (index_ == itr.index_);
   }
 
-  auto operator!=(const IndexIterator &itr) const -> bool {
-    return (leaf_page_ != itr.leaf_page_) && (index_ != itr.index_);
-  }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
   // add your own private member variables here
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page_;
-  BufferPoolManager *buf_;
-  int index_;  // 用来在page里移动
+  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page_{nullptr};
+  BufferPoolManager *buf_{nullptr};
+  int index_{-1};  // 用来在page里移动
+  MappingType item_;  // 叶子页里key和value分开存放，解引用时拼成pair
 };
 
 }  // namespace bustub
@@ -0,0 +1,187 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_search.h
+//
+// Identification: src/include/storage/index/key_search.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace bustub {
+
+/**
+ * Intra-node search helpers for B+ tree pages.
+ *
+ * Pages keep their keys in one contiguous array, so when the key comparator reports that a key is a
+ * single INTEGER / BIGINT column (see GenericComparator::GetIntegerKeyWidth) the search runs directly
+ * over the raw integers: a branchless binary search narrows the range down to a small window, and the
+ * window is finished with a SIMD count of "keys before the target". Every other key type falls back to
+ * a plain binary search through the comparator.
+ */
+namespace key_search {
+
+/** Once the candidate range is this small, count it linearly instead of halving it further. */
+static constexpr int WINDOW_SIZE = 16;
+
+/** Load the integer stored at the front of a key. Keys in a page are not necessarily aligned. */
+template <typename IntType>
+inline auto LoadInt(const char *ptr) -> IntType {
+  IntType value;
+  memcpy(&value, ptr, sizeof(IntType));
+  return value;
+}
+
+/** @return true if `value` sorts before `target`, i.e. `value < target` (or `value <= target` for UPPER) */
+template <typename IntType, bool UPPER>
+inline auto Before(IntType value, IntType target) -> bool {
+  return UPPER ? value <= target : value < target;
+}
+
+/** Count how many of the `n` keys starting at `keys` sort before `target`. */
+template <typename IntType, bool UPPER>
+inline auto CountBefore(const char *keys, size_t stride, int n, IntType target) -> int {
+  int count = 0;
+  int i = 0;
+  if (stride == sizeof(IntType)) {
+#if defined(__AVX2__)
+    if constexpr (sizeof(IntType) == 4) {
+      const __m256i target_vec = _mm256_set1_epi32(target);
+      for (; i + 8 <= n; i += 8) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * stride));
+        // lanes where data > target never sort before it
+        __m256i after = UPPER ? _mm256_cmpgt_epi32(data, target_vec) : _mm256_cmpgt_epi32(target_vec, data);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(after));
+        count += UPPER ? 8 - __builtin_popcount(mask) : __builtin_popcount(mask);
+      }
+    } else {
+      const __m256i target_vec = _mm256_set1_epi64x(target);
+      for (; i + 4 <= n; i += 4) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i * stride));
+        __m256i after = UPPER ? _mm256_cmpgt_epi64(data, target_vec) : _mm256_cmpgt_epi64(target_vec, data);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(after));
+        count += UPPER ? 4 - __builtin_popcount(mask) : __builtin_popcount(mask);
+      }
+    }
+#elif defined(__SSE2__)
+    if constexpr (sizeof(IntType) == 4) {
+      const __m128i target_vec = _mm_set1_epi32(target);
+      for (; i + 4 <= n; i += 4) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i * stride));
+        __m128i after = UPPER ? _mm_cmpgt_epi32(data, target_vec) : _mm_cmpgt_epi32(target_vec, data);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(after));
+        count += UPPER ? 4 - __builtin_popcount(mask) : __builtin_popcount(mask);
+      }
+    }
+#if defined(__SSE4_2__)
+    if constexpr (sizeof(IntType) == 8) {
+      const __m128i target_vec = _mm_set1_epi64x(target);
+      for (; i + 2 <= n; i += 2) {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i * stride));
+        __m128i after = UPPER ? _mm_cmpgt_epi64(data, target_vec) : _mm_cmpgt_epi64(target_vec, data);
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(after));
+        count += UPPER ? 2 - __builtin_popcount(mask) : __builtin_popcount(mask);
+      }
+    }
+#endif
+#endif
+  }
+  // scalar tail (and the whole window for strided keys or when no SIMD is available)
+  for (; i < n; i++) {
+    count += static_cast<int>(Before<IntType, UPPER>(LoadInt<IntType>(keys + i * stride), target));
+  }
+  return count;
+}
+
+/**
+ * Branchless search over `n` sorted integer keys laid out `stride` bytes apart.
+ * @return index of the first key >= target (or > target for UPPER), in [0, n]
+ */
+template <typename IntType, bool UPPER>
+inline auto IntegerBound(const char *keys, size_t stride, int n, IntType target) -> int {
+  const char *base = keys;
+  // invariant: the answer lies in [base, base + n]
+  while (n > WINDOW_SIZE) {
+    int half = n / 2;
+    bool go_right = Before<IntType, UPPER>(LoadInt<IntType>(base + half * stride), target);
+    base += go_right ? half * stride : 0;
+    n -= half;
+  }
+  return static_cast<int>((base - keys) / stride) + CountBefore<IntType, UPPER>(base, stride, n, target);
+}
+
+/**
+ * Fallback binary search through the comparator.
+ * @return index of the first key >= target (or > target for UPPER), in [0, n]
+ */
+template <bool UPPER, typename KeyType, typename KeyComparator>
+inline auto ComparatorBound(const KeyType *keys, int n, const KeyType &target, const KeyComparator &cmp) -> int {
+  int st = 0;
+  int ed = n;
+  while (st < ed) {
+    int mid = (ed - st) / 2 + st;
+    int res = cmp(keys[mid], target);
+    if (UPPER ? res <= 0 : res < 0) {
+      st = mid + 1;
+    } else {
+      ed = mid;
+    }
+  }
+  return st;
+}
+
+/**
+ * Search keys whose leading column is a raw integer. Keys suffixed with a RID (non-unique indexes) are ordered by
+ * the RID among equal integers, so the integer search only narrows the run of equal integers and the comparator
+ * finishes inside it.
+ */
+template <bool UPPER, typename IntType, typename KeyType, typename KeyComparator>
+inline auto IntegerKeyBound(const KeyType *keys, int n, const KeyType &target, const KeyComparator &cmp) -> int {
+  const auto *raw = reinterpret_cast<const char *>(keys);
+  const auto int_target = LoadInt<IntType>(reinterpret_cast<const char *>(&target));
+  if (!cmp.HasRidSuffix()) {
+    return IntegerBound<IntType, UPPER>(raw, sizeof(KeyType), n, int_target);
+  }
+  int lo = IntegerBound<IntType, false>(raw, sizeof(KeyType), n, int_target);
+  int len = IntegerBound<IntType, true>(raw + lo * sizeof(KeyType), sizeof(KeyType), n - lo, int_target);
+  return lo + ComparatorBound<UPPER>(keys + lo, len, target, cmp);
+}
+
+template <bool UPPER, typename KeyType, typename KeyComparator>
+inline auto Bound(const KeyType *keys, int n, const KeyType &target, const KeyComparator &cmp) -> int {
+  switch (cmp.GetIntegerKeyWidth()) {
+    case sizeof(int32_t):
+      return IntegerKeyBound<UPPER, int32_t>(keys, n, target, cmp);
+    case sizeof(int64_t):
+      return IntegerKeyBound<UPPER, int64_t>(keys, n, target, cmp);
+    default:
+      return ComparatorBound<UPPER>(keys, n, target, cmp);
+  }
+}
+
+}  // namespace key_search
+
+/** @return index of the first of the `n` sorted keys that is >= target */
+template <typename KeyType, typename KeyComparator>
+inline auto KeyLowerBound(const KeyType *keys, int n, const KeyType &target, const KeyComparator &cmp) -> int {
+  return key_search::Bound<false>(keys, n, target, cmp);
+}
+
+/** @return index of the first of the `n` sorted keys that is > target */
+template <typename KeyType, typename KeyComparator>
+inline auto KeyUpperBound(const KeyType *keys, int n, const KeyType &target, const KeyComparator &cmp) -> int {
+  return key_search::Bound<true>(keys, n, target, cmp);
+}
+
+}  // namespace bustub
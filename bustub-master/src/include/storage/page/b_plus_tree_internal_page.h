@@ -12,13 +12,17 @@
 
 #include <queue>
 
+#include "storage/index/key_search.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE 20
+// number of key/child slots that fit behind the header
+#define INTERNAL_PAGE_SLOT_CNT ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(KeyType) + sizeof(ValueType)))
+// an internal page holds one entry more than its max size right before it splits
+#define INTERNAL_PAGE_SIZE (INTERNAL_PAGE_SLOT_CNT - 1)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -27,9 +31,10 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
+ * Internal page format (keys are stored in increasing order, keys and child
+ * pointers in two separate arrays):
  *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ * | HEADER | KEY(1) | KEY(2) | ... | KEY(n) | PAGE_ID(1) | ... | PAGE_ID(n) |
  *  --------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
@@ -37,7 +42,7 @@ class BPlusTreeInternalPage : public BPlusTreePage {
  public:
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   // must call initialize method after "create" a new node
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
+  void Init(page_id_t page_id, int max_size = INTERNAL_PAGE_SIZE);
 
   auto KeyAt(int index) const -> KeyType;
   void SetKeyAt(int index, const KeyType &key);
@@ -49,15 +54,19 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   void InsertFirstInit(const ValueType &old_page_id, const ValueType &new_page_id, const KeyType &key);
   auto InsertKeyAfterIt(const ValueType &left_page_id, const ValueType &right_page_id, KeyComparator &cmp,
                         const KeyType &key) -> int;
-  void SplitDataTo(B_PLUS_TREE_INTERNAL_PAGE_TYPE *right_page, BufferPoolManager *buf);
+  // keep the first left_size children and move the rest into right_page; children keep no parent pointer, so
+  // they are not touched
+  void SplitDataTo(B_PLUS_TREE_INTERNAL_PAGE_TYPE *right_page, int left_size);
   auto ChangeRoot() -> ValueType;
-  void MergeWith(BPlusTreePage *other_page_, int index_of_parent, BufferPoolManager *buf);
+  // append all entries of the right sibling, pulling the separator key down from the parent
+  void MergeWith(BPlusTreeInternalPage *other_page, const KeyType &middle_key);
   auto DeleteInternal(int index) -> int;
-  void MoveLastToFrontOf(BPlusTreeInternalPage *other_page, BufferPoolManager *buf);
-  void MoveFrontToLastOf(BPlusTreeInternalPage *other_page, BufferPoolManager *buf);
+  // rotate one child through the parent, index is the parent slot pointing at the right one of the two pages
+  void MoveLastToFrontOf(BPlusTreeInternalPage *other_page, BPlusTreeInternalPage *parent_page, int index);
+  void MoveFrontToLastOf(BPlusTreeInternalPage *other_page, BPlusTreeInternalPage *parent_page, int index);
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[1];
+  KeyType keys_[INTERNAL_PAGE_SLOT_CNT];
+  ValueType values_[INTERNAL_PAGE_SLOT_CNT];
 };
 }  // namespace bustub
@@ -13,61 +13,75 @@
 #include <utility>
 #include <vector>
 
+#include "storage/index/key_search.h"
+#include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+// number of key/value slots that fit behind the header
+#define LEAF_PAGE_SLOT_CNT ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (sizeof(KeyType) + sizeof(ValueType)))
+#define LEAF_PAGE_SIZE LEAF_PAGE_SLOT_CNT
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
- * Leaf page format (keys are stored in order):
+ * Leaf page format (keys are stored in order). Keys and values live in two
+ * separate arrays so that a lookup only scans densely packed keys:
  *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ * | HEADER | KEY(1) | KEY(2) | ... | KEY(n) | RID(1) | RID(2) | ... | RID(n)
  *  ----------------------------------------------------------------------
  *
  *  Header format (size in byte, 28 bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  ----------------------------------------------
+ * | PageId (4) | NextPageId (4) | PrevPageId (4)
+ *  ----------------------------------------------
+ *
+ * Leaves form a doubly linked list in key order, so that the index can be
+ * scanned backwards as well.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
+  void Init(page_id_t page_id, int max_size = LEAF_PAGE_SIZE);
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
   auto KeyAt(int index) const -> KeyType;
   void SetKeyAt(int index, const KeyType &key);
   void SetValueAt(int index, const ValueType &value);
+  auto ValueAt(int index) const -> ValueType;
   auto FindKey(const KeyType &key, ValueType &value, KeyComparator &cmp) -> bool;
   auto FindValueIndex(const ValueType &value) -> int;
-  auto FindKeyIndex(const KeyType &key, KeyComparator &cmp) -> int;
+  // index of the first key >= key, GetSize() if there is none
+  auto FindKeyIndex(const KeyType &key, const KeyComparator &cmp) const -> int;
   auto Insert(const KeyType &key, const ValueType &value, KeyComparator &cmp) -> int;
-  void SplitDataTo(B_PLUS_TREE_LEAF_PAGE_TYPE *new_leaf_page, BufferPoolManager *buf);
+  // keep the first left_size entries and move the rest into new_leaf_page
+  void SplitDataTo(B_PLUS_TREE_LEAF_PAGE_TYPE *new_leaf_page, int left_size);
   auto Delete(const KeyType &key, KeyComparator &cmp) -> int;
-  void MergeWith(BPlusTreePage *other_page_, int index_of_parent, BufferPoolManager *buf);
-  void MoveLastToFrontOf(BPlusTreeLeafPage *other_page, BufferPoolManager *buf);
-  void MoveFrontToLastOf(BPlusTreeLeafPage *other_page, BufferPoolManager *buf);
-  auto GetPair(int index) -> MappingType &;
-
- private:
-  auto FindkeyIndex(const KeyType &key, KeyComparator &cmp) -> int;
+  // append all entries of the right sibling and take over its next page id (the caller relinks the next leaf)
+  void MergeWith(BPlusTreeLeafPage *other_page);
+  // move one entry to a sibling, index is the parent slot pointing at the right one of the two pages
+  void MoveLastToFrontOf(BPlusTreeLeafPage *other_page, InternalPage *parent_page, int index);
+  void MoveFrontToLastOf(BPlusTreeLeafPage *other_page, InternalPage *parent_page, int index);
+  auto GetPair(int index) const -> MappingType;
 
  private:
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[1];
+  page_id_t prev_page_id_;
+  KeyType keys_[LEAF_PAGE_SLOT_CNT];
+  ValueType values_[LEAF_PAGE_SLOT_CNT];
 };
 }  // namespace bustub
@@ -14,6 +14,7 @@
 #include <climits>
 #include <cstdlib>
 #include <string>
+#include <type_traits>
 
 #include "buffer/buffer_pool_manager.h"
 #include "storage/index/generic_key.h"
@@ -33,18 +34,23 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * It actually serves as a header part for each B+ tree page and
  * contains information shared by both leaf page and internal page.
  *
- * Header format (size in byte, 24 bytes in total):
- * ----------------------------------------------------------------------------
- * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ * Pages are never constructed: the classes are laid over the raw bytes of
+ * Page::GetData(). They must therefore stay free of virtual functions, so the
+ * on-disk layout is exactly the members below on every compiler.
+ *
+ * Pages do not store a pointer to their parent. Operations that need the
+ * ancestors of a page (split / merge / redistribute) remember the pages they
+ * passed on the way down from the root instead.
+ *
+ * Header format (size in byte, 20 bytes in total):
  * ----------------------------------------------------------------------------
- * | ParentPageId (4) | PageId(4) |
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | PageId(4) |
  * ----------------------------------------------------------------------------
  */
 class BPlusTreePage {
  public:
-  explicit BPlusTreePage(page_id_t page_id, page_id_t parent_page_id, int max_size, int size = 0);
+  explicit BPlusTreePage(page_id_t page_id, int max_size, int size = 0);
   auto IsLeafPage() const -> bool;
-  auto IsRootPage() const -> bool;
   void SetPageType(IndexPageType page_type);
 
   auto GetSize() const -> int;
@@ -55,22 +61,22 @@ class BPlusTreePage {
   void SetMaxSize(int max_size);
   auto GetMinSize() const -> int;
 
-  auto GetParentPageId() const -> page_id_t;
-  void SetParentPageId(page_id_t parent_page_id);
-
   auto GetPageId() const -> page_id_t;
   void SetPageId(page_id_t page_id);
 
   void SetLSN(lsn_t lsn = INVALID_LSN);
-  virtual ~BPlusTreePage() = default;
+
  protected:
   // member variable, attributes that both internal and leaf page share __attribute__((__unused__))
   IndexPageType page_type_;
   lsn_t lsn_;
   int size_;
   int max_size_;
-  page_id_t parent_page_id_;
   page_id_t page_id_;
 };
 
+static_assert(std::is_standard_layout_v<BPlusTreePage> && !std::is_polymorphic_v<BPlusTreePage>,
+              "b+ tree pages are overlaid on raw page data");
+static_assert(sizeof(BPlusTreePage) == 20, "b+ tree page header must match the documented 20 bytes");
+
 }  // namespace bustub
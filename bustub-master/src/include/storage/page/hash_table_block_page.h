@@ -77,6 +77,14 @@ class HashTableBlockPage {
    */
   void Remove(slot_offset_t bucket_ind);
 
+  /**
+   * Marks an index as never occupied again, so that it ends probe sequences. Used by deletions that shift the
+   * following entries back instead of leaving a tombstone, and before overwriting an index.
+   *
+   * @param bucket_ind index to clear
+   */
+  void Clear(slot_offset_t bucket_ind);
+
   /**
    * Returns whether or not an index is occupied (key/value pair or tombstone)
    *
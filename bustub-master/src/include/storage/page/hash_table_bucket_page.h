@@ -33,6 +33,11 @@ namespace bustub {
  *  The above format omits the space required for the occupied_ and
  *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
  *
+ *  Every slot also has a one-byte fingerprint of its key, in the style of
+ *  SwissTable control bytes. A probe compares the fingerprints of
+ *  BUCKET_GROUP_SIZE slots at once, masks the result with the readable_
+ *  bits of the group, and compares full keys only on the few matches.
+ *
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
@@ -138,10 +143,21 @@ class HashTableBucketPage {
   void PrintBucket();
 
  private:
+  /** @return the fingerprint of a key; 8 bits of a hash over the key bytes */
+  static auto Fingerprint(const KeyType &key) -> uint8_t;
+
+  /** @return the bits of an occupied_ / readable_ bitmap for the slots of a group, bit i for the group's slot i */
+  static auto GroupBits(const char *bitmap, uint32_t group) -> uint32_t;
+
+  /** @return a bit per slot of the group whose fingerprint equals `fingerprint` */
+  auto MatchFingerprint(uint32_t group, uint8_t fingerprint) const -> uint32_t;
+
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
-  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  char occupied_[BUCKET_GROUP_COUNT * BUCKET_GROUP_SIZE / 8];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  char readable_[BUCKET_GROUP_COUNT * BUCKET_GROUP_SIZE / 8];
+  // Fingerprint of the key in each slot, meaningful only while the slot is readable.
+  uint8_t fingerprints_[BUCKET_GROUP_COUNT * BUCKET_GROUP_SIZE];
   // Flexible array member for page data.
   MappingType array_[1];
 };
@@ -35,10 +35,17 @@
 
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hash index bucket page.
- * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
- * of search, insertion, removal, and helper methods.
+ * Besides the occupied_ and readable_ bits, a bucket keeps a one-byte fingerprint per pair, so each pair costs
+ * sizeof(MappingType) + 1.25 bytes. The arrays are padded to whole groups of BUCKET_GROUP_SIZE slots for SIMD probing,
+ * and 32 bytes of the page are set aside for that padding and the alignment of the pair array.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_ARRAY_SIZE (4 * (BUSTUB_PAGE_SIZE - 32) / (4 * sizeof(MappingType) + 5))
+
+/** Slots a bucket page probes with one SIMD comparison of their fingerprints. */
+#define BUCKET_GROUP_SIZE 16
+
+/** The number of slot groups in a bucket page. */
+#define BUCKET_GROUP_COUNT ((BUCKET_ARRAY_SIZE + BUCKET_GROUP_SIZE - 1) / BUCKET_GROUP_SIZE)
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
@@ -123,6 +123,14 @@ class TablePage : public Page {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool;
 
+  /**
+   * Point a tuple at the data of a tuple of this page in place, without copying it or locking it.
+   * @param rid rid of the tuple to look at
+   * @param[out] view the tuple, valid only while the page stays pinned and latched
+   * @return true if the tuple exists
+   */
+  auto PeekTuple(const RID &rid, Tuple *view) -> bool;
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -21,16 +21,55 @@ namespace bustub {
 class TmpTuplePage : public Page {
  public:
   void Init(page_id_t page_id, uint32_t page_size) {
-    memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    memcpy(GetData() + OFFSET_PAGE_ID, &page_id, sizeof(page_id_t));
+    SetFreeSpacePointer(page_size);
   }
 
-  auto GetTablePageId() -> page_id_t { return INVALID_PAGE_ID; }
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PAGE_ID); }
 
-  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return false; }
+  /**
+   * Insert a tuple below the ones already in the page.
+   * @param tuple the tuple to insert
+   * @param[out] out where the tuple is stored
+   * @return false if the page has no room for the tuple
+   */
+  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool {
+    uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+    if (GetFreeSpacePointer() < SIZE_HEADER + size) {
+      return false;
+    }
+    uint32_t offset = GetFreeSpacePointer() - size;
+    tuple.SerializeTo(GetData() + offset);
+    SetFreeSpacePointer(offset);
+    *out = TmpTuple(GetTablePageId(), offset);
+    return true;
+  }
+
+  /** Read the tuple stored at `offset`, as returned by Insert(). */
+  void Get(size_t offset, Tuple *tuple) { tuple->DeserializeFrom(GetData() + offset); }
+
+  /**
+   * The tuples are packed against the end of the page, so they can be walked from the last inserted one, at
+   * GetFreeSpacePointer(), to the first, ending at BUSTUB_PAGE_SIZE.
+   * @return the offset of the tuple inserted before the one at `offset`
+   */
+  auto GetPrevOffset(size_t offset) -> size_t {
+    return offset + sizeof(uint32_t) + *reinterpret_cast<uint32_t *>(GetData() + offset);
+  }
+
+  /** @return the offset of the last inserted tuple, the page size if the page is empty */
+  auto GetFreeSpacePointer() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_PAGE_ID = 0;
+  static constexpr size_t OFFSET_FREE_SPACE = sizeof(page_id_t) + sizeof(lsn_t);
+  static constexpr size_t SIZE_HEADER = OFFSET_FREE_SPACE + sizeof(uint32_t);
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
@@ -12,6 +12,10 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>  // NOLINT
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -23,6 +27,10 @@ namespace bustub {
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * Next to the list the heap keeps a page directory, the ids of its pages in list order. Pages are only ever appended
+ * to the list, so an index into the directory always names the same page, and a scan can cut the directory into
+ * disjoint page ranges instead of following the list one page at a time.
  */
 class TableHeap {
   friend class TableIterator;
@@ -108,11 +116,31 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return a snapshot of the page directory; pages appended later are not in it */
+  auto GetPageIds() -> std::vector<page_id_t>;
+
+  /** @return the number of pages in the page directory */
+  auto GetNumPages() -> size_t;
+
+  /**
+   * Read every tuple of one page of the table, in slot order.
+   * @param page_id the page to read
+   * @param[out] tuples the tuples are appended here
+   * @param txn transaction performing the read
+   * @param keep if set, called on each tuple in place on the page; only the tuples it returns true for are copied
+   * @return false if the page could not be fetched
+   */
+  auto GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn,
+                     const std::function<bool(const Tuple &)> &keep = nullptr) -> bool;
+
  private:
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  /** The page directory, guarded by directory_latch_ */
+  std::vector<page_id_t> page_ids_;
+  std::mutex directory_latch_;
 };
 
 }  // namespace bustub
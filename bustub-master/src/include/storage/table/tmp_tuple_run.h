@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.h
+//
+// Identification: src/include/storage/table/tmp_tuple_run.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * A run of tuples an executor spills to disk, e.g. one partition of a grace hash join: an append-only sequence of
+ * TmpTuplePages allocated from the buffer pool. Only the page being appended to stays pinned, and the pages are
+ * deleted together with the run.
+ */
+class TmpTupleRun {
+ public:
+  explicit TmpTupleRun(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  ~TmpTupleRun();
+
+  TmpTupleRun(TmpTupleRun &&other) noexcept;
+  auto operator=(TmpTupleRun &&other) noexcept -> TmpTupleRun &;
+  TmpTupleRun(const TmpTupleRun &) = delete;
+  auto operator=(const TmpTupleRun &) -> TmpTupleRun & = delete;
+
+  /**
+   * Append a tuple to the run.
+   * @throws Exception if the buffer pool has no frame left for a new page
+   */
+  void Append(const Tuple &tuple);
+
+  /**
+   * Unpin the page being appended to, once the run is complete or while the caller waits for more input. A later
+   * Append() fetches the last page again and goes on filling it.
+   */
+  void Finish();
+
+  /** @return the number of tuples in the run */
+  auto GetNumTuples() const -> size_t { return num_tuples_; }
+
+  /** @return the number of bytes of tuple data in the run */
+  auto GetNumBytes() const -> size_t { return num_bytes_; }
+
+  /** @return the number of pages of the run */
+  auto GetNumPages() const -> size_t { return page_ids_.size(); }
+
+  /**
+   * Read the tuples of one page of the run, in the order they were appended.
+   * @param[out] tuples the tuples are appended here
+   */
+  void ReadPage(size_t page_index, std::vector<Tuple> *tuples);
+
+ private:
+  /** Unpin the tail page if it is pinned and delete every page */
+  void Release();
+
+  BufferPoolManager *bpm_;
+  std::vector<page_id_t> page_ids_;
+  /** The pinned page being appended to, nullptr before the first append and after Finish() */
+  TmpTuplePage *tail_{nullptr};
+  size_t num_tuples_{0};
+  size_t num_bytes_{0};
+};
+
+}  // namespace bustub
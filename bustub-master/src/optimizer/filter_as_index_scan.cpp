@@ -0,0 +1,171 @@
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Split `a AND b AND ...` into its conjuncts. */
+void SplitConjuncts(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts) {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get());
+      logic_expr != nullptr && logic_expr->logic_type_ == LogicType::And) {
+    SplitConjuncts(logic_expr->children_[0], conjuncts);
+    SplitConjuncts(logic_expr->children_[1], conjuncts);
+    return;
+  }
+  conjuncts->push_back(expr);
+}
+
+/** A conjunct of the form `column <op> constant`, with the column moved to the left. */
+struct ColumnBound {
+  uint32_t col_idx_;
+  ComparisonType comp_type_;
+  Value value_;
+};
+
+auto MatchColumnBound(const AbstractExpression &expr) -> std::optional<ColumnBound> {
+  const auto *cmp_expr = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (cmp_expr == nullptr || cmp_expr->comp_type_ == ComparisonType::NotEqual) {
+    return std::nullopt;
+  }
+  auto comp_type = cmp_expr->comp_type_;
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(cmp_expr->children_[0].get());
+  const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(cmp_expr->children_[1].get());
+  if (column_expr == nullptr && constant_expr == nullptr) {
+    // `constant <op> column`, flip it around
+    column_expr = dynamic_cast<const ColumnValueExpression *>(cmp_expr->children_[1].get());
+    constant_expr = dynamic_cast<const ConstantValueExpression *>(cmp_expr->children_[0].get());
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (column_expr == nullptr || constant_expr == nullptr || column_expr->GetTupleIdx() != 0 ||
+      constant_expr->val_.IsNull() || constant_expr->val_.GetTypeId() != column_expr->GetReturnType()) {
+    return std::nullopt;
+  }
+  return ColumnBound{column_expr->GetColIdx(), comp_type, constant_expr->val_};
+}
+
+/** Narrow one end of a range to `value`: keep the tighter bound, and on a tie the exclusive one. */
+void TightenBound(std::optional<Value> *bound, bool *inclusive, const Value &value, bool value_inclusive,
+                  bool is_low) {
+  if (!bound->has_value() ||
+      (is_low ? value.CompareGreaterThan(**bound) : value.CompareLessThan(**bound)) == CmpBool::CmpTrue) {
+    *bound = value;
+    *inclusive = value_inclusive;
+  } else if (value.CompareEquals(**bound) == CmpBool::CmpTrue) {
+    *inclusive = *inclusive && value_inclusive;
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeFilterAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeFilterAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::Filter) {
+    return optimized_plan;
+  }
+  const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+  BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "Filter with multiple children?? Impossible!");
+  const auto &child_plan = optimized_plan->children_[0];
+  if (child_plan->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+  if (seq_scan.filter_predicate_ != nullptr) {
+    return optimized_plan;
+  }
+
+  std::vector<AbstractExpressionRef> conjuncts;
+  SplitConjuncts(filter_plan.GetPredicate(), &conjuncts);
+
+  // Scan the index of the first column that is compared with a constant and has one. Only an equality can use a
+  // hash index.
+  std::optional<std::tuple<index_oid_t, std::string>> index;
+  uint32_t index_col_idx = 0;
+  for (const auto &conjunct : conjuncts) {
+    if (auto bound = MatchColumnBound(*conjunct); bound.has_value()) {
+      if (index = MatchIndex(seq_scan.table_name_, bound->col_idx_, bound->comp_type_ != ComparisonType::Equal);
+          index.has_value()) {
+        index_col_idx = bound->col_idx_;
+        break;
+      }
+    }
+  }
+  if (!index.has_value()) {
+    return optimized_plan;
+  }
+  const bool ordered = catalog_.GetIndex(std::get<0>(*index))->index_type_ == IndexType::BPlusTreeIndex;
+
+  // Every bound on that column becomes part of the key range, the other conjuncts stay in a filter
+  std::optional<Value> low_key;
+  std::optional<Value> high_key;
+  RangeInclusivity inclusivity;
+  std::vector<AbstractExpressionRef> residual;
+  for (const auto &conjunct : conjuncts) {
+    auto bound = MatchColumnBound(*conjunct);
+    if (!bound.has_value() || bound->col_idx_ != index_col_idx ||
+        (!ordered && (bound->comp_type_ != ComparisonType::Equal || low_key.has_value()))) {
+      // a hash index looks up a single key, everything else is checked on its results
+      residual.push_back(conjunct);
+      continue;
+    }
+    const auto comp_type = bound->comp_type_;
+    if (comp_type == ComparisonType::Equal || comp_type == ComparisonType::GreaterThan ||
+        comp_type == ComparisonType::GreaterThanOrEqual) {
+      TightenBound(&low_key, &inclusivity.low_inclusive_, bound->value_, comp_type != ComparisonType::GreaterThan,
+                   true);
+    }
+    if (comp_type == ComparisonType::Equal || comp_type == ComparisonType::LessThan ||
+        comp_type == ComparisonType::LessThanOrEqual) {
+      TightenBound(&high_key, &inclusivity.high_inclusive_, bound->value_, comp_type != ComparisonType::LessThan,
+                   false);
+    }
+  }
+
+  auto index_scan = std::make_shared<IndexScanPlanNode>(seq_scan.output_schema_, std::get<0>(*index),
+                                                        std::move(low_key), std::move(high_key), inclusivity);
+  if (residual.empty()) {
+    return index_scan;
+  }
+  auto predicate = residual[0];
+  for (size_t i = 1; i < residual.size(); i++) {
+    predicate = std::make_shared<LogicExpression>(std::move(predicate), residual[i], LogicType::And);
+  }
+  return std::make_shared<FilterPlanNode>(filter_plan.output_schema_, std::move(predicate), std::move(index_scan));
+}
+
+}  // namespace bustub
@@ -0,0 +1,87 @@
+#include <memory>
+
+#include "binder/bound_order_by.h"
+#include "catalog/catalog.h"
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::IsOrderedBy(const AbstractPlanNode &plan, uint32_t col_idx) -> bool {
+  switch (plan.GetType()) {
+    case PlanType::Sort: {
+      const auto &order_bys = dynamic_cast<const SortPlanNode &>(plan).GetOrderBy();
+      if (order_bys.empty() || order_bys[0].first == OrderByType::DESC) {
+        return false;
+      }
+      const auto *column = dynamic_cast<const ColumnValueExpression *>(order_bys[0].second.get());
+      return column != nullptr && column->GetColIdx() == col_idx;
+    }
+    case PlanType::IndexScan: {
+      // The first key column of a B+ tree index comes out in order, forward scans ascending
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(plan);
+      const auto *index = catalog_.GetIndex(index_scan.GetIndexOid());
+      const auto *table_info = catalog_.GetTable(index->table_name_);
+      return index->index_type_ == IndexType::BPlusTreeIndex && index_scan.direction_ == ScanDirection::FORWARD &&
+             index->key_schema_.GetColumn(0).GetName() == table_info->schema_.GetColumn(col_idx).GetName();
+    }
+    case PlanType::Filter:
+    case PlanType::Limit:
+      return IsOrderedBy(*plan.GetChildAt(0), col_idx);
+    case PlanType::Projection: {
+      const auto &expr = dynamic_cast<const ProjectionPlanNode &>(plan).GetExpressions()[col_idx];
+      const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      return column != nullptr && IsOrderedBy(*plan.GetChildAt(0), column->GetColIdx());
+    }
+    case PlanType::MergeJoin: {
+      // A merge join keeps the order of its left input; in an INNER join the right key is equal to the left one
+      const auto &join = dynamic_cast<const MergeJoinPlanNode &>(plan);
+      auto left_column_cnt = join.GetLeftPlan()->OutputSchema().GetColumnCount();
+      const auto *left_key = dynamic_cast<const ColumnValueExpression *>(&join.LeftJoinKeyExpression());
+      const auto *right_key = dynamic_cast<const ColumnValueExpression *>(&join.RightJoinKeyExpression());
+      if (col_idx < left_column_cnt) {
+        return (left_key != nullptr && left_key->GetColIdx() == col_idx) ||
+               IsOrderedBy(*join.GetLeftPlan(), col_idx);
+      }
+      return join.GetJoinType() == JoinType::INNER && right_key != nullptr &&
+             right_key->GetColIdx() == col_idx - left_column_cnt && left_key != nullptr &&
+             IsOrderedBy(*join.GetLeftPlan(), left_key->GetColIdx());
+    }
+    default:
+      return false;
+  }
+}
+
+auto Optimizer::OptimizeHashJoinAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeHashJoinAsMergeJoin(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::HashJoin) {
+    const auto &hash_join = dynamic_cast<const HashJoinPlanNode &>(*optimized_plan);
+    BUSTUB_ENSURE(hash_join.children_.size() == 2, "Hash join should have exactly 2 children.");
+
+    // Both keys are plain columns, and both children already produce them in ascending order
+    const auto *left_key = dynamic_cast<const ColumnValueExpression *>(&hash_join.LeftJoinKeyExpression());
+    const auto *right_key = dynamic_cast<const ColumnValueExpression *>(&hash_join.RightJoinKeyExpression());
+    if (left_key != nullptr && right_key != nullptr && IsOrderedBy(*hash_join.GetLeftPlan(), left_key->GetColIdx()) &&
+        IsOrderedBy(*hash_join.GetRightPlan(), right_key->GetColIdx())) {
+      return std::make_shared<MergeJoinPlanNode>(hash_join.output_schema_, hash_join.GetLeftPlan(),
+                                                 hash_join.GetRightPlan(), hash_join.left_key_expression_,
+                                                 hash_join.right_key_expression_, hash_join.GetJoinType());
+    }
+  }
+
+  return optimized_plan;
+}
+
+}  // namespace bustub
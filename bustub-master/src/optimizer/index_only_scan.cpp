@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Add the columns `expr` reads from its (single) child to `columns`. */
+void CollectColumns(const AbstractExpression &expr, std::set<uint32_t> *columns) {
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(&expr); column_expr != nullptr) {
+    columns->insert(column_expr->GetColIdx());
+  }
+  for (const auto &child : expr.GetChildren()) {
+    CollectColumns(*child, columns);
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan,
+                                      const std::optional<std::set<uint32_t>> &needed_columns) -> AbstractPlanNodeRef {
+  if (plan->GetType() == PlanType::IndexScan) {
+    const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*plan);
+    if (index_scan.index_only_ || !needed_columns.has_value()) {
+      return plan;
+    }
+    const auto *index_info = catalog_.GetIndex(index_scan.GetIndexOid());
+    if (index_info->index_type_ != IndexType::BPlusTreeIndex) {
+      // hash buckets keep RIDs only
+      return plan;
+    }
+    const auto &entry_attrs = index_info->index_->GetEntryAttrs();
+    for (auto col_idx : *needed_columns) {
+      if (std::find(entry_attrs.begin(), entry_attrs.end(), col_idx) == entry_attrs.end()) {
+        return plan;
+      }
+    }
+    return std::make_shared<IndexScanPlanNode>(index_scan.output_schema_, index_scan.index_oid_,
+                                               index_scan.low_key_, index_scan.high_key_, index_scan.inclusivity_,
+                                               index_scan.direction_, true);
+  }
+
+  // The columns the child has to produce: those read by this node, plus the ones read above for nodes that pass
+  // their child's tuples through. std::nullopt stands for all of them.
+  std::optional<std::set<uint32_t>> child_columns;
+  switch (plan->GetType()) {
+    case PlanType::Projection: {
+      child_columns.emplace();
+      for (const auto &expr : dynamic_cast<const ProjectionPlanNode &>(*plan).GetExpressions()) {
+        CollectColumns(*expr, &*child_columns);
+      }
+      break;
+    }
+    case PlanType::Aggregation: {
+      const auto &agg_plan = dynamic_cast<const AggregationPlanNode &>(*plan);
+      child_columns.emplace();
+      for (const auto &expr : agg_plan.GetGroupBys()) {
+        CollectColumns(*expr, &*child_columns);
+      }
+      for (const auto &expr : agg_plan.GetAggregates()) {
+        CollectColumns(*expr, &*child_columns);
+      }
+      break;
+    }
+    case PlanType::Filter:
+      if (needed_columns.has_value()) {
+        child_columns = needed_columns;
+        CollectColumns(*dynamic_cast<const FilterPlanNode &>(*plan).GetPredicate(), &*child_columns);
+      }
+      break;
+    case PlanType::Sort:
+    case PlanType::TopN:
+      if (needed_columns.has_value()) {
+        child_columns = needed_columns;
+        const auto &order_bys = plan->GetType() == PlanType::Sort
+                                    ? dynamic_cast<const SortPlanNode &>(*plan).GetOrderBy()
+                                    : dynamic_cast<const TopNPlanNode &>(*plan).GetOrderBy();
+        for (const auto &[order_by_type, expr] : order_bys) {
+          CollectColumns(*expr, &*child_columns);
+        }
+      }
+      break;
+    case PlanType::Limit:
+      child_columns = needed_columns;
+      break;
+    default:
+      // joins and everything else: assume the children's columns are all needed
+      break;
+  }
+
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeIndexOnlyScan(child, child_columns));
+  }
+  return plan->CloneWithChildren(std::move(children));
+}
+
+}  // namespace bustub
@@ -21,10 +21,14 @@
 
 namespace bustub {
 
-auto Optimizer::MatchIndex(const std::string &table_name, uint32_t index_key_idx)
+auto Optimizer::MatchIndex(const std::string &table_name, uint32_t index_key_idx, bool ordered)
     -> std::optional<std::tuple<index_oid_t, std::string>> {
   const auto key_attrs = std::vector{index_key_idx};
+  // Secondary (non-unique) indexes qualify as well: ScanKey returns every matching RID.
   for (const auto *index_info : catalog_.GetTableIndexes(table_name)) {
+    if (ordered && index_info->index_type_ != IndexType::BPlusTreeIndex) {
+      continue;
+    }
     if (key_attrs == index_info->index_->GetKeyAttrs()) {
       return std::make_optional(std::make_tuple(index_info->index_oid_, index_info->name_));
     }
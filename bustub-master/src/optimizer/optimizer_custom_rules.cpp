@@ -12,9 +12,12 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   p = OptimizeMergeProjection(p);
   p = OptimizeMergeFilterNLJ(p);
   p = OptimizeNLJAsIndexJoin(p);
-  // p = OptimizeNLJAsHashJoin(p);  // Enable this rule after you have implemented hash join.
+  p = OptimizeNLJAsHashJoin(p);
+  p = OptimizeFilterAsIndexScan(p);
   p = OptimizeOrderByAsIndexScan(p);
+  p = OptimizeHashJoinAsMergeJoin(p);
   p = OptimizeSortLimitAsTopN(p);
+  p = OptimizeIndexOnlyScan(p);
   return p;
 }
 
@@ -37,11 +37,12 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
       return optimized_plan;
     }
 
-    // Order type is asc or default
+    // Order type is asc or default, or desc with the index scanned backwards
     const auto &[order_type, expr] = order_bys[0];
-    if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
+    if (order_type == OrderByType::INVALID) {
       return optimized_plan;
     }
+    const auto direction = order_type == OrderByType::DESC ? ScanDirection::BACKWARD : ScanDirection::FORWARD;
 
     // Order expression is a column value expression
     const auto *column_value_expr = dynamic_cast<ColumnValueExpression *>(expr.get());
@@ -62,13 +63,28 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
 
       for (const auto *index : indices) {
         const auto &columns = index->key_schema_.GetColumns();
-        if (columns.size() == 1 &&
+        if (index->index_type_ == IndexType::BPlusTreeIndex && columns.size() == 1 &&
             columns[0].GetName() == table_info->schema_.GetColumn(order_by_column_id).GetName()) {
           // Index matched, return index scan instead
-          return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
+          return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_, std::nullopt,
+                                                     std::nullopt, RangeInclusivity{}, direction);
         }
       }
     }
+
+    if (child_plan->GetType() == PlanType::IndexScan) {
+      // A range scan (see OptimizeFilterAsIndexScan) on the order by column is already sorted
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*child_plan);
+      const auto *index = catalog_.GetIndex(index_scan.GetIndexOid());
+      const auto *table_info = catalog_.GetTable(index->table_name_);
+      const auto &columns = index->key_schema_.GetColumns();
+      if (index->index_type_ == IndexType::BPlusTreeIndex && columns.size() == 1 &&
+          columns[0].GetName() == table_info->schema_.GetColumn(order_by_column_id).GetName()) {
+        return std::make_shared<IndexScanPlanNode>(index_scan.output_schema_, index_scan.index_oid_,
+                                                   index_scan.low_key_, index_scan.high_key_, index_scan.inclusivity_,
+                                                   direction);
+      }
+    }
   }
 
   return optimized_plan;
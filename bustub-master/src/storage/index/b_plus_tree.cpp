@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <iterator>
 #include <string>
+#include <type_traits>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "common/exception.h"
@@ -33,16 +36,90 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_P
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
+  result->clear();
+  if (IsEmpty()) {
+    return false;
+  }
   // 首先，找到key对应的叶子节点
   auto left_page = GetLeafNode(key);
-  result->clear();
   result->resize(1);  // 如果参数类型有重载‘=’运算符就不能使用resize?
   bool ans = left_page->FindKey(key, (*result)[0], comparator_);
+  if (!ans) {
+    result->clear();
+  }
   // 叶子节点使用完后进行unpin
   buffer_pool_manager_->UnpinPage(left_page->GetPageId(), false);
   return ans;
 }
 
+/*
+ * Batched point lookups, see GetValueRanges
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               Transaction *transaction) {
+  std::vector<std::pair<KeyType, KeyType>> ranges;
+  ranges.reserve(keys.size());
+  for (const auto &key : keys) {
+    ranges.emplace_back(key, key);
+  }
+  GetValueRanges(ranges, results, transaction);
+}
+
+/*
+ * Collect the values of every key in [low, high] for a batch of ranges sorted by
+ * low and not overlapping each other. The tree is descended once; later ranges
+ * are served from the current leaf or by moving on to the next one, and only a
+ * range that lies further right than that descends from the root again.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValueRanges(const std::vector<std::pair<KeyType, KeyType>> &ranges,
+                                    std::vector<std::vector<ValueType>> *results, Transaction *transaction) {
+  results->assign(ranges.size(), {});
+  if (IsEmpty()) {
+    return;
+  }
+  LeafPage *leaf_page = nullptr;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    const auto &[low, high] = ranges[i];
+    if (leaf_page == nullptr) {
+      leaf_page = GetLeafNode(low);
+    } else if (leaf_page->GetSize() == 0 || comparator_(low, leaf_page->KeyAt(leaf_page->GetSize() - 1)) > 0) {
+      // low在当前叶子之后：先看下一个叶子，还不够的话重新从根往下找
+      page_id_t next_page_id = leaf_page->GetNextPageId();
+      if (next_page_id == INVALID_PAGE_ID) {
+        break;
+      }
+      buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+      leaf_page = static_cast<LeafPage *>(FetchPage(next_page_id));
+      if (comparator_(low, leaf_page->KeyAt(leaf_page->GetSize() - 1)) > 0) {
+        buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+        leaf_page = GetLeafNode(low);
+      }
+    }
+    // 从low开始收集，范围可能跨过叶子的结尾
+    int index = leaf_page->FindKeyIndex(low, comparator_);
+    while (true) {
+      if (index == leaf_page->GetSize()) {
+        page_id_t next_page_id = leaf_page->GetNextPageId();
+        if (next_page_id == INVALID_PAGE_ID) {
+          break;
+        }
+        buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+        leaf_page = static_cast<LeafPage *>(FetchPage(next_page_id));
+        index = 0;
+      }
+      if (comparator_(leaf_page->KeyAt(index), high) > 0) {
+        break;
+      }
+      (*results)[i].push_back(leaf_page->ValueAt(index++));
+    }
+  }
+  if (leaf_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -60,9 +137,77 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     ApplyNewRootPage(key, value);
     return true;
   }
-  bool ok = InsertLeafInternal(key, value);
-  // ToString(FetchPage(root_page_id_), buffer_pool_manager_);
-  return ok;
+  // 比树里所有key都大的key直接追加到最右边的叶子，不用从根往下找
+  if (TryAppendToRightmostLeaf(key, value)) {
+    return true;
+  }
+  // 下降路径记录在transaction的page set里，调用方没有给transaction时用一个临时的
+  Transaction local_transaction(INVALID_TXN_ID);
+  return InsertLeafInternal(key, value, transaction != nullptr ? transaction : &local_transaction);
+}
+
+/*
+ * Insert a batch of key & value pairs. Entries falling into the same leaf one
+ * after another are inserted with a single descent; the entry that would split
+ * the leaf goes through the regular insertion. Any order is correct, but only
+ * sorted runs share descents.
+ * @return: the number of entries inserted, duplicate keys are skipped
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertBatch(const std::vector<std::pair<KeyType, ValueType>> &entries, Transaction *transaction)
+    -> size_t {
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+  size_t inserted = 0;
+  size_t i = 0;
+  while (i < entries.size()) {
+    const auto &[key, value] = entries[i];
+    if (IsEmpty()) {
+      ApplyNewRootPage(key, value);
+      inserted++;
+      i++;
+      continue;
+    }
+    if (TryAppendToRightmostLeaf(key, value)) {
+      inserted++;
+      i++;
+      continue;
+    }
+    LeafPage *leaf_page = GetLeafNodeWithPath(key, transaction);
+    std::optional<KeyType> fence = GetLeafUpperFence(transaction);
+    // 后面的key只要递增且小于叶子的上界，就还属于这个叶子；叶子快满时停下
+    size_t start = i;
+    bool is_dirty = false;
+    while (i < entries.size() && leaf_page->GetSize() + 1 < leaf_page->GetMaxSize()) {
+      const auto &next_key = entries[i].first;
+      if ((fence.has_value() && comparator_(next_key, *fence) >= 0) ||
+          (i > start && comparator_(next_key, entries[i - 1].first) < 0)) {
+        break;
+      }
+      ValueType val;
+      if (!leaf_page->FindKey(next_key, val, comparator_)) {
+        leaf_page->Insert(next_key, entries[i].second, comparator_);
+        inserted++;
+        is_dirty = true;
+      }
+      i++;
+    }
+    if (is_dirty && leaf_page->GetNextPageId() == INVALID_PAGE_ID) {
+      rightmost_leaf_page_id_ = leaf_page->GetPageId();
+      rightmost_last_key_ = leaf_page->KeyAt(leaf_page->GetSize() - 1);
+    }
+    transaction->GetPageSet()->pop_back();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), is_dirty);
+    ReleasePath(transaction, false);
+    // 第一个key就会让叶子分裂
+    if (i == start) {
+      inserted += InsertLeafInternal(key, value, transaction) ? 1 : 0;
+      i++;
+    }
+  }
+  return inserted;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -75,75 +220,157 @@ void BPlusTree<KeyType, ValueType, KeyComparator>::ApplyNewRootPage(const KeyTyp
   root_page_id_ = new_page_id;
   // 每次申请新page时调用init
   auto leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
-  leaf_page->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_);
+  leaf_page->Init(new_page_id, leaf_max_size_);
   // rootpage 发生变化时调用UpdateRootPageId
   UpdateRootPageId(true);
+  rightmost_leaf_page_id_ = new_page_id;
+  rightmost_last_key_ = key;
   leaf_page->Insert(key, value, comparator_);
   // 使用完unpin
   buffer_pool_manager_->UnpinPage(new_page_id, true);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::InsertLeafInternal(const KeyType &key, const ValueType &value) -> bool {
-  auto leaf_page = GetLeafNode(key);
+auto BPLUSTREE_TYPE::InsertLeafInternal(const KeyType &key, const ValueType &value, Transaction *transaction)
+    -> bool {
+  auto leaf_page = GetLeafNodeWithPath(key, transaction);
   // 查看当前叶子节点有没有即将插入的key
   ValueType val;
   if (leaf_page->FindKey(key, val, comparator_)) {
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+    ReleasePath(transaction, false);
     return false;
   }
+  // 叶子节点出栈，栈里只剩它的祖先
+  transaction->GetPageSet()->pop_back();
+  // 插在最右边叶子的末尾，说明key是递增着来的
+  bool append = leaf_page->GetNextPageId() == INVALID_PAGE_ID &&
+                (leaf_page->GetSize() == 0 || comparator_(key, leaf_page->KeyAt(leaf_page->GetSize() - 1)) > 0);
   // 如果插入后发现叶子节点的kv数达到了最大值
-  if (leaf_page->Insert(key, value, comparator_) == leaf_max_size_) {
-    // 新建一个新的page，将原page的一半转移到新page并更新next_page_id
-    LeafPage *new_leaf_page = Split(leaf_page);
+  if (leaf_page->Insert(key, value, comparator_) >= leaf_max_size_) {
+    // 新建一个新的page，将原page的后一部分转移到新page并更新next_page_id
+    LeafPage *new_leaf_page = Split(leaf_page, append);
     // 将用于指向新节点的key插入到parent_page中
-    InsertKeyToParentPage(leaf_page, new_leaf_page, new_leaf_page->KeyAt(0));
+    InsertKeyToParentPage(leaf_page, new_leaf_page, new_leaf_page->KeyAt(0), transaction, append);
+    if (new_leaf_page->GetNextPageId() == INVALID_PAGE_ID) {
+      rightmost_leaf_page_id_ = new_leaf_page->GetPageId();
+      rightmost_last_key_ = new_leaf_page->KeyAt(new_leaf_page->GetSize() - 1);
+    }
     buffer_pool_manager_->UnpinPage(new_leaf_page->GetPageId(), true);
+  } else if (leaf_page->GetNextPageId() == INVALID_PAGE_ID) {
+    rightmost_leaf_page_id_ = leaf_page->GetPageId();
+    rightmost_last_key_ = leaf_page->KeyAt(leaf_page->GetSize() - 1);
   }
   buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
+  // 剩下的祖先没有被修改
+  ReleasePath(transaction, false);
   return true;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryAppendToRightmostLeaf(const KeyType &key, const ValueType &value) -> bool {
+  // 不比缓存的最大key大的key一定不是追加，不用取页；删除后缓存的key可能偏大，只是少走几次快路径
+  if (rightmost_leaf_page_id_ == INVALID_PAGE_ID ||
+      (rightmost_last_key_.has_value() && comparator_(key, *rightmost_last_key_) <= 0)) {
+    return false;
+  }
+  auto *leaf_page = static_cast<LeafPage *>(FetchPage(rightmost_leaf_page_id_));
+  assert(leaf_page->GetNextPageId() == INVALID_PAGE_ID);
+  int size = leaf_page->GetSize();
+  // 会让叶子分裂的插入需要父节点，交给正常的插入流程
+  bool can_append =
+      size > 0 && size + 1 < leaf_page->GetMaxSize() && comparator_(key, leaf_page->KeyAt(size - 1)) > 0;
+  if (can_append) {
+    leaf_page->Insert(key, value, comparator_);
+    rightmost_last_key_ = key;
+  }
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), can_append);
+  return can_append;
+}
+
+/*
+ * 从叶子往上找第一个不是父节点最后一个孩子的祖先，它右边的key就是叶子的上界
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetLeafUpperFence(Transaction *transaction) -> std::optional<KeyType> {
+  auto path = transaction->GetPageSet();
+  page_id_t child_page_id = path->back()->GetPageId();
+  for (auto it = std::next(path->rbegin()); it != path->rend(); ++it) {
+    auto *parent_page = reinterpret_cast<InternalPage *>((*it)->GetData());
+    int index = parent_page->FindValueIndex(child_page_id);
+    if (index + 1 < parent_page->GetSize()) {
+      return parent_page->KeyAt(index + 1);
+    }
+    child_page_id = parent_page->GetPageId();
+  }
+  return std::nullopt;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 template <class PageType>
-auto BPLUSTREE_TYPE::Split(PageType *leaf_page) -> PageType * {
+auto BPLUSTREE_TYPE::Split(PageType *leaf_page, bool append) -> PageType * {
   assert(leaf_page != nullptr);
   page_id_t new_page_id;
   Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  assert(new_page != nullptr);
   auto *right_page = reinterpret_cast<PageType *>(new_page->GetData());
-  right_page->Init(new_page_id, leaf_page->GetParentPageId(), leaf_page->GetMaxSize());
-  // 调用函数分离数据
-  leaf_page->SplitDataTo(right_page, buffer_pool_manager_);
+  right_page->Init(new_page_id, leaf_page->GetMaxSize());
+  // 顺序追加时左页留下约90%，右页至少留一个kv（内部节点两个孩子）
+  int size = leaf_page->GetSize();
+  int left_size = size / 2;
+  if (append) {
+    constexpr int min_right_size = std::is_same_v<PageType, LeafPage> ? 1 : 2;
+    left_size = std::max(left_size, std::min(size * 9 / 10, size - min_right_size));
+  }
+  // 调用函数分离数据，只涉及左右两个兄弟
+  leaf_page->SplitDataTo(right_page, left_size);
+  if constexpr (std::is_same_v<PageType, LeafPage>) {
+    // 原来的下一个叶子现在排在新页后面
+    RelinkPrevPageId(right_page->GetNextPageId(), right_page->GetPageId());
+  }
   return right_page;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::InsertKeyToParentPage(BPlusTreePage *left_page, BPlusTreePage *right_page, const KeyType &key) {
+void BPLUSTREE_TYPE::RelinkPrevPageId(page_id_t page_id, page_id_t prev_page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  auto *leaf_page = static_cast<LeafPage *>(FetchPage(page_id));
+  leaf_page->SetPrevPageId(prev_page_id);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
+/*
+ * 栈顶是left_page的父节点（left_page本身已经出栈），栈为空说明left_page是根
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertKeyToParentPage(BPlusTreePage *left_page, BPlusTreePage *right_page, const KeyType &key,
+                                           Transaction *transaction, bool append) {
+  auto path = transaction->GetPageSet();
   // 分两种情况，一种是split前的节点是root节点，此时需要新new一个page出来作为根节点
-  if (left_page->IsRootPage()) {
+  if (path->empty()) {
+    assert(left_page->GetPageId() == root_page_id_);
     Page *new_page = buffer_pool_manager_->NewPage(&root_page_id_);
     assert(new_page != nullptr);
-    assert(new_page->GetPinCount() == 1);
     auto *new_root_page = reinterpret_cast<InternalPage *>(new_page->GetData());
-    new_root_page->Init(root_page_id_, INVALID_PAGE_ID, internal_max_size_);
+    new_root_page->Init(root_page_id_, internal_max_size_);
     // 给根节点插入新分裂出的page
     new_root_page->InsertFirstInit(left_page->GetPageId(), right_page->GetPageId(), key);
     UpdateRootPageId();
-    left_page->SetParentPageId(root_page_id_);
-    right_page->SetParentPageId(root_page_id_);
     buffer_pool_manager_->UnpinPage(new_page->GetPageId(), true);
     return;
   }
-  // 第二种情况：普通的叶子节点split
-  Page *page = buffer_pool_manager_->FetchPage(left_page->GetParentPageId());
+  // 第二种情况：普通的节点split，父节点就是下降路径上的前一个节点
+  Page *page = path->back();
+  path->pop_back();
   auto *parent_page = reinterpret_cast<InternalPage *>(page->GetData());
-  right_page->SetParentPageId(left_page->GetParentPageId());
   // 把分割点插入parent_page
   // 如果Insert发现需要split
   if (parent_page->InsertKeyAfterIt(left_page->GetPageId(), right_page->GetPageId(), comparator_, key) >
       internal_max_size_) {
-    InternalPage *new_split_page = Split(parent_page);
-    InsertKeyToParentPage(parent_page, new_split_page, new_split_page->KeyAt(0));
+    // 最右边的叶子追加分裂时，新key也落在每个祖先的末尾
+    InternalPage *new_split_page = Split(parent_page, append);
+    InsertKeyToParentPage(parent_page, new_split_page, new_split_page->KeyAt(0), transaction, append);
     buffer_pool_manager_->UnpinPage(new_split_page->GetPageId(), true);
   }
   buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
@@ -164,134 +391,86 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   if (IsEmpty()) {
     return;
   }
-  LeafPage *leaf_page = GetLeafNode(key);
-  if (leaf_page->Delete(key, comparator_) < leaf_page->GetMinSize()) {
-    // 删除后发现节点个数小于最小值,需要merge或redistribute
-    MergeOrRedistribute(leaf_page);
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
   }
+  LeafPage *leaf_page = GetLeafNodeWithPath(key, transaction);
+  int old_size = leaf_page->GetSize();
+  if (leaf_page->Delete(key, comparator_) == old_size) {
+    // key不存在
+    ReleasePath(transaction, false);
+    return;
+  }
+  // 删除后发现节点个数小于最小值,需要merge或redistribute
+  MergeOrRedistribute(leaf_page, transaction);
+  ReleasePath(transaction, false);
 }
 
-// 从兄弟节点调用数据填补自身或与兄弟直接进行合并
+/*
+ * 栈顶是old_page自己，处理完后old_page出栈并unpin。
+ * 从兄弟节点调用数据填补自身或与兄弟直接进行合并，兄弟和父节点都来自下降路径，不再需要parent_page_id
+ */
 INDEX_TEMPLATE_ARGUMENTS
 template <class PageType>
-auto BPLUSTREE_TYPE::MergeOrRedistribute(PageType *old_page) -> bool {
+void BPLUSTREE_TYPE::MergeOrRedistribute(PageType *old_page, Transaction *transaction) {
+  auto path = transaction->GetPageSet();
+  assert(!path->empty() && path->back()->GetPageId() == old_page->GetPageId());
+  path->pop_back();
   // 如果需要进行判断的是root
-  if (old_page->IsRootPage()) {
-    AdjustRoot(old_page);
-    return true;
-  }
-  // 先判断当前节点能否和兄弟节点进行合并
-  BPlusTreePage *left_page;
-  BPlusTreePage *right_page;
-  // TODO index 有问题，应该分别找到左右邻居的index 而不是old_page的index
-  auto [index, right_index] = FindBrothers(old_page, &left_page, &right_page);
-
-  if (left_page && left_page->GetSize() + old_page->GetSize() <= left_page->GetMaxSize()) {
-    Merge(old_page, left_page, index, true);
-    return true;
-  }
-  if (right_page && right_page->GetSize() + old_page->GetSize() <= right_page->GetMaxSize()) {
-    Merge(old_page, right_page, right_index, false);
-    return true;
+  if (path->empty()) {
+    AdjustRoot(old_page, transaction);
+    buffer_pool_manager_->UnpinPage(old_page->GetPageId(), true);
+    return;
   }
-  // 再判断是否能从兄弟那儿拿点来
-  if (left_page) {
-    (static_cast<PageType *>(left_page))->MoveLastToFrontOf(old_page, buffer_pool_manager_);
-  } else if (right_page) {
-    (static_cast<PageType *>(right_page))->MoveFrontToLastOf(old_page, buffer_pool_manager_);
+  if (old_page->GetSize() >= old_page->GetMinSize()) {
+    buffer_pool_manager_->UnpinPage(old_page->GetPageId(), true);
+    return;
   }
-  return true;
-}
 
-INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Merge(InternalPage *original_page, BPlusTreePage *target, int index, bool is_left) {
-  if (is_left) {
-    auto target_page = static_cast<InternalPage *>(target);
-    assert(original_page->GetSize() + target_page->GetSize() <= target_page->GetMaxSize());
-    // 将original数据移到target中
-    auto original = static_cast<BPlusTreePage *>(original_page);
-    target_page->MergeWith(original, index, buffer_pool_manager_);
-    auto old_page_id = original_page->GetPageId();
-    auto old_parent_page_id = original_page->GetParentPageId();
-    buffer_pool_manager_->UnpinPage(old_page_id, true);
-    buffer_pool_manager_->DeletePage(old_page_id);
-    buffer_pool_manager_->UnpinPage(target_page->GetPageId(), true);
-    auto parent_page = static_cast<InternalPage *>(FetchPage(old_parent_page_id));
-    assert(parent_page != nullptr);
-    if (parent_page->DeleteInternal(index) <= parent_page->GetMinSize()) {
-      MergeOrRedistribute(parent_page);
-    }
-  } else {
-    // old_page   right_page
-    original_page->MergeWith(target, index, buffer_pool_manager_);
-    auto target_page = static_cast<InternalPage *>(target);
-    auto target_page_id = target_page->GetPageId();
-    auto target_parent_page_id = target_page->GetParentPageId();
-    buffer_pool_manager_->UnpinPage(target_page_id, true);
-    buffer_pool_manager_->DeletePage(target_page_id);
-    buffer_pool_manager_->UnpinPage(original_page->GetPageId(), true);
-    auto parent_page = static_cast<InternalPage *>(FetchPage(target_parent_page_id));
-    assert(parent_page != nullptr);
-    if (parent_page->DeleteInternal(index) <= parent_page->GetMinSize()) {
-      MergeOrRedistribute(parent_page);
+  Page *parent = path->back();
+  auto *parent_page = reinterpret_cast<InternalPage *>(parent->GetData());
+  int index = parent_page->FindValueIndex(old_page->GetPageId());
+  assert(index >= 0);
+  // 优先找左兄弟，最左边的孩子只能找右兄弟
+  int brother_index = index == 0 ? 1 : index - 1;
+  auto *brother_page = static_cast<PageType *>(FetchPage(parent_page->ValueAt(brother_index)));
+
+  // 叶子节点达到max就会分裂，内部节点超过max才分裂
+  int merged_size = old_page->GetSize() + brother_page->GetSize();
+  bool can_merge = old_page->IsLeafPage() ? merged_size < old_page->GetMaxSize()
+                                          : merged_size <= old_page->GetMaxSize();
+  if (can_merge) {
+    // 总是把右边的节点并到左边
+    PageType *left_page = index == 0 ? old_page : brother_page;
+    PageType *right_page = index == 0 ? brother_page : old_page;
+    int right_index = index == 0 ? 1 : index;
+    if constexpr (std::is_same_v<PageType, LeafPage>) {
+      left_page->MergeWith(right_page);
+      RelinkPrevPageId(left_page->GetNextPageId(), left_page->GetPageId());
+    } else {
+      left_page->MergeWith(right_page, parent_page->KeyAt(right_index));
     }
+    transaction->AddIntoDeletedPageSet(right_page->GetPageId());
+    buffer_pool_manager_->UnpinPage(old_page->GetPageId(), true);
+    buffer_pool_manager_->UnpinPage(brother_page->GetPageId(), true);
+    parent_page->DeleteInternal(right_index);
+    // 父节点少了一个孩子，继续向上检查
+    MergeOrRedistribute(parent_page, transaction);
+    return;
   }
-}
 
-INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Merge(LeafPage *original_page, BPlusTreePage *target, int index, bool is_left) {
-  if (is_left) {
-    auto target_page = static_cast<LeafPage *>(target);
-    assert(original_page->GetSize() + target_page->GetSize() <= target_page->GetMaxSize());
-    // 将original数据移到target中
-    auto original = static_cast<BPlusTreePage *>(original_page);
-    target_page->MergeWith(original, index, buffer_pool_manager_);
-    auto old_page_id = original_page->GetPageId();
-    auto old_parent_page_id = original_page->GetParentPageId();
-    buffer_pool_manager_->UnpinPage(old_page_id, true);
-    buffer_pool_manager_->DeletePage(old_page_id);
-    buffer_pool_manager_->UnpinPage(target_page->GetPageId(), true);
-    auto parent_page = static_cast<InternalPage *>(FetchPage(old_parent_page_id));
-    assert(parent_page != nullptr);
-    if (parent_page->DeleteInternal(index) <= parent_page->GetMinSize()) {
-      MergeOrRedistribute(parent_page);
-    }
+  // 再判断是否能从兄弟那儿拿点来
+  if (index == 0) {
+    brother_page->MoveFrontToLastOf(old_page, parent_page, brother_index);
   } else {
-    // old_page   right_page
-    original_page->MergeWith(target, index, buffer_pool_manager_);
-    auto target_page = static_cast<LeafPage *>(target);
-    auto target_page_id = target_page->GetPageId();
-    auto target_parent_page_id = target_page->GetParentPageId();
-    buffer_pool_manager_->UnpinPage(target_page_id, true);
-    buffer_pool_manager_->DeletePage(target_page_id);
-    buffer_pool_manager_->UnpinPage(original_page->GetPageId(), true);
-    auto parent_page = static_cast<InternalPage *>(FetchPage(target_parent_page_id));
-    assert(parent_page != nullptr);
-    if (parent_page->DeleteInternal(index) <= parent_page->GetMinSize()) {
-      MergeOrRedistribute(parent_page);
-    }
+    brother_page->MoveLastToFrontOf(old_page, parent_page, index);
   }
-}
-
-INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::FindBrothers(BPlusTreePage *cur_page, BPlusTreePage **left_page, BPlusTreePage **right_page)
-    -> std::pair<int, int> {
-  BPlusTreePage *parent;
-  parent = FetchPage(cur_page->GetParentPageId());
-  auto page_id = cur_page->GetPageId();
-  auto parent_page = static_cast<InternalPage *>(parent);
-  assert(parent_page);
-  int index = parent_page->FindValueIndex(page_id);
-  *left_page = index <= 0 ? nullptr : FetchPage(parent_page->ValueAt(index - 1));
-  *right_page = index >= parent_page->GetSize() - 1 ? nullptr : FetchPage(parent_page->ValueAt(index + 1));
-  buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), false);
-  return std::pair<int, int>(index, index + 1);
-}
-
-INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::SpecialFetchPage(page_id_t page_id) -> BPlusTreePage * {
-  auto page = static_cast<BufferPoolManagerInstance *>(buffer_pool_manager_)->SpecialFetchPage(page_id);
-  return reinterpret_cast<BPlusTreePage *>(page->GetData());
+  buffer_pool_manager_->UnpinPage(old_page->GetPageId(), true);
+  buffer_pool_manager_->UnpinPage(brother_page->GetPageId(), true);
+  // 父节点只改了一个key
+  path->pop_back();
+  buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
 }
 
 /*
@@ -300,40 +479,25 @@ auto BPLUSTREE_TYPE::SpecialFetchPage(page_id_t page_id) -> BPlusTreePage * {
  * 当前root为叶子节点且删除了最后一个节点，此时树中再无数据，删除树的最后一个节点
  */
 INDEX_TEMPLATE_ARGUMENTS
-template <class PageType>
-void BPLUSTREE_TYPE::AdjustRoot(PageType *old_root_page) {
+void BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_page, Transaction *transaction) {
   assert(old_root_page != nullptr);
   if (old_root_page->IsLeafPage()) {
-    assert(old_root_page->GetSize() == 0);
-    assert(old_root_page->GetParentPageId() == INVALID_PAGE_ID);
-    buffer_pool_manager_->UnpinPage(root_page_id_, false);
-    buffer_pool_manager_->DeletePage(root_page_id_);
+    if (old_root_page->GetSize() > 0) {
+      return;
+    }
+    transaction->AddIntoDeletedPageSet(root_page_id_);
     root_page_id_ = INVALID_PAGE_ID;
     UpdateRootPageId();
     return;
   }
   if (old_root_page->GetSize() == 1) {
-    auto old_internal_root_page = dynamic_cast<InternalPage *>(old_root_page);
-    auto new_root_page_id = old_internal_root_page->ChangeRoot();
-    auto old_root_page_id = old_internal_root_page->GetPageId();
-    // 初始化新的root
-    auto new_page = buffer_pool_manager_->FetchPage(new_root_page_id);
-    assert(new_page != nullptr);
-    auto new_root_page = reinterpret_cast<LeafPage *>(new_page->GetData());
-    new_root_page->SetParentPageId(INVALID_PAGE_ID);
-    root_page_id_ = new_root_page_id;
+    auto old_internal_root_page = static_cast<InternalPage *>(old_root_page);
+    transaction->AddIntoDeletedPageSet(root_page_id_);
+    root_page_id_ = old_internal_root_page->ChangeRoot();
     UpdateRootPageId();
-    buffer_pool_manager_->UnpinPage(new_root_page_id, true);
-    buffer_pool_manager_->UnpinPage(old_root_page_id, false);
-    buffer_pool_manager_->DeletePage(old_root_page_id);
-    return;
   }
 }
 
-INDEX_TEMPLATE_ARGUMENTS
-template <class PageType>
-void BPLUSTREE_TYPE::Redistribute(PageType *original_page, BPlusTreePage *target_page, int index, bool IsLeft) {}
-
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -344,7 +508,10 @@ void BPLUSTREE_TYPE::Redistribute(PageType *original_page, BPlusTreePage *target
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-  KeyType unless;
+  if (IsEmpty()) {
+    return End();
+  }
+  KeyType unless{};
   auto leaf_page = GetLeafNode(unless, -1);
   return IndexIterator(leaf_page, 0, buffer_pool_manager_);
 }
@@ -356,8 +523,64 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  if (IsEmpty()) {
+    return End();
+  }
   auto leaf_page = GetLeafNode(key);
   int index = leaf_page->FindKeyIndex(key, comparator_);
+  // key比当前叶子里所有key都大时，从下一个叶子的开头开始
+  if (index == leaf_page->GetSize()) {
+    page_id_t next_page_id = leaf_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return End();
+    }
+    leaf_page = static_cast<LeafPage *>(FetchPage(next_page_id));
+    index = 0;
+  }
+  return IndexIterator(leaf_page, index, buffer_pool_manager_);
+}
+
+/*
+ * Input parameter is void, find the rightmost leaf page and construct an index
+ * iterator at its last entry, for scanning backwards
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin() -> INDEXITERATOR_TYPE {
+  if (IsEmpty()) {
+    return End();
+  }
+  KeyType unless{};
+  auto leaf_page = GetLeafNode(unless, 1);
+  return IndexIterator(leaf_page, leaf_page->GetSize() - 1, buffer_pool_manager_);
+}
+
+/*
+ * Input parameter is high key, construct an index iterator at the last entry
+ * whose key is <= the input key, for scanning backwards
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  if (IsEmpty()) {
+    return End();
+  }
+  auto leaf_page = GetLeafNode(key);
+  int index = leaf_page->FindKeyIndex(key, comparator_);
+  if (index == leaf_page->GetSize() || comparator_(leaf_page->KeyAt(index), key) != 0) {
+    index--;
+  }
+  // key比当前叶子里所有key都小时，从上一个叶子的结尾开始
+  if (index < 0) {
+    page_id_t prev_page_id = leaf_page->GetPrevPageId();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+    if (prev_page_id == INVALID_PAGE_ID) {
+      return End();
+    }
+    leaf_page = static_cast<LeafPage *>(FetchPage(prev_page_id));
+    index = leaf_page->GetSize() - 1;
+  }
   return IndexIterator(leaf_page, index, buffer_pool_manager_);
 }
 
@@ -395,18 +618,16 @@ auto BPLUSTREE_TYPE::GetLeafNode(const KeyType &key, int iter) -> LeafPage * {
   auto cur_page = FetchPage(root_page_id_);
   // 直到叶子节点才停止
   while (!cur_page->IsLeafPage()) {
+    auto internal_page = static_cast<InternalPage *>(cur_page);
+    page_id_t page_id;
     if (iter == -1) {
-      page_id_t page_id = static_cast<InternalPage *>(cur_page)->ValueAt(0);
-      cur_page = FetchPage(page_id);
-      continue;
-    }
-    if (iter == 1) {
-      page_id_t page_id = static_cast<InternalPage *>(cur_page)->GetEndValue();
-      cur_page = FetchPage(page_id);
-      continue;
+      page_id = internal_page->ValueAt(0);
+    } else if (iter == 1) {
+      page_id = internal_page->GetEndValue();
+    } else {
+      // 提升指针后调用相应节点接口获得下一次应该寻找的子结点page_id
+      page_id = internal_page->FindLowerBound(key, comparator_);
     }
-    // 提升指针后调用相应节点接口获得下一次应该寻找的子结点page_id
-    page_id_t page_id = static_cast<InternalPage *>(cur_page)->FindLowerBound(key, comparator_);
     // 每一个page最后一次使用后需要unpin以防缓存池以为还有用户在使用该页而无法进行驱逐等操作
     buffer_pool_manager_->UnpinPage(cur_page->GetPageId(), false);
     // 跳转到下一层的页
@@ -416,6 +637,51 @@ auto BPLUSTREE_TYPE::GetLeafNode(const KeyType &key, int iter) -> LeafPage * {
   return static_cast<LeafPage *>(cur_page);
 }
 
+/*
+ * 和GetLeafNode一样找到key所在的叶子，但路径上的页都保持pin住并按从根到叶子的顺序压入transaction的page set，
+ * 分裂/合并时用它们代替parent_page_id找父节点
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetLeafNodeWithPath(const KeyType &key, Transaction *transaction) -> LeafPage * {
+  assert(!IsEmpty());
+  auto path = transaction->GetPageSet();
+  assert(path->empty());
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  assert(page != nullptr);
+  auto *cur_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  path->push_back(page);
+  while (!cur_page->IsLeafPage()) {
+    page_id_t page_id = static_cast<InternalPage *>(cur_page)->FindLowerBound(key, comparator_);
+    page = buffer_pool_manager_->FetchPage(page_id);
+    assert(page != nullptr);
+    cur_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    path->push_back(page);
+  }
+  return static_cast<LeafPage *>(cur_page);
+}
+
+/*
+ * unpin下降路径上剩下的页，并真正删除合并时释放的页
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleasePath(Transaction *transaction, bool is_dirty) {
+  auto path = transaction->GetPageSet();
+  while (!path->empty()) {
+    buffer_pool_manager_->UnpinPage(path->back()->GetPageId(), is_dirty);
+    path->pop_back();
+  }
+  auto deleted_pages = transaction->GetDeletedPageSet();
+  if (!deleted_pages->empty()) {
+    // 缓存的最右叶子可能被合并掉了
+    rightmost_leaf_page_id_ = INVALID_PAGE_ID;
+    rightmost_last_key_.reset();
+  }
+  for (page_id_t page_id : *deleted_pages) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  deleted_pages->clear();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::FetchPage(page_id_t page_id) -> BPlusTreePage * {
   auto page = buffer_pool_manager_->FetchPage(page_id);
@@ -541,11 +807,6 @@ void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::o
       out << "{rank=same " << leaf_prefix << leaf->GetPageId() << " " << leaf_prefix << leaf->GetNextPageId() << "};\n";
     }
 
-    // Print parent links if there is a parent
-    if (leaf->GetParentPageId() != INVALID_PAGE_ID) {
-      out << internal_prefix << leaf->GetParentPageId() << ":p" << leaf->GetPageId() << " -> " << leaf_prefix
-          << leaf->GetPageId() << ";\n";
-    }
   } else {
     auto *inner = reinterpret_cast<InternalPage *>(page);
     // Print node name
@@ -572,14 +833,12 @@ void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::o
     out << "</TR>";
     // Print table end
     out << "</TABLE>>];\n";
-    // Print Parent link
-    if (inner->GetParentPageId() != INVALID_PAGE_ID) {
-      out << internal_prefix << inner->GetParentPageId() << ":p" << inner->GetPageId() << " -> " << internal_prefix
-          << inner->GetPageId() << ";\n";
-    }
     // Print leaves
     for (int i = 0; i < inner->GetSize(); i++) {
       auto child_page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(inner->ValueAt(i))->GetData());
+      // Print child link, pages keep no parent pointer so the parent draws it
+      out << internal_prefix << inner->GetPageId() << ":p" << child_page->GetPageId() << " -> "
+          << (child_page->IsLeafPage() ? leaf_prefix : internal_prefix) << child_page->GetPageId() << ";\n";
       ToGraph(child_page, bpm, out);
       if (i > 0) {
         auto sibling_page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(inner->ValueAt(i - 1))->GetData());
@@ -606,8 +865,8 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const {
   if (page->IsLeafPage()) {
     auto *leaf = reinterpret_cast<LeafPage *>(page);
-    std::cout << "Leaf Page: " << leaf->GetPageId() << " parent: " << leaf->GetParentPageId()
-              << " next: " << leaf->GetNextPageId() << " size: " << leaf->GetSize() << std::endl;
+    std::cout << "Leaf Page: " << leaf->GetPageId() << " next: " << leaf->GetNextPageId()
+              << " size: " << leaf->GetSize() << std::endl;
     for (int i = 0; i < leaf->GetSize(); i++) {
       std::cout << leaf->KeyAt(i) << ",";
     }
@@ -615,8 +874,7 @@ void BPLUSTREE_TYPE::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const
     std::cout << std::endl;
   } else {
     auto *internal = reinterpret_cast<InternalPage *>(page);
-    std::cout << "Internal Page: " << internal->GetPageId() << " parent: " << internal->GetParentPageId()
-              << "size: " << internal->GetSize() << std::endl;
+    std::cout << "Internal Page: " << internal->GetPageId() << " size: " << internal->GetSize() << std::endl;
     for (int i = 0; i < internal->GetSize(); i++) {
       std::cout << internal->KeyAt(i) << ": " << internal->ValueAt(i) << ",";
     }
@@ -9,43 +9,363 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+#include "common/exception.h"
 #include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
+
+// 非唯一索引里key相同的条目按RID排序，用最小/最大的RID拼出某个key全部条目的下界/上界
+static const RID MIN_RID{std::numeric_limits<page_id_t>::min(), 0};
+static const RID MAX_RID{std::numeric_limits<page_id_t>::max(), std::numeric_limits<uint32_t>::max()};
+// 布隆过滤器至少按这么多key分配，避免空索引上建出太小的过滤器
+static constexpr size_t BLOOM_FILTER_MIN_KEYS = 1024;
+
 /*
  * Constructor
  */
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
     : Index(std::move(metadata)),
-      comparator_(GetMetadata()->GetKeySchema()),
+      comparator_(CheckKeySchema(GetMetadata()), !GetMetadata()->IsUnique()),
+      include_offset_(GetKeySchema()->GetLength() + (IsUnique() ? 0 : sizeof(RID))),
       container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
-  // construct insert index key
+auto BPLUSTREE_INDEX_TYPE::CheckKeySchema(IndexMetadata *metadata) -> Schema * {
+  auto *key_schema = metadata->GetKeySchema();
+  if (!metadata->IsUnique() && (!key_schema->IsInlined() || key_schema->GetLength() + sizeof(RID) > sizeof(KeyType))) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "key of a non-unique index has no room for the RID suffix");
+  }
+  if (!metadata->GetIncludeAttrs().empty()) {
+    auto *include_schema = metadata->GetIncludeSchema();
+    size_t entry_length =
+        key_schema->GetLength() + (metadata->IsUnique() ? 0 : sizeof(RID)) + include_schema->GetLength();
+    if (!key_schema->IsInlined() || !include_schema->IsInlined() || entry_length > sizeof(KeyType)) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "key of a covering index has no room for the included columns");
+    }
+  }
+  return key_schema;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MakeKey(const Tuple &key, const RID &rid) const -> KeyType {
   KeyType index_key;
   index_key.SetFromKey(key);
+  const uint32_t key_length = GetKeySchema()->GetLength();
+  if (key.GetLength() > key_length) {
+    // 带着INCLUDE列的条目：INCLUDE列挪到RID后面，比较时不会看到它们
+    memmove(index_key.data_ + include_offset_, index_key.data_ + key_length, key.GetLength() - key_length);
+  }
+  if (comparator_.HasRidSuffix()) {
+    index_key.SetRid(rid, key_length);
+  }
+  return index_key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::EntryFromKey(const KeyType &index_key) const -> Tuple {
+  auto *key_schema = GetKeySchema();
+  auto *include_schema = GetMetadata()->GetIncludeSchema();
+  std::vector<Value> values;
+  values.reserve(key_schema->GetColumnCount() + include_schema->GetColumnCount());
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    values.push_back(index_key.ToValue(key_schema, i));
+  }
+  for (uint32_t i = 0; i < include_schema->GetColumnCount(); i++) {
+    values.push_back(index_key.ToValue(include_schema, i, include_offset_));
+  }
+  return {values, GetEntrySchema()};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::EnableBloomFilter(size_t bits_per_key) {
+  BUSTUB_ASSERT(bits_per_key > 0, "empty bloom filter");
+  std::unique_lock<std::shared_mutex> l(bloom_latch_);
+  bloom_bits_per_key_ = bits_per_key;
+  // 等第一次查询时再从叶子建
+  bloom_stale_ = true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::HashKey(const KeyType &index_key) const -> hash_t {
+  // 只哈希key列：RID后缀和INCLUDE列在查询用的key里没有
+  auto *key_schema = GetKeySchema();
+  if (key_schema->IsInlined()) {
+    return HashUtil::HashBytes(index_key.data_, key_schema->GetLength());
+  }
+  // 变长列在key里存的是偏移，只能按值哈希
+  hash_t hash = 0;
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    std::string value = index_key.ToValue(key_schema, i).ToString();
+    hash = HashUtil::CombineHashes(hash, HashUtil::HashBytes(value.data(), value.size()));
+  }
+  return hash;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BloomFilterMayContain(const KeyType &index_key) -> bool {
+  {
+    std::shared_lock<std::shared_mutex> l(bloom_latch_);
+    if (bloom_bits_per_key_ == 0) {
+      return true;
+    }
+    if (!bloom_stale_) {
+      if (bloom_filter_->MayContain(HashKey(index_key))) {
+        return true;
+      }
+      avoided_descents_++;
+      return false;
+    }
+  }
+  // 过滤器过期了，换成写锁重建；别的线程可能已经抢先重建好了
+  std::unique_lock<std::shared_mutex> l(bloom_latch_);
+  if (bloom_stale_) {
+    RebuildBloomFilter();
+  }
+  if (bloom_filter_->MayContain(HashKey(index_key))) {
+    return true;
+  }
+  avoided_descents_++;
+  return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BloomFilterInsert(const KeyType &index_key) {
+  // key已经插进树里了：过期时跳过没关系，重建在写锁下扫叶子，一定能看到它；
+  // 重建正在进行时这里会等它结束，再插进新的过滤器
+  std::unique_lock<std::shared_mutex> l(bloom_latch_);
+  if (bloom_bits_per_key_ == 0 || bloom_stale_) {
+    return;
+  }
+  bloom_filter_->Insert(HashKey(index_key));
+  // key数超过设计容量太多时误判率会升高，下次查询前按新的大小重建
+  if (++bloom_keys_ > 2 * bloom_filter_->GetCapacity()) {
+    bloom_stale_ = true;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::RebuildBloomFilter() {
+  std::vector<hash_t> hashes;
+  for (auto iter = container_.Begin(); !iter.IsEnd(); ++iter) {
+    hashes.push_back(HashKey((*iter).first));
+  }
+  bloom_filter_ = std::make_unique<BlockedBloomFilter>(std::max<size_t>(hashes.size(), BLOOM_FILTER_MIN_KEYS),
+                                                       bloom_bits_per_key_);
+  for (auto hash : hashes) {
+    bloom_filter_->Insert(hash);
+  }
+  bloom_keys_ = hashes.size();
+  bloom_removed_keys_ = 0;
+  bloom_stale_ = false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct insert index key
+  KeyType index_key = MakeKey(key, rid);
+
+  if (container_.Insert(index_key, rid, transaction)) {
+    BloomFilterInsert(index_key);
+  }
+}
 
-  container_.Insert(index_key, rid, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries,
+                                         Transaction *transaction) {
+  std::vector<std::pair<KeyType, ValueType>> index_entries;
+  index_entries.reserve(entries.size());
+  for (const auto &[key, rid] : entries) {
+    index_entries.emplace_back(MakeKey(key, rid), rid);
+  }
+  // 排好序后落在同一个叶子的key挨在一起，一次下降就能插完
+  std::sort(index_entries.begin(), index_entries.end(),
+            [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; });
+  container_.InsertBatch(index_entries, transaction);
+  for (const auto &[index_key, rid] : index_entries) {
+    BloomFilterInsert(index_key);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  KeyType index_key = MakeKey(key, rid);
 
   container_.Remove(index_key, transaction);
+  // 布隆过滤器删不掉key，删掉的太多时重建
+  std::unique_lock<std::shared_mutex> l(bloom_latch_);
+  if (bloom_bits_per_key_ > 0 && ++bloom_removed_keys_ * 2 >= bloom_keys_) {
+    bloom_stale_ = true;
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  KeyType index_key = MakeKey(key, RID());
+  // 结果都是追加的；布隆过滤器排除的key和树里查不到一样，不动调用方已有的结果
+  if (!BloomFilterMayContain(index_key)) {
+    return;
+  }
+  if (!comparator_.HasRidSuffix()) {
+    // 树的 GetValue 会先清空输出
+    std::vector<RID> rids;
+    if (container_.GetValue(index_key, &rids, transaction)) {
+      result->insert(result->end(), rids.begin(), rids.end());
+    }
+    return;
+  }
+  // 非唯一索引: 同一个key的所有条目连续存放，做一次[key, key]的范围扫描
+  auto scan = ScanRange(&key, &key, RangeInclusivity{}, ScanDirection::FORWARD, std::numeric_limits<size_t>::max(),
+                        transaction);
+  std::vector<RID> batch;
+  while (scan->NextBatch(&batch)) {
+    result->insert(result->end(), batch.begin(), batch.end());
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                    Transaction *transaction) {
+  // 按key排序并去重，整批只需要顺着叶子链表走一遍
+  // 被布隆过滤器排除的key不参与排序，也不对应任何范围
+  std::vector<KeyType> index_keys;
+  std::vector<size_t> order;
+  index_keys.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys.push_back(MakeKey(keys[i], MIN_RID));
+    if (BloomFilterMayContain(index_keys.back())) {
+      order.push_back(i);
+    }
+  }
+  std::sort(order.begin(), order.end(),
+            [&](size_t lhs, size_t rhs) { return comparator_(index_keys[lhs], index_keys[rhs]) < 0; });
 
-  container_.GetValue(index_key, result, transaction);
+  std::vector<std::pair<KeyType, KeyType>> ranges;
+  const size_t no_range = keys.size();
+  std::vector<size_t> range_of(keys.size(), no_range);
+  for (size_t i = 0; i < order.size(); i++) {
+    const auto &index_key = index_keys[order[i]];
+    if (ranges.empty() || comparator_(ranges.back().first, index_key) != 0) {
+      // 非唯一索引里一个key对应(key, 最小RID)到(key, 最大RID)的一段
+      ranges.emplace_back(index_key, comparator_.HasRidSuffix() ? MakeKey(keys[order[i]], MAX_RID) : index_key);
+    }
+    range_of[order[i]] = ranges.size() - 1;
+  }
+
+  std::vector<std::vector<RID>> range_results;
+  container_.GetValueRanges(ranges, &range_results, transaction);
+  results->assign(keys.size(), {});
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (range_of[i] != no_range) {
+      (*results)[i] = range_results[range_of[i]];
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::ScanRange(const Tuple *low, const Tuple *high, RangeInclusivity inclusivity,
+                                     ScanDirection direction, size_t batch_size, Transaction *transaction)
+    -> std::unique_ptr<IndexRangeScan> {
+  BUSTUB_ASSERT(batch_size > 0, "empty batches");
+  // 边界key: 非唯一索引里用最小/最大RID把边界上的key全部包含或全部排除
+  std::optional<KeyType> low_key;
+  std::optional<KeyType> high_key;
+  if (low != nullptr) {
+    low_key = MakeKey(*low, inclusivity.low_inclusive_ ? MIN_RID : MAX_RID);
+  }
+  if (high != nullptr) {
+    high_key = MakeKey(*high, inclusivity.high_inclusive_ ? MAX_RID : MIN_RID);
+  }
+
+  if (direction == ScanDirection::FORWARD) {
+    auto iter = low_key.has_value() ? container_.Begin(*low_key) : container_.Begin();
+    if (low_key.has_value() && !inclusivity.low_inclusive_) {
+      // 唯一索引里Begin可能正好停在low上
+      while (!iter.IsEnd() && comparator_((*iter).first, *low_key) <= 0) {
+        ++iter;
+      }
+    }
+    return std::make_unique<BPlusTreeRangeScan<KeyType, ValueType, KeyComparator>>(
+        std::move(iter), high_key, inclusivity.high_inclusive_, direction, batch_size, comparator_, this);
+  }
+  auto iter = high_key.has_value() ? container_.RBegin(*high_key) : container_.RBegin();
+  if (high_key.has_value() && !inclusivity.high_inclusive_) {
+    // 唯一索引里RBegin可能正好停在high上
+    while (!iter.IsEnd() && comparator_((*iter).first, *high_key) >= 0) {
+      --iter;
+    }
+  }
+  return std::make_unique<BPlusTreeRangeScan<KeyType, ValueType, KeyComparator>>(
+      std::move(iter), low_key, inclusivity.low_inclusive_, direction, batch_size, comparator_, this);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+BPlusTreeRangeScan<KeyType, ValueType, KeyComparator>::BPlusTreeRangeScan(INDEXITERATOR_TYPE &&iter,
+                                                                          std::optional<KeyType> stop_key,
+                                                                          bool stop_inclusive, ScanDirection direction,
+                                                                          size_t batch_size,
+                                                                          const KeyComparator &comparator,
+                                                                          const BPLUSTREE_INDEX_TYPE *index)
+    : iter_(std::move(iter)),
+      stop_key_(std::move(stop_key)),
+      stop_inclusive_(stop_inclusive),
+      direction_(direction),
+      batch_size_(batch_size),
+      comparator_(comparator),
+      index_(index) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPlusTreeRangeScan<KeyType, ValueType, KeyComparator>::NextBatch(std::vector<RID> *result) -> bool {
+  return Advance(result, nullptr);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPlusTreeRangeScan<KeyType, ValueType, KeyComparator>::NextEntryBatch(std::vector<RID> *result,
+                                                                           std::vector<Tuple> *entries) -> bool {
+  return Advance(result, entries);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPlusTreeRangeScan<KeyType, ValueType, KeyComparator>::Advance(std::vector<RID> *result,
+                                                                    std::vector<Tuple> *entries) -> bool {
+  result->clear();
+  if (entries != nullptr) {
+    entries->clear();
+  }
+  const bool forward = direction_ == ScanDirection::FORWARD;
+  while (result->size() < batch_size_ && !iter_.IsEnd()) {
+    const auto &[key, rid] = *iter_;
+    if (stop_key_.has_value()) {
+      // 反向扫描时把比较结果取反，统一成"越过终点"的判断
+      int res = comparator_(key, *stop_key_) * (forward ? 1 : -1);
+      if (stop_inclusive_ ? res > 0 : res >= 0) {
+        // 超出范围，提前放掉还pin着的叶子
+        iter_ = INDEXITERATOR_TYPE();
+        break;
+      }
+    }
+    result->push_back(rid);
+    if (entries != nullptr) {
+      entries->push_back(index_->EntryFromKey(key));
+    }
+    if (forward) {
+      ++iter_;
+    } else {
+      --iter_;
+    }
+  }
+  return !result->empty();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -63,4 +383,10 @@ template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTreeRangeScan<GenericKey<4>, RID, GenericComparator<4>>;
+template class BPlusTreeRangeScan<GenericKey<8>, RID, GenericComparator<8>>;
+template class BPlusTreeRangeScan<GenericKey<16>, RID, GenericComparator<16>>;
+template class BPlusTreeRangeScan<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTreeRangeScan<GenericKey<64>, RID, GenericComparator<64>>;
+
 }  // namespace bustub
@@ -20,7 +20,8 @@ void HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.Insert(transaction, index_key, rid);
+  // 唯一索引里已有这个key时不再插入，和B+树索引一致；查重在哈希表里和插入一起做
+  container_.Insert(transaction, index_key, rid, IsUnique());
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
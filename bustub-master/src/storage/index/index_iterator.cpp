@@ -19,24 +19,55 @@ INDEXITERATOR_TYPE::IndexIterator(B_PLUS_TREE_LEAF_PAGE_TYPE *start, int index,
     : leaf_page_(start), buf_(buf), index_(index) {}
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+INDEXITERATOR_TYPE::~IndexIterator() {  // NOLINT
+  // 没走到结尾就被丢弃的迭代器还pin着当前叶子页
+  if (leaf_page_ != nullptr) {
+    buf_->UnpinPage(leaf_page_->GetPageId(), false);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : leaf_page_(other.leaf_page_), buf_(other.buf_), index_(other.index_) {
+  other.leaf_page_ = nullptr;
+  other.index_ = -1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept -> INDEXITERATOR_TYPE & {
+  if (this != &other) {
+    if (leaf_page_ != nullptr) {
+      buf_->UnpinPage(leaf_page_->GetPageId(), false);
+    }
+    leaf_page_ = other.leaf_page_;
+    buf_ = other.buf_;
+    index_ = other.index_;
+    other.leaf_page_ = nullptr;
+    other.index_ = -1;
+  }
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::IsEnd() -> bool { return leaf_page_ == nullptr; }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return leaf_page_->GetPair(index_); }
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
+  item_ = leaf_page_->GetPair(index_);
+  return item_;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
   if (++index_ >= leaf_page_->GetSize()) {
     page_id_t page_id = leaf_page_->GetNextPageId();
     if (page_id == INVALID_PAGE_ID) {
+      buf_->UnpinPage(leaf_page_->GetPageId(), false);
       leaf_page_ = nullptr;
       index_ = -1;
     } else {
       auto page = buf_->FetchPage(page_id);
-      buf_->UnpinPage(leaf_page_->GetPageId(), true);
+      buf_->UnpinPage(leaf_page_->GetPageId(), false);
       leaf_page_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
       assert(leaf_page_ != nullptr);
       index_ = 0;
@@ -45,6 +76,24 @@ auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
   return *this;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator--() -> INDEXITERATOR_TYPE & {
+  if (--index_ < 0) {
+    page_id_t page_id = leaf_page_->GetPrevPageId();
+    buf_->UnpinPage(leaf_page_->GetPageId(), false);
+    if (page_id == INVALID_PAGE_ID) {
+      leaf_page_ = nullptr;
+      index_ = -1;
+    } else {
+      auto page = buf_->FetchPage(page_id);
+      assert(page != nullptr);
+      leaf_page_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
+      index_ = leaf_page_->GetSize() - 1;
+    }
+  }
+  return *this;
+}
+
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
 template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -21,12 +22,17 @@ namespace bustub {
  *****************************************************************************/
 /*
  * Init method after creating a new internal page
- * Including set page type, set current size, set page id, set parent id and set
- * max page size
+ * Including set page type, set current size, set page id and set max page size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
-  SetParentPageId(parent_id);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, int max_size) {
+  // 页直接覆盖在原始字节上：header后紧跟key数组和page_id数组，没有vtable和填充
+  static_assert(!std::is_polymorphic_v<BPlusTreeInternalPage>);
+  static_assert(sizeof(BPlusTreeInternalPage) ==
+                INTERNAL_PAGE_HEADER_SIZE + INTERNAL_PAGE_SLOT_CNT * (sizeof(KeyType) + sizeof(ValueType)));
+  static_assert(sizeof(BPlusTreeInternalPage) <= BUSTUB_PAGE_SIZE);
+  // 分裂前会临时多放一个孩子
+  assert(max_size > 0 && static_cast<size_t>(max_size) < INTERNAL_PAGE_SLOT_CNT);
   SetPageId(page_id);
   SetMaxSize(max_size);
   SetPageType(IndexPageType::INTERNAL_PAGE);
@@ -39,17 +45,17 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
   // replace with your own code
-  return array_[index].first;
+  return keys_[index];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
-  array_[index].first = key;
+  keys_[index] = key;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
-  array_[index].second = value;
+  values_[index] = value;
 }
 
 /*
@@ -57,7 +63,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &valu
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return values_[index]; }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::FindValueIndex(const ValueType &value) -> int {
@@ -71,19 +77,9 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::FindValueIndex(const ValueType &value) -> i
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::FindLowerBound(const KeyType &key, const KeyComparator &cmp) const -> ValueType {
-  // 二分查找大于key的index,通过return l - 1 来返回大于key的page_id
+  // 在[1, size)中找第一个大于key的下标，它的前一个孩子就是要走的page_id
   assert(GetSize() > 1);
-  int st = 1;
-  int ed = GetSize() - 1;
-  while (st <= ed) {  // find the last key in array <= input
-    int mid = (ed - st) / 2 + st;
-    if (cmp(array_[mid].first, key) <= 0) {
-      st = mid + 1;
-    } else {
-      ed = mid - 1;
-    }
-  }
-  return array_[st - 1].second;
+  return values_[KeyUpperBound(keys_ + 1, GetSize() - 1, key, cmp)];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -93,9 +89,9 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertFirstInit(const ValueType &old_page_id, const ValueType &new_page_id,
                                                      const KeyType &key) {
   int index = 0;
-  array_[index++].second = old_page_id;
-  array_[index].first = key;
-  array_[index].second = new_page_id;
+  values_[index++] = old_page_id;
+  keys_[index] = key;
+  values_[index] = new_page_id;
   SetSize(2);
 }
 
@@ -104,33 +100,23 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertKeyAfterIt(const ValueType &left_page
                                                       KeyComparator &cmp, const KeyType &key) -> int {
   int index = FindValueIndex(left_page_id);
   int cur_size = GetSize();
+  std::copy_backward(keys_ + index + 1, keys_ + cur_size, keys_ + cur_size + 1);
+  std::copy_backward(values_ + index + 1, values_ + cur_size, values_ + cur_size + 1);
+  keys_[index + 1] = key;
+  values_[index + 1] = right_page_id;
   SetSize(++cur_size);
-  for (int idx = cur_size - 1; idx > index + 1; --idx) {
-    array_[idx].first = array_[idx - 1].first;
-    array_[idx].second = array_[idx - 1].second;
-  }
-  array_[index + 1].first = key;
-  array_[index + 1].second = right_page_id;
   return cur_size;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SplitDataTo(B_PLUS_TREE_INTERNAL_PAGE_TYPE *right_page, BufferPoolManager *buf) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SplitDataTo(B_PLUS_TREE_INTERNAL_PAGE_TYPE *right_page, int left_size) {
   assert(right_page != nullptr);
-  // assert(GetSize() == total);
-  // copy last half
-  int copy_idx = GetSize() / 2;  // max:4 x,1,2,3,4 -> 2,3,4
-  page_id_t recip_page_id = right_page->GetPageId();
-  for (int i = copy_idx; i < GetSize(); i++) {
-    right_page->array_[i - copy_idx].first = array_[i].first;
-    right_page->array_[i - copy_idx].second = array_[i].second;
-    // update children's parent page
-    auto child_raw_page = buf->FetchPage(array_[i].second);
-    auto *child_tree_page = reinterpret_cast<BPlusTreePage *>(child_raw_page->GetData());
-    child_tree_page->SetParentPageId(recip_page_id);
-    buf->UnpinPage(array_[i].second, true);
-  }
-  // set size,is odd, bigger is last part
+  assert(left_size > 0 && left_size < GetSize());
+  // copy last part
+  int copy_idx = left_size;  // max:4 x,1,2,3,4 (left_size 2) -> 2,3,4
+  std::copy(keys_ + copy_idx, keys_ + GetSize(), right_page->keys_);
+  std::copy(values_ + copy_idx, values_ + GetSize(), right_page->values_);
+  // set size
   right_page->SetSize(GetSize() - copy_idx);
   SetSize(copy_idx);
 }
@@ -139,33 +125,16 @@ INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ChangeRoot() -> ValueType {
   assert(size_ == 1);
   IncreaseSize(-1);
-  return array_[0].second;
+  return values_[0];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MergeWith(BPlusTreePage *other_page_, int index_of_parent,
-                                               BufferPoolManager *buf) {
-  auto other_page = static_cast<BPlusTreeInternalPage *>(other_page_);
-  Page *page = buf->FetchPage(other_page->GetParentPageId());
-  assert(page != nullptr);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MergeWith(BPlusTreeInternalPage *other_page, const KeyType &middle_key) {
   int start = GetSize();
-  auto parent_page = reinterpret_cast<BPlusTreeInternalPage *>(page->GetData());
-
-  other_page->SetKeyAt(0, parent_page->KeyAt(index_of_parent));  // 关键！指向当前节点的父节点的下标的key是当前节点0下标的key!
-  // array_[start].second = other_page->ValueAt(0);
-  buf->UnpinPage(parent_page->GetPageId(), false);
-
-
-  for (int i = 0; i < other_page->GetSize(); i++) {
-    array_[start + i].first = other_page->KeyAt(i);
-    array_[start + i].second = other_page->ValueAt(i);
-
-    Page *sufpage = buf->FetchPage(other_page->ValueAt(i));
-    auto *child_page = reinterpret_cast<BPlusTreeInternalPage *>(sufpage->GetData());
-    child_page->SetParentPageId(page_id_);
-    buf->UnpinPage(array_[i].second, true);
-  }
-
+  std::copy(other_page->keys_, other_page->keys_ + other_page->GetSize(), keys_ + start);
+  std::copy(other_page->values_, other_page->values_ + other_page->GetSize(), values_ + start);
+  // 关键！右兄弟0下标的key是无效的，用父节点中指向它的key补上
+  keys_[start] = middle_key;
   SetSize(start + other_page->GetSize());
   assert(GetSize() <= GetMaxSize());
   other_page->SetSize(0);
@@ -174,68 +143,42 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MergeWith(BPlusTreePage *other_page_, int i
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::DeleteInternal(int index) -> int {
   int cur_size = GetSize();
-  assert(index >= 0 && index <= cur_size);
-  for (int i = index; i < cur_size - 1; i++) {
-    array_[i].first = array_[i + 1].first;
-    array_[i].second = array_[i + 1].second;
-  }
+  assert(index >= 0 && index < cur_size);
+  std::copy(keys_ + index + 1, keys_ + cur_size, keys_ + index);
+  std::copy(values_ + index + 1, values_ + cur_size, values_ + index);
   IncreaseSize(-1);
   return GetSize();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *other_page, BufferPoolManager *buf) {
-  assert(parent_page_id_ == other_page->GetParentPageId());
-  for (int i = GetSize(); i > 0; i--) {
-    other_page->array_[i].first = other_page->array_[i - 1].first;
-    other_page->array_[i].second = other_page->array_[i - 1].second;
-  }
-
-  auto page = buf->FetchPage(parent_page_id_);
-  auto parent_page = reinterpret_cast<BPlusTreeInternalPage *>(page->GetData());
-  int index = parent_page->FindValueIndex(other_page->page_id_);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *other_page,
+                                                       BPlusTreeInternalPage *parent_page, int index) {
+  // other_page是当前节点的右兄弟，index是父节点中指向other_page的下标
+  int other_size = other_page->GetSize();
+  std::copy_backward(other_page->keys_, other_page->keys_ + other_size, other_page->keys_ + other_size + 1);
+  std::copy_backward(other_page->values_, other_page->values_ + other_size, other_page->values_ + other_size + 1);
 
   other_page->SetKeyAt(1, parent_page->KeyAt(index));
   other_page->SetValueAt(0, ValueAt(GetSize() - 1));
-
   parent_page->SetKeyAt(index, KeyAt(GetSize() - 1));
 
-  auto child = buf->FetchPage(ValueAt(GetSize() - 1));
-  auto child_page = reinterpret_cast<BPlusTreePage *>(child->GetData());
-  child_page->SetParentPageId(other_page->page_id_);
-  buf->UnpinPage(child_page->GetPageId(), true);
-  buf->UnpinPage(parent_page->GetPageId(), true);
   IncreaseSize(-1);
   other_page->IncreaseSize(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFrontToLastOf(BPlusTreeInternalPage *other_page, BufferPoolManager *buf) {
-  assert(parent_page_id_ == other_page->GetParentPageId());
-
-  auto page = buf->FetchPage(parent_page_id_);
-  auto parent_page = reinterpret_cast<BPlusTreeInternalPage *>(page->GetData());
-  int index = parent_page->FindValueIndex(page_id_);
-
-
-  int xx = other_page->GetSize();
-  other_page->SetKeyAt(xx, parent_page->KeyAt(index));
-  other_page->SetValueAt(xx, ValueAt(0));
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFrontToLastOf(BPlusTreeInternalPage *other_page,
+                                                       BPlusTreeInternalPage *parent_page, int index) {
+  // other_page是当前节点的左兄弟，index是父节点中指向当前节点的下标
+  int other_size = other_page->GetSize();
+  other_page->SetKeyAt(other_size, parent_page->KeyAt(index));
+  other_page->SetValueAt(other_size, ValueAt(0));
   other_page->IncreaseSize(1);
 
+  assert(GetSize() > 1);
   parent_page->SetKeyAt(index, KeyAt(1));
-
-  assert(GetSize() - 1 > 0);
-  for (int i = 0; i < GetSize() - 1; i++) {
-    array_[i].first = array_[i + 1].first;
-    array_[i].second = array_[i + 1].second;
-  }
-
-  auto child = buf->FetchPage(other_page->ValueAt(GetSize() - 1));
-  auto child_page = reinterpret_cast<BPlusTreePage *>(child->GetData());
-  child_page->SetParentPageId(other_page->page_id_);
-  buf->UnpinPage(child_page->GetPageId(), true);
-  buf->UnpinPage(parent_page->GetPageId(), true);
+  std::copy(keys_ + 1, keys_ + GetSize(), keys_);
+  std::copy(values_ + 1, values_ + GetSize(), values_);
   IncreaseSize(-1);
 }
 
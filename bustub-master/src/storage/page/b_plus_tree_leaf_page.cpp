@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
 
 #include "common/exception.h"
@@ -24,17 +25,23 @@ namespace bustub {
 
 /**
  * Init method after creating a new leaf page
- * Including set page type, set current size to zero, set page id/parent id, set
- * next page id and set max size
+ * Including set page type, set current size to zero, set page id, set next page
+ * id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
-  SetParentPageId(parent_id);
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, int max_size) {
+  // 页直接覆盖在原始字节上：header后紧跟key数组和value数组，没有vtable和填充
+  static_assert(!std::is_polymorphic_v<BPlusTreeLeafPage>);
+  static_assert(sizeof(BPlusTreeLeafPage) ==
+                LEAF_PAGE_HEADER_SIZE + LEAF_PAGE_SLOT_CNT * (sizeof(KeyType) + sizeof(ValueType)));
+  static_assert(sizeof(BPlusTreeLeafPage) <= BUSTUB_PAGE_SIZE);
+  assert(max_size > 0 && static_cast<size_t>(max_size) <= LEAF_PAGE_SLOT_CNT);
   SetPageId(page_id);
   SetMaxSize(max_size);
   SetPageType(IndexPageType::LEAF_PAGE);
   SetSize(0);
   SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
 }
 
 /**
@@ -46,6 +53,15 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return nex
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+/**
+ * Helper methods to set/get prev page id
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const -> page_id_t { return prev_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
+
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
@@ -53,25 +69,28 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
   // replace with your own code
-  return array_[index].first;
+  return keys_[index];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { keys_[index] = key; }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
   // replace with your own code
-  array_[index].second = value;
+  values_[index] = value;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return values_[index]; }
+
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindKey(const KeyType &key, ValueType &value, KeyComparator &cmp) -> bool {
   // 先找到当前key所在的索引
-  int index = FindkeyIndex(key, cmp);
+  int index = FindKeyIndex(key, cmp);
   // 如果索引存在且和预期值相等，则将值返回并return true
   if (index < GetSize() && cmp(KeyAt(index), key) == 0) {
-    value = array_[index].second;
+    value = values_[index];
     return true;
   }
   return false;
@@ -80,7 +99,7 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindKey(const KeyType &key, ValueType &value, K
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindValueIndex(const ValueType &value) -> int {
   for (int i = 0; i < GetSize(); i++) {
-    if (array_[i].second == value) {
+    if (values_[i] == value) {
       return i;
     }
   }
@@ -88,130 +107,94 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindValueIndex(const ValueType &value) -> int {
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindKeyIndex(const KeyType &key, KeyComparator &cmp) -> int {
-  for (int i = 0; i < GetSize(); i++) {
-    if (cmp(array_[i].first, key) == 0) {
-      return i;
-    }
-  }
-  return -1;
-}
-
-template <typename KeyType, typename ValueType, typename KeyComparator>
-auto BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>::FindkeyIndex(const KeyType &key, KeyComparator &cmp) -> int {
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::FindKeyIndex(const KeyType &key, const KeyComparator &cmp) const -> int {
   assert(GetSize() >= 0);
-  int st = 0;
-  int ed = GetSize() - 1;
-  while (st <= ed) {  // find the last key in array <= input
-    int mid = (ed - st) / 2 + st;
-    if (cmp(array_[mid].first, key) >= 0) {
-      ed = mid - 1;
-    } else {
-      st = mid + 1;
-    }
-  }
-  return ed + 1;
+  // 整数key走SIMD/无分支查找，其他类型退化为比较器二分
+  return KeyLowerBound(keys_, GetSize(), key, cmp);
 }
+
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, KeyComparator &cmp) -> int {
   // 找到合适的插入位置
-  int index = FindkeyIndex(key, cmp);
+  int index = FindKeyIndex(key, cmp);
   int cur_size = GetSize();
+  std::copy_backward(keys_ + index, keys_ + cur_size, keys_ + cur_size + 1);
+  std::copy_backward(values_ + index, values_ + cur_size, values_ + cur_size + 1);
+  keys_[index] = key;
+  values_[index] = value;
   SetSize(++cur_size);
-  for (int idx = cur_size - 1; idx > index; --idx) {
-    array_[idx].first = array_[idx - 1].first;
-    array_[idx].second = array_[idx - 1].second;
-  }
-  array_[index].first = key;
-  array_[index].second = value;
   return cur_size;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SplitDataTo(B_PLUS_TREE_LEAF_PAGE_TYPE *new_leaf_page,
-                                             __attribute__((unused)) BufferPoolManager *buf) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SplitDataTo(B_PLUS_TREE_LEAF_PAGE_TYPE *new_leaf_page, int left_size) {
   assert(new_leaf_page != nullptr);
-  for (int idx = GetSize() / 2, new_idx = 0; idx < GetSize(); idx++, new_idx++) {
-    new_leaf_page->array_[new_idx].first = array_[idx].first;
-    new_leaf_page->array_[new_idx].second = array_[idx].second;
-  }
-  SetSize(GetSize() / 2);
-  new_leaf_page->SetSize(max_size_ - size_);
+  assert(left_size > 0 && left_size < GetSize());
+  int copy_idx = left_size;
+  std::copy(keys_ + copy_idx, keys_ + GetSize(), new_leaf_page->keys_);
+  std::copy(values_ + copy_idx, values_ + GetSize(), new_leaf_page->values_);
+  new_leaf_page->SetSize(GetSize() - copy_idx);
+  SetSize(copy_idx);
+  // 新页插在当前页和原来的下一页之间，原下一页的prev由调用者修改
   new_leaf_page->next_page_id_ = next_page_id_;
+  new_leaf_page->prev_page_id_ = page_id_;
   next_page_id_ = new_leaf_page->page_id_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Delete(const KeyType &key, KeyComparator &cmp) -> int {
-  int index = FindkeyIndex(key, cmp);
+  int index = FindKeyIndex(key, cmp);
   int cur_size = GetSize();
-  if (index < cur_size && cmp(array_[index].first, key) == 0) {
-    for (int i = index; i < GetSize() - 1; i++) {
-      array_[i].first = array_[i + 1].first;
-      array_[i].second = array_[i + 1].second;
-    }
+  if (index < cur_size && cmp(keys_[index], key) == 0) {
+    std::copy(keys_ + index + 1, keys_ + cur_size, keys_ + index);
+    std::copy(values_ + index + 1, values_ + cur_size, values_ + index);
     IncreaseSize(-1);
   }
   return GetSize();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MergeWith(BPlusTreePage *other_page_,
-                                           int index_of_parent, BufferPoolManager *buf) {
-  auto other_page = static_cast<BPlusTreeLeafPage *>(other_page_);
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MergeWith(BPlusTreeLeafPage *other_page) {
   int start = GetSize();
-    for (int i = 0; i < other_page->GetSize(); i++) {
-      array_[start + i].first = other_page->KeyAt(i);
-      array_[start + i].second = other_page->array_[i].second;
-    }
+  std::copy(other_page->keys_, other_page->keys_ + other_page->GetSize(), keys_ + start);
+  std::copy(other_page->values_, other_page->values_ + other_page->GetSize(), values_ + start);
 
   SetNextPageId(other_page->GetNextPageId());
   SetSize(start + other_page->GetSize());
   assert(start + other_page->GetSize() <= GetMaxSize());
+  other_page->SetSize(0);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *other_page, BufferPoolManager *buf) {
-  // memmove(other_page->array_ + 1, other_page->array_, GetSize()*sizeof(MappingType));
-  for (int i = GetSize(); i > 0; i--) {
-    other_page->array_[i].first = other_page->array_[i - 1].first;
-    other_page->array_[i].second = other_page->array_[i - 1].second;
-  }
-  other_page->SetKeyAt(0, array_[GetSize() - 1].first);
-  other_page->SetValueAt(0, array_[GetSize() - 1].second);
-
-  auto page = buf->FetchPage(other_page->GetParentPageId());
-  auto parent_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(page->GetData());
-
-  int index = parent_page->FindValueIndex(other_page->GetPageId());
-  parent_page->SetKeyAt(index, other_page->array_[0].first);
-  buf->UnpinPage(parent_page->GetPageId(), true);
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *other_page, InternalPage *parent_page,
+                                                   int index) {
+  // other_page是当前节点的右兄弟，index是父节点中指向other_page的下标
+  int other_size = other_page->GetSize();
+  std::copy_backward(other_page->keys_, other_page->keys_ + other_size, other_page->keys_ + other_size + 1);
+  std::copy_backward(other_page->values_, other_page->values_ + other_size, other_page->values_ + other_size + 1);
+  other_page->SetKeyAt(0, keys_[GetSize() - 1]);
+  other_page->SetValueAt(0, values_[GetSize() - 1]);
+  parent_page->SetKeyAt(index, other_page->keys_[0]);
   IncreaseSize(-1);
   other_page->IncreaseSize(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFrontToLastOf(BPlusTreeLeafPage *other_page, BufferPoolManager *buf) {
-  other_page->SetKeyAt(other_page->GetSize(), array_[0].first);
-  other_page->SetValueAt(other_page->GetSize(), array_[0].second);
-
-  for (int i = 0; i < GetSize() - 1; i++) {
-    array_[i].first = array_[i + 1].first;
-    array_[i].second = array_[i + 1].second;
-  }
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFrontToLastOf(BPlusTreeLeafPage *other_page, InternalPage *parent_page,
+                                                   int index) {
+  // other_page是当前节点的左兄弟，index是父节点中指向当前节点的下标
+  other_page->SetKeyAt(other_page->GetSize(), keys_[0]);
+  other_page->SetValueAt(other_page->GetSize(), values_[0]);
 
-  auto page = buf->FetchPage(GetParentPageId());
-  auto parent_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(page->GetData());
-  int idx = 0;
-  int index = parent_page->FindValueIndex(GetPageId());
-  parent_page->SetKeyAt(index, array_[idx].first);
-  buf->UnpinPage(parent_page->GetPageId(), true);
+  std::copy(keys_ + 1, keys_ + GetSize(), keys_);
+  std::copy(values_ + 1, values_ + GetSize(), values_);
+  parent_page->SetKeyAt(index, keys_[0]);
   IncreaseSize(-1);
   other_page->IncreaseSize(1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPair(int index) -> MappingType & { return array_[index]; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPair(int index) const -> MappingType { return {keys_[index], values_[index]}; }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
@@ -17,11 +17,10 @@ namespace bustub {
  * Helper methods to get/set page type
  * Page type enum class is defined in b_plus_tree_page.h
  */
-BPlusTreePage::BPlusTreePage(page_id_t page_id, page_id_t parent_page_id, int max_size, int size)
-    : size_(size), max_size_(max_size), parent_page_id_(parent_page_id), page_id_(page_id) {}
+BPlusTreePage::BPlusTreePage(page_id_t page_id, int max_size, int size)
+    : size_(size), max_size_(max_size), page_id_(page_id) {}
 
 auto BPlusTreePage::IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
-auto BPlusTreePage::IsRootPage() const -> bool { return parent_page_id_ == INVALID_PAGE_ID; }
 void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
 
 /*
@@ -39,21 +38,12 @@ auto BPlusTreePage::GetMaxSize() const -> int { return max_size_; }
 void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
 
 /*
- * Helper method to get min page size
- * Generally, min page size == max page size / 2
+ * Helper method to get min page size of a non-root page
+ * A leaf splits once it reaches max size, an internal page once it exceeds it,
+ * so the smaller half of a split is max / 2 resp. (max + 1) / 2.
+ * The root is allowed to go below this, the tree handles it separately.
  */
-auto BPlusTreePage::GetMinSize() const -> int {
-  if (IsRootPage()) {
-    return IsLeafPage() ? 1 : 2;
-  }
-  return max_size_ / 2;
-}
-
-/*
- * Helper methods to get/set parent page id
- */
-auto BPlusTreePage::GetParentPageId() const -> page_id_t { return parent_page_id_; }
-void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) { parent_page_id_ = parent_page_id; }
+auto BPlusTreePage::GetMinSize() const -> int { return IsLeafPage() ? max_size_ / 2 : (max_size_ + 1) / 2; }
 
 /*
  * Helper methods to get/set self page id
@@ -66,6 +56,4 @@ void BPlusTreePage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
  */
 void BPlusTreePage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 
-// void BPlusTreePage::MergeWith(BPlusTreePage *other_page_, int index_of_parent, BufferPoolManager *buf) {}
-
 }  // namespace bustub
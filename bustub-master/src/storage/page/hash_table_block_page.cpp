@@ -17,30 +17,48 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const -> KeyType {
-  return {};
+  return array_[bucket_ind].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const -> ValueType {
-  return {};
+  return array_[bucket_ind].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  // 用原子的fetch_or抢占槽位，同时插入同一个槽的线程只有一个能成功
+  const auto mask = static_cast<char>(1 << (bucket_ind % 8));
+  if ((occupied_[bucket_ind / 8].fetch_or(mask) & mask) != 0) {
+    return false;
+  }
+  array_[bucket_ind] = MappingType(key, value);
+  readable_[bucket_ind / 8].fetch_or(mask);
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {}
+void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  // 只清可读位，槽位保持占用，作为墓碑不打断探测链
+  readable_[bucket_ind / 8].fetch_and(static_cast<char>(~(1 << (bucket_ind % 8))));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::Clear(slot_offset_t bucket_ind) {
+  // 先清可读位再清占用位，槽位重新变成从未占用，可以终止探测
+  const auto mask = static_cast<char>(~(1 << (bucket_ind % 8)));
+  readable_[bucket_ind / 8].fetch_and(mask);
+  occupied_[bucket_ind / 8].fetch_and(mask);
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const -> bool {
-  return false;
+  return (occupied_[bucket_ind / 8].load() & (1 << (bucket_ind % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const -> bool {
-  return false;
+  return (readable_[bucket_ind / 8].load() & (1 << (bucket_ind % 8))) != 0;
 }
 
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
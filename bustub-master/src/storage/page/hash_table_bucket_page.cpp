@@ -11,6 +11,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/page/hash_table_bucket_page.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include "common/logger.h"
 #include "common/util/hash_util.h"
 #include "storage/index/generic_key.h"
@@ -19,63 +27,187 @@
 
 namespace bustub {
 
+/** All slots of a group */
+static constexpr uint32_t FULL_GROUP = (1U << BUCKET_GROUP_SIZE) - 1;
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Fingerprint(const KeyType &key) -> uint8_t {
+  // 按8字节一段混合key的所有字节；分到同一个桶的key哈希低位相同，所以指纹取混合结果的高位
+  const auto *bytes = reinterpret_cast<const char *>(&key);
+  uint64_t hash = 0;
+  for (size_t offset = 0; offset < sizeof(KeyType); offset += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, bytes + offset, std::min(sizeof(uint64_t), sizeof(KeyType) - offset));
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 29;
+  }
+  return static_cast<uint8_t>(hash >> 56);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::GroupBits(const char *bitmap, uint32_t group) -> uint32_t {
+  // 一组16个槽的位图正好是两个字节，小端读出来第i位就是组里第i个槽
+  uint16_t bits;
+  memcpy(&bits, bitmap + group * BUCKET_GROUP_SIZE / 8, sizeof(bits));
+  return bits;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::MatchFingerprint(uint32_t group, uint8_t fingerprint) const -> uint32_t {
+  const uint8_t *fingerprints = fingerprints_ + group * BUCKET_GROUP_SIZE;
+#if defined(__SSE2__)
+  __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(fingerprints));
+  __m128i match = _mm_cmpeq_epi8(data, _mm_set1_epi8(static_cast<char>(fingerprint)));
+  return static_cast<uint32_t>(_mm_movemask_epi8(match));
+#else
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < BUCKET_GROUP_SIZE; i++) {
+    mask |= static_cast<uint32_t>(fingerprints[i] == fingerprint) << i;
+  }
+  return mask;
+#endif
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
-  return false;
+  static_assert(sizeof(HASH_TABLE_BUCKET_TYPE) + (BUCKET_ARRAY_SIZE - 1) * sizeof(MappingType) <= BUSTUB_PAGE_SIZE,
+                "bucket does not fit into a page");
+  const uint8_t fingerprint = Fingerprint(key);
+  bool found = false;
+  for (uint32_t group = 0; group < BUCKET_GROUP_COUNT; group++) {
+    // 只有指纹相同的可读槽才需要比较完整的key
+    uint32_t matches = MatchFingerprint(group, fingerprint) & GroupBits(readable_, group);
+    while (matches != 0) {
+      uint32_t bucket_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(matches);
+      matches &= matches - 1;
+      if (cmp(array_[bucket_idx].first, key) == 0) {
+        result->push_back(array_[bucket_idx].second);
+        found = true;
+      }
+    }
+    // 占用过的槽总是连续排在前面，这一组里有没占用过的槽就可以停下
+    if (GroupBits(occupied_, group) != FULL_GROUP) {
+      break;
+    }
+  }
+  return found;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+  const uint8_t fingerprint = Fingerprint(key);
+  int64_t free_idx = -1;
+  for (uint32_t group = 0; group < BUCKET_GROUP_COUNT; group++) {
+    uint32_t readable = GroupBits(readable_, group);
+    uint32_t matches = MatchFingerprint(group, fingerprint) & readable;
+    while (matches != 0) {
+      uint32_t bucket_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(matches);
+      matches &= matches - 1;
+      if (cmp(array_[bucket_idx].first, key) == 0 && array_[bucket_idx].second == value) {
+        return false;
+      }
+    }
+    if (free_idx == -1) {
+      // 墓碑和没占用过的槽都能用，但还要接着往后查重；最后一组可能有超出BUCKET_ARRAY_SIZE的槽
+      uint32_t free_slots = ~readable & FULL_GROUP;
+      if (free_slots != 0) {
+        free_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(free_slots);
+        if (free_idx >= static_cast<int64_t>(BUCKET_ARRAY_SIZE)) {
+          free_idx = -1;
+        }
+      }
+    }
+    if (GroupBits(occupied_, group) != FULL_GROUP) {
+      break;
+    }
+  }
+  if (free_idx == -1) {
+    return false;
+  }
+  array_[free_idx] = MappingType(key, value);
+  fingerprints_[free_idx] = fingerprint;
+  SetOccupied(free_idx);
+  SetReadable(free_idx);
   return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+  const uint8_t fingerprint = Fingerprint(key);
+  for (uint32_t group = 0; group < BUCKET_GROUP_COUNT; group++) {
+    uint32_t matches = MatchFingerprint(group, fingerprint) & GroupBits(readable_, group);
+    while (matches != 0) {
+      uint32_t bucket_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(matches);
+      matches &= matches - 1;
+      if (cmp(array_[bucket_idx].first, key) == 0 && array_[bucket_idx].second == value) {
+        RemoveAt(bucket_idx);
+        return true;
+      }
+    }
+    if (GroupBits(occupied_, group) != FULL_GROUP) {
+      break;
+    }
+  }
   return false;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const -> KeyType {
-  return {};
+  return array_[bucket_idx].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const -> ValueType {
-  return {};
+  return array_[bucket_idx].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] &= static_cast<char>(~(1 << (bucket_idx % 8)));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsOccupied(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (occupied_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {
+  occupied_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsReadable(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (readable_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsFull() -> bool {
-  return false;
+  return NumReadable() == BUCKET_ARRAY_SIZE;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::NumReadable() -> uint32_t {
-  return 0;
+  uint32_t count = 0;
+  for (char bits : readable_) {
+    count += __builtin_popcount(static_cast<uint8_t>(bits));
+  }
+  return count;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsEmpty() -> bool {
-  return false;
+  for (char bits : readable_) {
+    if (bits != 0) {
+      return false;
+    }
+  }
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
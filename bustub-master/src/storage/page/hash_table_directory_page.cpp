@@ -26,29 +26,64 @@ void HashTableDirectoryPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 
 auto HashTableDirectoryPage::GetGlobalDepth() -> uint32_t { return global_depth_; }
 
-auto HashTableDirectoryPage::GetGlobalDepthMask() -> uint32_t { return 0; }
-
-void HashTableDirectoryPage::IncrGlobalDepth() {}
+auto HashTableDirectoryPage::GetGlobalDepthMask() -> uint32_t { return (1U << global_depth_) - 1; }
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  assert(Size() * 2 <= DIRECTORY_ARRAY_SIZE);
+  // 新的一半目录项是旧的一半的镜像，指向同样的桶
+  uint32_t size = Size();
+  for (uint32_t idx = 0; idx < size; idx++) {
+    bucket_page_ids_[idx + size] = bucket_page_ids_[idx];
+    local_depths_[idx + size] = local_depths_[idx];
+  }
+  global_depth_++;
+}
 
 void HashTableDirectoryPage::DecrGlobalDepth() { global_depth_--; }
 
-auto HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) -> page_id_t { return 0; }
+auto HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) -> page_id_t { return bucket_page_ids_[bucket_idx]; }
+
+void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+  bucket_page_ids_[bucket_idx] = bucket_page_id;
+}
+
+auto HashTableDirectoryPage::GetSplitImageIndex(uint32_t bucket_idx) -> uint32_t {
+  // 分裂镜像只在局部深度的最高位上不同
+  uint32_t local_depth = GetLocalDepth(bucket_idx);
+  return local_depth == 0 ? bucket_idx : bucket_idx ^ (1U << (local_depth - 1));
+}
 
-void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {}
+auto HashTableDirectoryPage::Size() -> uint32_t { return 1U << global_depth_; }
 
-auto HashTableDirectoryPage::Size() -> uint32_t { return 0; }
+auto HashTableDirectoryPage::CanShrink() -> bool {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t idx = 0; idx < Size(); idx++) {
+    if (local_depths_[idx] == global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
 
-auto HashTableDirectoryPage::CanShrink() -> bool { return false; }
+auto HashTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) -> uint32_t { return local_depths_[bucket_idx]; }
 
-auto HashTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) -> uint32_t { return 0; }
+void HashTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) {
+  local_depths_[bucket_idx] = local_depth;
+}
 
-void HashTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) {}
+void HashTableDirectoryPage::IncrLocalDepth(uint32_t bucket_idx) { local_depths_[bucket_idx]++; }
 
-void HashTableDirectoryPage::IncrLocalDepth(uint32_t bucket_idx) {}
+void HashTableDirectoryPage::DecrLocalDepth(uint32_t bucket_idx) { local_depths_[bucket_idx]--; }
 
-void HashTableDirectoryPage::DecrLocalDepth(uint32_t bucket_idx) {}
+auto HashTableDirectoryPage::GetLocalDepthMask(uint32_t bucket_idx) -> uint32_t {
+  return (1U << local_depths_[bucket_idx]) - 1;
+}
 
-auto HashTableDirectoryPage::GetLocalHighBit(uint32_t bucket_idx) -> uint32_t { return 0; }
+auto HashTableDirectoryPage::GetLocalHighBit(uint32_t bucket_idx) -> uint32_t {
+  return 1U << local_depths_[bucket_idx];
+}
 
 /**
  * VerifyIntegrity - Use this for debugging but **DO NOT CHANGE**
@@ -306,6 +306,25 @@ auto TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   return true;
 }
 
+auto TablePage::PeekTuple(const RID &rid, Tuple *view) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(tuple_size)) {
+    return false;
+  }
+  if (view->allocated_) {
+    delete[] view->data_;
+    view->allocated_ = false;
+  }
+  view->data_ = GetData() + GetTupleOffsetAtSlot(slot_num);
+  view->size_ = tuple_size;
+  view->rid_ = rid;
+  return true;
+}
+
 auto TablePage::GetFirstTupleRid(RID *first_rid) -> bool {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <utility>
 
 #include "common/logger.h"
 #include "storage/table/table_heap.h"
@@ -22,7 +23,19 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id) {
+  // 打开已有的表时沿链表走一遍，建出页目录
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    page_ids_.push_back(page_id);
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    page->RLatch();
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
@@ -35,6 +48,7 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
   first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
   first_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  page_ids_.push_back(first_page_id_);
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
@@ -77,6 +91,11 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
       new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      {
+        // 还持有链表尾页的写锁，并发插入的新页按链表顺序进目录
+        std::scoped_lock lock(directory_latch_);
+        page_ids_.push_back(next_page_id);
+      }
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
@@ -190,6 +209,41 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
   return {this, rid, txn};
 }
 
+auto TableHeap::GetPageIds() -> std::vector<page_id_t> {
+  std::scoped_lock lock(directory_latch_);
+  return page_ids_;
+}
+
+auto TableHeap::GetNumPages() -> size_t {
+  std::scoped_lock lock(directory_latch_);
+  return page_ids_.size();
+}
+
+auto TableHeap::GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn,
+                              const std::function<bool(const Tuple &)> &keep) -> bool {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    return false;
+  }
+  // 整页一次读完，不像 TableIterator 那样每个元组都重新取一次页
+  page->RLatch();
+  RID rid;
+  Tuple view;
+  for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+    // 先在页上原地判断，不要的元组不用拷贝出来
+    if (keep != nullptr && (!page->PeekTuple(rid, &view) || !keep(view))) {
+      continue;
+    }
+    Tuple tuple;
+    if (page->GetTuple(rid, &tuple, txn, lock_manager_)) {
+      tuples->push_back(std::move(tuple));
+    }
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return true;
+}
+
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
 
 }  // namespace bustub
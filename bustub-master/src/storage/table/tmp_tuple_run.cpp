@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.cpp
+//
+// Identification: src/storage/table/tmp_tuple_run.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_run.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TmpTupleRun::~TmpTupleRun() { Release(); }
+
+TmpTupleRun::TmpTupleRun(TmpTupleRun &&other) noexcept
+    : bpm_(other.bpm_),
+      page_ids_(std::move(other.page_ids_)),
+      tail_(std::exchange(other.tail_, nullptr)),
+      num_tuples_(std::exchange(other.num_tuples_, 0)),
+      num_bytes_(std::exchange(other.num_bytes_, 0)) {
+  other.page_ids_.clear();
+}
+
+auto TmpTupleRun::operator=(TmpTupleRun &&other) noexcept -> TmpTupleRun & {
+  if (this != &other) {
+    Release();
+    bpm_ = other.bpm_;
+    page_ids_ = std::move(other.page_ids_);
+    other.page_ids_.clear();
+    tail_ = std::exchange(other.tail_, nullptr);
+    num_tuples_ = std::exchange(other.num_tuples_, 0);
+    num_bytes_ = std::exchange(other.num_bytes_, 0);
+  }
+  return *this;
+}
+
+void TmpTupleRun::Release() {
+  Finish();
+  for (auto page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+  page_ids_.clear();
+}
+
+void TmpTupleRun::Append(const Tuple &tuple) {
+  TmpTuple location(INVALID_PAGE_ID, 0);
+  if (tail_ == nullptr && !page_ids_.empty()) {
+    // Finish() 之后接着写最后一页，中途解除 pin 不会留下半空的页
+    tail_ = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(page_ids_.back()));
+    if (tail_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame in the buffer pool to spill tuples to");
+    }
+  }
+  if (tail_ == nullptr || !tail_->Insert(tuple, &location)) {
+    // 当前页写满了就换一页，写满的页解除 pin，由缓冲池决定何时刷盘
+    Finish();
+    page_id_t page_id;
+    auto *page = reinterpret_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame in the buffer pool to spill tuples to");
+    }
+    page->Init(page_id, BUSTUB_PAGE_SIZE);
+    page_ids_.push_back(page_id);
+    tail_ = page;
+    BUSTUB_ENSURE(tail_->Insert(tuple, &location), "tuple does not fit in an empty page");
+  }
+  num_tuples_++;
+  num_bytes_ += tuple.GetLength();
+}
+
+void TmpTupleRun::Finish() {
+  if (tail_ != nullptr) {
+    bpm_->UnpinPage(tail_->GetTablePageId(), true);
+    tail_ = nullptr;
+  }
+}
+
+void TmpTupleRun::ReadPage(size_t page_index, std::vector<Tuple> *tuples) {
+  auto page_id = page_ids_[page_index];
+  auto *page = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame in the buffer pool to read spilled tuples");
+  }
+  // 页内从最后插入的元组往前走，读完再翻转回插入顺序
+  size_t first = tuples->size();
+  for (size_t offset = page->GetFreeSpacePointer(); offset < BUSTUB_PAGE_SIZE; offset = page->GetPrevOffset(offset)) {
+    page->Get(offset, &tuples->emplace_back());
+  }
+  std::reverse(tuples->begin() + first, tuples->end());
+  bpm_->UnpinPage(page_id, false);
+}
+
+}  // namespace bustub
@@ -95,6 +95,30 @@ auto Tuple::operator=(const Tuple &other) -> Tuple & {
   return *this;
 }
 
+Tuple::Tuple(Tuple &&other) noexcept
+    : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_), data_(other.data_) {
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.data_ = nullptr;
+}
+
+auto Tuple::operator=(Tuple &&other) noexcept -> Tuple & {
+  if (this == &other) {
+    return *this;
+  }
+  if (allocated_) {
+    delete[] data_;
+  }
+  allocated_ = other.allocated_;
+  rid_ = other.rid_;
+  size_ = other.size_;
+  data_ = other.data_;
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.data_ = nullptr;
+  return *this;
+}
+
 auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
   assert(schema);
   assert(data_);
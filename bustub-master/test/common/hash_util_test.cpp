@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** @return the fraction of 2^bits buckets, picked by the low bits of the hashes, that no key falls into */
+template <typename HashFn>
+auto EmptyBucketFraction(size_t num_keys, int bits, HashFn &&hash_fn) -> double {
+  std::vector<bool> used(1ULL << bits, false);
+  for (size_t i = 0; i < num_keys; i++) {
+    used[hash_fn(i) & ((1ULL << bits) - 1)] = true;
+  }
+  size_t empty = 0;
+  for (bool bucket_used : used) {
+    empty += static_cast<size_t>(!bucket_used);
+  }
+  return static_cast<double>(empty) / used.size();
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, LowBitsSpreadTest) {
+  // as many keys as buckets leaves e^-1 ~ 36.8% of the buckets empty when the hash is random-looking
+  const size_t num_keys = 1 << 16;
+  auto strided_int = [](size_t i) {
+    auto key = static_cast<int64_t>(i << 12);
+    return HashUtil::Hash(&key);
+  };
+  auto short_string = [](size_t i) {
+    std::string key = "key-" + std::to_string(i);
+    return HashUtil::HashBytes(key.data(), key.size());
+  };
+  auto short_string_crc = [](size_t i) {
+    std::string key = "key-" + std::to_string(i);
+    return HashUtil::HashBytes<HashFamily::Crc32c>(key.data(), key.size());
+  };
+  auto long_string = [](size_t i) {
+    std::string key = std::string(100, 'x') + std::to_string(i);
+    return HashUtil::HashBytes(key.data(), key.size());
+  };
+  for (double fraction : {EmptyBucketFraction(num_keys, 16, strided_int),
+                          EmptyBucketFraction(num_keys, 16, short_string),
+                          EmptyBucketFraction(num_keys, 16, short_string_crc),
+                          EmptyBucketFraction(num_keys, 16, long_string)}) {
+    EXPECT_NEAR(0.368, fraction, 0.02);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashBytesTest) {
+  // every byte of the key matters
+  for (size_t len = 0; len <= 100; len++) {
+    std::string key(len, 'a');
+    for (size_t i = 0; i < len; i++) {
+      std::string other = key;
+      other[i] = 'b';
+      EXPECT_NE(HashUtil::HashBytes(key.data(), len), HashUtil::HashBytes(other.data(), len)) << len << " " << i;
+    }
+  }
+  // integers of different widths with the same value hash the same
+  int32_t small = 42;
+  int64_t big = 42;
+  EXPECT_EQ(HashUtil::Hash(&small), HashUtil::Hash(&big));
+  EXPECT_NE(HashUtil::CombineHashes(1, 2), HashUtil::CombineHashes(2, 1));
+}
+
+}  // namespace bustub
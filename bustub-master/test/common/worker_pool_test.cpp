@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool_test.cpp
+//
+// Identification: test/common/worker_pool_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "common/worker_pool.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+TEST(WorkerPoolTest, RunTest) {
+  WorkerPool pool(3);
+  std::vector<std::atomic<int>> runs(8);
+  pool.Run(runs.size(), [&](size_t worker_id) { runs[worker_id]++; });
+  for (const auto &count : runs) {
+    EXPECT_EQ(1, count.load());
+  }
+
+  // more workers than threads, and tasks that start parallel work of their own
+  std::atomic<size_t> leaves{0};
+  pool.Run(6, [&](size_t) { pool.Run(5, [&](size_t) { leaves++; }); });
+  EXPECT_EQ(30, leaves.load());
+
+  EXPECT_THROW(pool.Run(4,
+                        [](size_t worker_id) {
+                          if (worker_id == 2) {
+                            throw std::runtime_error("worker failed");
+                          }
+                        }),
+               std::runtime_error);
+}
+
+TEST(WorkerPoolTest, ParallelQueryTest) {
+  auto bustub = std::make_unique<BustubInstance>("worker_pool_test.db");
+  bustub->GenerateMockTable();
+  bustub->GenerateTestTable();
+  const std::vector<std::string> queries = {
+      "SELECT count(*), min(x), max(y) FROM __mock_t2_100k;",
+      "SELECT t3.y, count(*), min(t2.x) FROM __mock_t2_100k t2 LEFT JOIN __mock_t3_1k t3 ON t2.x = t3.x GROUP BY t3.y;",
+      "SELECT * FROM __mock_table_1 t1 LEFT JOIN __mock_table_3 t3 ON t1.colA = t3.colE;",
+      "SELECT colA, colB + colC FROM test_1 WHERE colD > 5000;",
+      "SELECT colB, count(*), max(colD) FROM test_1 GROUP BY colB;",
+      "SELECT count(*), sum(t2.x) FROM __mock_t2_100k t2 INNER JOIN __mock_t3_1k t3 ON t2.x = t3.x WHERE t2.y > 100;",
+  };
+  std::vector<std::vector<std::string>> serial;
+  for (const auto &sql : queries) {
+    serial.push_back(SortedResult(bustub.get(), sql));
+    ASSERT_FALSE(serial.back().empty()) << sql;
+  }
+  NoopWriter noop;
+  bustub->ExecuteSql("SET execution_parallelism = 4;", noop);
+  ASSERT_EQ(4, bustub->GetParallelism());
+  for (size_t i = 0; i < queries.size(); i++) {
+    EXPECT_EQ(serial[i], SortedResult(bustub.get(), queries[i])) << queries[i];
+  }
+  // an error in one worker fails the whole query instead of returning the other workers' rows, and an error in a
+  // serial plan fails it the same way
+  Transaction *txn;
+  for (const auto *settings : {"SET execution_parallelism = 4;", "SET execution_parallelism = 1;"}) {
+    bustub->ExecuteSql(settings, noop);
+    txn = bustub->txn_manager_->Begin();
+    EXPECT_THROW(bustub->ExecuteSqlTxn("SELECT * FROM __mock_t2_100k WHERE x = '99999999999';", noop, txn), Exception)
+        << settings;
+    bustub->txn_manager_->Abort(txn);
+    delete txn;
+  }
+
+  // with every frame pinned the table pages cannot be fetched, and the scan fails instead of skipping them
+  std::vector<page_id_t> pinned;
+  page_id_t page_id;
+  while (bustub->buffer_pool_manager_->NewPage(&page_id) != nullptr) {
+    pinned.push_back(page_id);
+  }
+  for (const auto *settings : {"SET execution_parallelism = 1;", "SET execution_parallelism = 4;"}) {
+    bustub->ExecuteSql(settings, noop);
+    txn = bustub->txn_manager_->Begin();
+    EXPECT_THROW(bustub->ExecuteSqlTxn("SELECT count(*) FROM test_1;", noop, txn), Exception) << settings;
+    bustub->txn_manager_->Abort(txn);
+    delete txn;
+  }
+  for (auto pinned_page_id : pinned) {
+    bustub->buffer_pool_manager_->UnpinPage(pinned_page_id, false);
+  }
+  EXPECT_EQ(serial[4].size(), SortedResult(bustub.get(), queries[4]).size());
+
+  bustub.reset();
+  remove("worker_pool_test.db");
+  remove("worker_pool_test.log");
+}
+
+}  // namespace bustub
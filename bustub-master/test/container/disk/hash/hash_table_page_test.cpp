@@ -23,7 +23,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
@@ -57,7 +57,7 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
+TEST(HashTablePageTest, BucketPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
@@ -114,4 +114,55 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageFullTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
+
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_page = reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(
+      bpm->NewPage(&bucket_page_id, nullptr)->GetData());
+  // BUCKET_ARRAY_SIZE is spelled in terms of KeyType and ValueType
+  using KeyType = int;
+  using ValueType = int;
+  const int capacity = static_cast<int>(BUCKET_ARRAY_SIZE);
+
+  // fill every slot, half of them with one key so that its values span all slot groups
+  for (int i = 0; i < capacity; i++) {
+    int key = i % 2 == 0 ? -1 : i;
+    EXPECT_TRUE(bucket_page->Insert(key, i, IntComparator()));
+  }
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_FALSE(bucket_page->Insert(capacity, capacity, IntComparator()));
+  EXPECT_FALSE(bucket_page->Insert(-1, 0, IntComparator()));
+
+  std::vector<int> res;
+  EXPECT_TRUE(bucket_page->GetValue(-1, IntComparator(), &res));
+  EXPECT_EQ((capacity + 1) / 2, res.size());
+  for (int i = 1; i < capacity; i += 2) {
+    res.clear();
+    EXPECT_TRUE(bucket_page->GetValue(i, IntComparator(), &res));
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i, res[0]);
+  }
+  res.clear();
+  EXPECT_FALSE(bucket_page->GetValue(capacity, IntComparator(), &res));
+
+  // removed slots become tombstones, and the first of them is reused
+  for (int i = 1; i < capacity; i += 2) {
+    EXPECT_TRUE(bucket_page->Remove(i, i, IntComparator()));
+  }
+  EXPECT_EQ((capacity + 1) / 2, bucket_page->NumReadable());
+  EXPECT_TRUE(bucket_page->Insert(capacity, capacity, IntComparator()));
+  EXPECT_EQ(capacity, bucket_page->KeyAt(1));
+  EXPECT_TRUE(bucket_page->IsReadable(1));
+  EXPECT_FALSE(bucket_page->IsReadable(3));
+
+  bpm->UnpinPage(bucket_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
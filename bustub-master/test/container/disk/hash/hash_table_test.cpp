@@ -10,10 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sstream>
+#include <string>
 #include <thread>  // NOLINT
 #include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "common/bustub_instance.h"
 #include "common/logger.h"
 #include "container/disk/hash/disk_extendible_hash_table.h"
 #include "gtest/gtest.h"
@@ -24,7 +28,7 @@ namespace bustub {
 // NOLINTNEXTLINE
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
   DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
@@ -117,4 +121,151 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, SplitMergeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // far more pairs than one bucket holds, so buckets split and the directory grows
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_GT(ht.GetGlobalDepth(), 0);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size()) << i;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // emptied buckets merge back and the directory shrinks again
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentInsertRemoveTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  const int num_threads = 4;
+  const int keys_per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&ht, tid] {
+      for (int i = tid; i < num_threads * keys_per_thread; i += num_threads) {
+        ht.Insert(nullptr, i, i);
+        std::vector<int> res;
+        ht.GetValue(nullptr, i, &res);
+        EXPECT_EQ(1, res.size()) << i;
+      }
+      // each thread removes the odd keys it inserted
+      for (int i = tid; i < num_threads * keys_per_thread; i += num_threads) {
+        if (i % 2 == 1) {
+          EXPECT_TRUE(ht.Remove(nullptr, i, i));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ht.VerifyIntegrity();
+
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i % 2 == 0 ? 1 : 0, res.size()) << i;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentUniqueInsertTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // every thread inserts every key with its own value, enough keys to split buckets while racing
+  const int num_threads = 4;
+  const int num_keys = 5000;
+  std::vector<int> num_inserted(num_threads);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&ht, &num_inserted, tid] {
+      for (int i = 0; i < num_keys; i++) {
+        num_inserted[tid] += ht.Insert(nullptr, i, tid, true) ? 1 : 0;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ht.VerifyIntegrity();
+
+  int total = 0;
+  for (auto count : num_inserted) {
+    total += count;
+  }
+  EXPECT_EQ(num_keys, total);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << i;
+  }
+  EXPECT_FALSE(ht.Insert(nullptr, 0, num_threads, true));
+  EXPECT_TRUE(ht.Insert(nullptr, 0, num_threads));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, CreateHashIndexTest) {
+  auto bustub = std::make_unique<BustubInstance>("hash_index_test.db");
+  bustub->GenerateTestTable();
+  auto count = [&](const std::string &sql) {
+    std::stringstream output;
+    SimpleStreamWriter writer(output, true);
+    bustub->ExecuteSql(sql, writer);
+    return output.str();
+  };
+  const std::string query = "SELECT count(*), sum(colA) FROM test_1 WHERE colB = 3;";
+  auto expected = count(query);
+
+  // 唯一和非唯一的 hash 索引都要记成 hash 索引，不能按键长退回 B+ 树
+  NoopWriter noop;
+  bustub->ExecuteSql("CREATE UNIQUE INDEX hash_a ON test_1 USING hash (colA);", noop);
+  bustub->ExecuteSql("CREATE INDEX hash_b ON test_1 USING hash (colB);", noop);
+  for (const auto *name : {"hash_a", "hash_b"}) {
+    auto *info = bustub->catalog_->GetIndex(name, "test_1");
+    ASSERT_NE(Catalog::NULL_INDEX_INFO, info) << name;
+    EXPECT_EQ(IndexType::HashTableIndex, info->index_type_) << name;
+  }
+  // 重复键都能从非唯一的 hash 索引里查出来
+  EXPECT_EQ(expected, count(query));
+
+  bustub.reset();
+  remove("hash_index_test.db");
+  remove("hash_index_test.log");
+}
+
 }  // namespace bustub
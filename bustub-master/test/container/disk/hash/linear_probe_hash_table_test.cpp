@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/linear_probe_hash_table_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, IncrementalResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  const size_t initial_size = ht.GetSize();
+
+  // grow through several resizes; whenever one is in progress every pair must be visible in one of the tables
+  const int num_keys = 20000;
+  int checked_resizes = 0;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+    if (ht.IsResizing() && checked_resizes < 3) {
+      checked_resizes++;
+      for (int j = 0; j <= i; j++) {
+        std::vector<int> res;
+        ht.GetValue(nullptr, j, &res);
+        ASSERT_EQ(1, res.size()) << j;
+      }
+    }
+  }
+  EXPECT_EQ(3, checked_resizes);
+  EXPECT_GT(ht.GetSize(), initial_size);
+
+  // a second value per key, then remove the first one again
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, -i - 1));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size()) << i;
+    EXPECT_EQ(-i - 1, res[0]);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ReadDuringResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  const int num_stable_keys = 500;
+  for (int i = 0; i < num_stable_keys; i++) {
+    ht.Insert(nullptr, i, i);
+  }
+  // a writer grows the table while readers keep looking up the keys inserted up front
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  threads.emplace_back([&] {
+    for (int i = num_stable_keys; i < 20000; i++) {
+      ht.Insert(nullptr, i, i);
+    }
+    done = true;
+  });
+  for (int tid = 0; tid < 2; tid++) {
+    threads.emplace_back([&] {
+      while (!done) {
+        for (int i = 0; i < num_stable_keys; i += 7) {
+          std::vector<int> res;
+          ht.GetValue(nullptr, i, &res);
+          ASSERT_EQ(1, res.size()) << i;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ChurnProbeLengthTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 4000, HashFunction<int>());
+  const size_t size = ht.GetSize();
+
+  // fill to about 70%, below the resize threshold
+  const int live_keys = static_cast<int>(size * 7 / 10);
+  for (int i = 0; i < live_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  auto initial = ht.GetProbeStats();
+  EXPECT_EQ(live_keys, initial.num_entries_);
+
+  // slide a window of live keys along: every round removes the oldest keys and inserts new ones
+  const int rounds = 20;
+  for (int round = 0; round < rounds; round++) {
+    for (int i = round * live_keys; i < (round + 1) * live_keys; i++) {
+      ASSERT_TRUE(ht.Remove(nullptr, i, i));
+      ASSERT_TRUE(ht.Insert(nullptr, i + live_keys, i + live_keys));
+    }
+  }
+  EXPECT_EQ(size, ht.GetSize());
+  for (int i = rounds * live_keys - 100; i < (rounds + 1) * live_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(i >= rounds * live_keys ? 1 : 0, res.size()) << i;
+  }
+
+  // removes leave no tombstones behind, so the average distance stays where it was after the initial fill
+  auto churned = ht.GetProbeStats();
+  EXPECT_EQ(live_keys, churned.num_entries_);
+  EXPECT_LE(churned.total_distance_, 2 * initial.total_distance_ + live_keys);
+  EXPECT_LT(churned.total_distance_ / churned.num_entries_, 4);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
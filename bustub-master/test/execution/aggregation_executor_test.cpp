@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor_test.cpp
+//
+// Identification: test/execution/aggregation_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(AggregationExecutorTest, ParallelAndSpilledAggregationTest) {
+  auto bustub = std::make_unique<BustubInstance>("aggregation_executor_test.db");
+  bustub->GenerateMockTable();
+  bustub->GenerateTestTable();
+  // few and many groups, NULL and VARCHAR keys, and a single group over an empty input
+  const std::vector<std::string> queries = {
+      "SELECT v1, count(*), sum(v2), min(v3), max(v3), count(v4) FROM __mock_agg_input_big GROUP BY v1;",
+      "SELECT v2, v4, sum(v1), max(v5) FROM __mock_agg_input_big GROUP BY v2, v4;",
+      "SELECT x, count(*), min(y), max(y) FROM __mock_t1_50k GROUP BY x;",
+      "SELECT colE, count(colE), count(*), min(colE) FROM __mock_table_3 GROUP BY colE;",
+      "SELECT v6, count(*), sum(v3 + v4) FROM __mock_agg_input_small GROUP BY v6;",
+      "SELECT colB, count(*), sum(colA), min(colD) FROM test_1 GROUP BY colB;",
+      "SELECT count(*), sum(v2), min(v4) FROM __mock_agg_input_big;",
+      "SELECT count(*), sum(x), max(y) FROM __mock_t1_50k WHERE x < 0;",
+  };
+  std::vector<std::vector<std::string>> expected;
+  for (const auto &sql : queries) {
+    expected.push_back(SortedResult(bustub.get(), sql));
+    ASSERT_FALSE(expected.back().empty()) << sql;
+  }
+  // row c of __mock_agg_input_big is ((c + 2) % 10, c, (c + 50) % 100, c / 1000, ...), so group v1 holds the
+  // thousand rows c = r + 10k with r = (v1 + 8) % 10, and their v3 are r, r + 10, ..., r + 90
+  std::vector<std::string> groups;
+  for (int v1 = 0; v1 < 10; v1++) {
+    int r = (v1 + 8) % 10;
+    groups.push_back(fmt::format("{}\t1000\t{}\t{}\t{}\t1000\t", v1, 1000 * r + 10 * 499500, r, r + 90));
+  }
+  std::sort(groups.begin(), groups.end());
+  EXPECT_EQ(groups, expected[0]);
+  EXPECT_EQ(10000, expected[1].size());
+  // row c of __mock_t1_50k is (10c, 1000c), every x is its own group
+  groups.clear();
+  for (int c = 0; c < 50000; c++) {
+    groups.push_back(fmt::format("{}\t1\t{}\t{}\t", 10 * c, 1000 * c, 1000 * c));
+  }
+  std::sort(groups.begin(), groups.end());
+  EXPECT_EQ(groups, expected[2]);
+  // the NULL keys are one group, whose count(colE) is NULL like the other aggregates of NULL inputs
+  EXPECT_EQ(51, expected[3].size());
+  ASSERT_EQ(1, expected[6].size());
+  EXPECT_EQ(0, expected[6][0].find("10000\t49995000\t"));
+  ASSERT_EQ(1, expected[7].size());
+  EXPECT_EQ(0, expected[7][0].find("0\t"));
+
+  // in parallel, then spilling a few groups at a time, serially and in parallel
+  NoopWriter noop;
+  for (const auto *settings : {"SET execution_parallelism = 4;", "SET execution_memory_budget = 1024;",
+                               "SET execution_parallelism = 1;"}) {
+    bustub->ExecuteSql(settings, noop);
+    for (size_t i = 0; i < queries.size(); i++) {
+      EXPECT_EQ(expected[i], SortedResult(bustub.get(), queries[i])) << settings << " " << queries[i];
+    }
+  }
+
+  bustub.reset();
+  remove("aggregation_executor_test.db");
+  remove("aggregation_executor_test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor_test.cpp
+//
+// Identification: test/execution/hash_join_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/radix_join_table.h"
+#include "gtest/gtest.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(HashJoinExecutorTest, RadixJoinTableTest) {
+  Schema schema(std::vector<Column>{Column{"k", TypeId::INTEGER}, Column{"v", TypeId::INTEGER}});
+  RadixJoinTable table;
+  // every key k in [0, 5000) appears k % 4 times, with v numbering its occurrences
+  const int num_keys = 5000;
+  for (int round = 0; round < 3; round++) {
+    for (int k = 0; k < num_keys; k++) {
+      if (round < k % 4) {
+        auto key = ValueFactory::GetIntegerValue(k);
+        table.Insert(Tuple({key, ValueFactory::GetIntegerValue(round)}, &schema), key);
+      }
+    }
+  }
+  table.Build();
+  ASSERT_GT(table.GetNumPartitions(), 1);
+
+  std::vector<uint32_t> rows;
+  for (int k = -10; k < num_keys + 10; k++) {
+    auto key = ValueFactory::GetIntegerValue(k);
+    rows.clear();
+    table.Find(key, RadixJoinTable::HashOf(key), &rows);
+    size_t expected = k >= 0 && k < num_keys ? k % 4 : 0;
+    ASSERT_EQ(expected, rows.size()) << k;
+    for (size_t i = 0; i < rows.size(); i++) {
+      ASSERT_EQ(k, table.GetRow(rows[i]).GetValue(&schema, 0).GetAs<int32_t>());
+      ASSERT_EQ(i, table.GetRow(rows[i]).GetValue(&schema, 1).GetAs<int32_t>());
+    }
+  }
+
+  // a single key repeated many times shares one slot, and its rows come back in insertion order
+  RadixJoinTable skewed;
+  const int num_duplicates = 50000;
+  auto key = ValueFactory::GetIntegerValue(7);
+  for (int i = 0; i < num_duplicates; i++) {
+    skewed.Insert(Tuple({key, ValueFactory::GetIntegerValue(i)}, &schema), key);
+  }
+  auto other = ValueFactory::GetIntegerValue(8);
+  skewed.Insert(Tuple({other, ValueFactory::GetIntegerValue(0)}, &schema), other);
+  skewed.Build();
+  rows.clear();
+  skewed.Find(key, RadixJoinTable::HashOf(key), &rows);
+  ASSERT_EQ(num_duplicates, rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    ASSERT_EQ(i, skewed.GetRow(rows[i]).GetValue(&schema, 1).GetAs<int32_t>());
+  }
+  rows.clear();
+  skewed.Find(other, RadixJoinTable::HashOf(other), &rows);
+  ASSERT_EQ(1, rows.size());
+}
+
+// NOLINTNEXTLINE
+TEST(HashJoinExecutorTest, GraceHashJoinTest) {
+  auto bustub = std::make_unique<BustubInstance>("hash_join_executor_test.db");
+  bustub->GenerateMockTable();
+  const std::vector<std::string> queries = {
+      // unique keys on both sides, partly matching
+      "SELECT count(*), min(t1.y), max(t2.y) FROM __mock_t1_50k t1 INNER JOIN __mock_t2_100k t2 ON t1.x = t2.x;",
+      "SELECT t1.x, t2.y FROM __mock_t1_50k t1 LEFT JOIN __mock_t2_100k t2 ON t1.x = t2.x WHERE t1.x < 2000;",
+      // NULL join keys on both sides
+      "SELECT * FROM __mock_table_3 t3 LEFT JOIN __mock_table_1 t1 ON t3.colE = t1.colA;",
+      "SELECT * FROM __mock_table_1 t1 INNER JOIN __mock_table_3 t3 ON t1.colA = t3.colE;",
+      // ten keys with a hundred rows each: partitions that no repartitioning can split
+      "SELECT s.v1, count(*), sum(t.v2) FROM __mock_agg_input_small s INNER JOIN __mock_agg_input_small t "
+      "ON s.v1 = t.v4 GROUP BY s.v1;",
+      // a spilled join probed by another one, which partitions its inputs at the same time
+      "SELECT count(*), max(t3.y) FROM __mock_t1_50k t1 INNER JOIN __mock_t2_100k t2 ON t1.x = t2.x "
+      "INNER JOIN __mock_t3_1k t3 ON t2.x = t3.x;",
+  };
+  std::vector<std::vector<std::string>> in_memory;
+  for (const auto &sql : queries) {
+    in_memory.push_back(SortedResult(bustub.get(), sql));
+    ASSERT_FALSE(in_memory.back().empty()) << sql;
+  }
+
+  // a budget far below the size of every build side makes each join spill
+  NoopWriter noop;
+  bustub->ExecuteSql("SET execution_memory_budget = 1024;", noop);
+  ASSERT_EQ(1024, bustub->GetMemoryBudget());
+  for (size_t i = 0; i < queries.size(); i++) {
+    EXPECT_EQ(in_memory[i], SortedResult(bustub.get(), queries[i])) << queries[i];
+  }
+
+  // the runs of the 16 partitions of a join only stay pinned while a batch is appended to them, so two joins spill
+  // with fewer free frames than their runs
+  std::vector<page_id_t> pinned;
+  page_id_t page_id;
+  while (bustub->buffer_pool_manager_->NewPage(&page_id) != nullptr) {
+    pinned.push_back(page_id);
+  }
+  const size_t num_free_frames = 24;
+  ASSERT_GT(pinned.size(), num_free_frames);
+  for (size_t i = 0; i < num_free_frames; i++) {
+    bustub->buffer_pool_manager_->UnpinPage(pinned.back(), false);
+    pinned.pop_back();
+  }
+  EXPECT_EQ(in_memory.back(), SortedResult(bustub.get(), queries.back()));
+  for (auto pinned_page_id : pinned) {
+    bustub->buffer_pool_manager_->UnpinPage(pinned_page_id, false);
+  }
+
+  bustub.reset();
+  remove("hash_join_executor_test.db");
+  remove("hash_join_executor_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(HashJoinExecutorTest, RuntimeFilterTest) {
+  auto bustub = std::make_unique<BustubInstance>("hash_join_executor_test.db");
+  bustub->GenerateMockTable();
+  bustub->GenerateTestTable();
+
+  // a scan drops the rows whose key is not in the filters published for it, and only those
+  auto *txn = bustub->txn_manager_->Begin();
+  {
+    ExecutorContext exec_ctx(txn, bustub->catalog_, bustub->buffer_pool_manager_, bustub->txn_manager_, nullptr);
+    auto *table_info = bustub->catalog_->GetTable("test_1");
+    SeqScanPlanNode scan_plan(std::make_shared<Schema>(table_info->schema_), table_info->oid_, "test_1");
+    auto filter = std::make_shared<BlockedBloomFilter>(100, 10);
+    for (int key = 0; key < 1000; key += 10) {
+      auto value = ValueFactory::GetIntegerValue(key);
+      filter->Insert(HashUtil::HashValue(&value));
+    }
+    exec_ctx.SetRuntimeFilter(&scan_plan, nullptr, RuntimeFilter{0, filter});
+    SeqScanExecutor scan(&exec_ctx, &scan_plan);
+    scan.Init();
+    size_t num_rows = 0;
+    size_t num_keys = 0;
+    Tuple tuple;
+    RID rid;
+    while (scan.Next(&tuple, &rid)) {
+      num_rows++;
+      num_keys += tuple.GetValue(&scan_plan.OutputSchema(), 0).GetAs<int32_t>() % 10 == 0 ? 1 : 0;
+    }
+    EXPECT_EQ(100, num_keys);
+    EXPECT_LT(num_rows, 150);
+  }
+  bustub->txn_manager_->Commit(txn);
+  delete txn;
+
+  // __mock_t3_1k holds x = 0, 100, ..., 99900, so ten rows of test_1 find a match
+  std::vector<std::string> expected;
+  for (int key = 0; key < 1000; key += 100) {
+    expected.push_back(fmt::format("{}\t{}\t", key, key * 100));
+  }
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(expected,
+            SortedResult(bustub.get(), "SELECT t.colA, m.y FROM test_1 t INNER JOIN __mock_t3_1k m ON t.colA = m.x;"));
+  EXPECT_EQ(expected, SortedResult(bustub.get(),
+                                   "SELECT t.colA, m.y FROM test_1 t INNER JOIN __mock_t3_1k m ON t.colA = m.x "
+                                   "INNER JOIN test_simple_seq_1 s ON t.colB = s.col1;"));
+  // LEFT joins must not filter the probe side
+  EXPECT_EQ(1000, SortedResult(bustub.get(),
+                               "SELECT t.colA, m.y FROM test_1 t LEFT JOIN __mock_t3_1k m ON t.colA = m.x;")
+                      .size());
+
+  bustub.reset();
+  remove("hash_join_executor_test.db");
+  remove("hash_join_executor_test.log");
+}
+
+}  // namespace bustub
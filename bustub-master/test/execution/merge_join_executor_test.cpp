@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor_test.cpp
+//
+// Identification: test/execution/merge_join_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(MergeJoinExecutorTest, IndexOrderedJoinTest) {
+  auto bustub = std::make_unique<BustubInstance>("merge_join_executor_test.db");
+  bustub->GenerateTestTable();
+  // the same joins without ORDER BY run as hash joins before any index exists
+  const std::vector<std::pair<std::string, std::string>> queries = {
+      // unique keys, the right side running out first
+      {"SELECT * FROM test_1 a INNER JOIN test_2 b ON a.colA = b.colA;",
+       "SELECT * FROM (SELECT * FROM test_1 ORDER BY colA) a INNER JOIN (SELECT * FROM test_2 ORDER BY colA) b "
+       "ON a.colA = b.colA;"},
+      {"SELECT a.colA, a.colB, b.colB FROM test_2 a LEFT JOIN test_1 b ON a.colA = b.colA;",
+       "SELECT a.colA, a.colB, b.colB FROM (SELECT * FROM test_2 ORDER BY colA) a "
+       "LEFT JOIN (SELECT * FROM test_1 ORDER BY colA) b ON a.colA = b.colA;"},
+      {"SELECT a.colA, b.colA FROM test_1 a LEFT JOIN test_2 b ON a.colA = b.colA;",
+       "SELECT a.colA, b.colA FROM (SELECT * FROM test_1 ORDER BY colA) a "
+       "LEFT JOIN (SELECT * FROM test_2 ORDER BY colA) b ON a.colA = b.colA;"},
+      // ten keys with a hundred rows each on both sides
+      {"SELECT a.colB, count(*), sum(a.colA), sum(b.colD) FROM test_1 a INNER JOIN test_1 b ON a.colB = b.colB "
+       "GROUP BY a.colB;",
+       "SELECT a.colB, count(*), sum(a.colA), sum(b.colD) FROM (SELECT * FROM test_1 ORDER BY colB) a "
+       "INNER JOIN (SELECT * FROM test_1 ORDER BY colB) b ON a.colB = b.colB GROUP BY a.colB;"},
+  };
+  std::vector<std::vector<std::string>> expected;
+  for (const auto &[hash_sql, merge_sql] : queries) {
+    expected.push_back(SortedResult(bustub.get(), hash_sql));
+    ASSERT_FALSE(expected.back().empty()) << hash_sql;
+  }
+
+  NoopWriter noop;
+  bustub->ExecuteSql("CREATE INDEX t1a ON test_1(colA);", noop);
+  bustub->ExecuteSql("CREATE INDEX t1b ON test_1(colB);", noop);
+  bustub->ExecuteSql("CREATE INDEX t2a ON test_2(colA);", noop);
+  for (size_t i = 0; i < queries.size(); i++) {
+    const auto &merge_sql = queries[i].second;
+    auto plan = SortedResult(bustub.get(), "EXPLAIN (o) " + merge_sql);
+    EXPECT_TRUE(std::any_of(plan.begin(), plan.end(),
+                            [](const auto &line) { return line.find("MergeJoin") != std::string::npos; }))
+        << merge_sql;
+    EXPECT_EQ(expected[i], SortedResult(bustub.get(), merge_sql)) << merge_sql;
+  }
+
+  bustub.reset();
+  remove("merge_join_executor_test.db");
+  remove("merge_join_executor_test.log");
+}
+
+}  // namespace bustub
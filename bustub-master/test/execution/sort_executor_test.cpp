@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor_test.cpp
+//
+// Identification: test/execution/sort_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/parallel_sort.h"
+#include "execution/sort_key.h"
+#include "gtest/gtest.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(SortExecutorTest, SortKeyEncoderTest) {
+  Schema schema(std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64},
+                                    Column{"c", TypeId::DECIMAL}, Column{"d", TypeId::BIGINT}});
+  std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys;
+  order_bys.emplace_back(OrderByType::DESC, std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER));
+  order_bys.emplace_back(OrderByType::ASC, std::make_shared<ColumnValueExpression>(0, 1, TypeId::VARCHAR));
+  order_bys.emplace_back(OrderByType::DEFAULT, std::make_shared<ColumnValueExpression>(0, 2, TypeId::DECIMAL));
+  order_bys.emplace_back(OrderByType::DESC, std::make_shared<ColumnValueExpression>(0, 3, TypeId::BIGINT));
+  SortKeyEncoder encoder(order_bys, &schema);
+
+  // few distinct values per column, so later keys decide often; strings share long prefixes
+  std::mt19937 gen(15445);
+  auto pick = [&](int n) { return static_cast<int>(gen() % n); };
+  const std::vector<std::string> strings = {"", "a", "ab", "abcdefghijklmnop", "abcdefghijklmnopq",
+                                            "abcdefghijklmnopr", "b"};
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 400; i++) {
+    std::vector<Value> values;
+    values.push_back(pick(5) == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                  : ValueFactory::GetIntegerValue(pick(3) - 1));
+    values.push_back(pick(8) == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                                  : ValueFactory::GetVarcharValue(strings[pick(strings.size())]));
+    values.push_back(ValueFactory::GetDecimalValue((pick(5) - 2) * 0.5));
+    values.push_back(ValueFactory::GetBigIntValue(static_cast<int64_t>(pick(3) - 1) << 40));
+    tuples.emplace_back(values, &schema);
+  }
+
+  // NULL sorts first, then the values in order, and DESC reverses both
+  auto expected_compare = [&](const Tuple &left, const Tuple &right) {
+    for (uint32_t col = 0; col < order_bys.size(); col++) {
+      auto l = left.GetValue(&schema, col);
+      auto r = right.GetValue(&schema, col);
+      int result = 0;
+      if (l.IsNull() || r.IsNull()) {
+        result = static_cast<int>(r.IsNull()) - static_cast<int>(l.IsNull());
+      } else if (l.CompareLessThan(r) == CmpBool::CmpTrue) {
+        result = -1;
+      } else if (l.CompareGreaterThan(r) == CmpBool::CmpTrue) {
+        result = 1;
+      }
+      if (result != 0) {
+        return order_bys[col].first == OrderByType::DESC ? -result : result;
+      }
+    }
+    return 0;
+  };
+  auto sign = [](int x) { return (x > 0) - (x < 0); };
+
+  std::vector<std::vector<char>> keys;
+  for (const auto &tuple : tuples) {
+    keys.emplace_back(encoder.GetKeySize());
+    encoder.Encode(tuple, keys.back().data());
+  }
+  for (size_t i = 0; i < tuples.size(); i++) {
+    for (size_t j = 0; j < tuples.size(); j++) {
+      ASSERT_EQ(sign(expected_compare(tuples[i], tuples[j])),
+                sign(encoder.Compare(keys[i].data(), tuples[i], keys[j].data(), tuples[j])))
+          << tuples[i].ToString(&schema) << " vs " << tuples[j].ToString(&schema);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(SortExecutorTest, ExternalSortTest) {
+  auto bustub = std::make_unique<BustubInstance>("sort_executor_test.db");
+  bustub->GenerateMockTable();
+  bustub->GenerateTestTable();
+  // ties on the sort keys keep their input order, so the whole output is deterministic
+  const std::vector<std::string> queries = {
+      "SELECT colB, colA, colD FROM test_1 ORDER BY colB DESC;",
+      "SELECT * FROM __mock_table_3 ORDER BY colE, colF DESC;",
+      "SELECT x, y FROM __mock_t1_50k WHERE x < 50000 ORDER BY y DESC, x;",
+      "SELECT v1, v4 FROM __mock_agg_input_small ORDER BY v4 + v1, v1 DESC;",
+  };
+  std::vector<std::vector<std::string>> in_memory;
+  for (const auto &sql : queries) {
+    in_memory.push_back(QueryResult(bustub.get(), sql));
+    ASSERT_FALSE(in_memory.back().empty()) << sql;
+  }
+  // in memory, the first query is sorted by colB, ties in table order, i.e. by colA
+  const auto &first = in_memory[0];
+  for (size_t i = 1; i < first.size(); i++) {
+    int b1;
+    int a1;
+    int b2;
+    int a2;
+    ASSERT_EQ(2, sscanf(first[i - 1].c_str(), "%d\t%d", &b1, &a1));  // NOLINT
+    ASSERT_EQ(2, sscanf(first[i].c_str(), "%d\t%d", &b2, &a2));      // NOLINT
+    ASSERT_TRUE(b1 > b2 || (b1 == b2 && a1 < a2)) << first[i - 1] << " / " << first[i];
+  }
+
+  // runs of a few tuples each, merged in several passes of two runs
+  NoopWriter noop;
+  bustub->ExecuteSql("SET execution_memory_budget = 1024;", noop);
+  for (size_t i = 0; i < queries.size(); i++) {
+    EXPECT_EQ(in_memory[i], QueryResult(bustub.get(), queries[i])) << queries[i];
+  }
+
+  bustub.reset();
+  remove("sort_executor_test.db");
+  remove("sort_executor_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(SortExecutorTest, ParallelSortAndTopNTest) {
+  auto bustub = std::make_unique<BustubInstance>("sort_executor_test.db");
+  bustub->GenerateMockTable();
+  // enough rows for several workers, with many ties on the first key
+  const std::vector<std::string> orders = {
+      "SELECT x, y FROM __mock_t1_50k ORDER BY y DESC, x",
+      "SELECT v1, v2, v4 FROM __mock_agg_input_big ORDER BY v1",
+  };
+  std::vector<std::vector<std::string>> serial;
+  for (const auto &sql : orders) {
+    serial.push_back(QueryResult(bustub.get(), sql + ";"));
+    ASSERT_GT(serial.back().size(), 2 * ParallelSort::MIN_ROWS_PER_WORKER) << sql;
+  }
+
+  NoopWriter noop;
+  bustub->ExecuteSql("SET execution_parallelism = 4;", noop);
+  auto plan = QueryResult(bustub.get(), "EXPLAIN (o) " + orders[0] + " LIMIT 10;");
+  EXPECT_TRUE(std::any_of(plan.begin(), plan.end(),
+                          [](const auto &line) { return line.find("TopN") != std::string::npos; }));
+  for (size_t i = 0; i < orders.size(); i++) {
+    EXPECT_EQ(serial[i], QueryResult(bustub.get(), orders[i] + ";")) << orders[i];
+    // the first N of the sort, for N below, around and above the compaction threshold and the input size
+    for (size_t n : {1, 10, 1500, 20000, 60000}) {
+      auto expected = std::vector<std::string>(serial[i].begin(), serial[i].begin() + std::min(n, serial[i].size()));
+      EXPECT_EQ(expected, QueryResult(bustub.get(), fmt::format("{} LIMIT {};", orders[i], n)))
+          << orders[i] << " " << n;
+    }
+  }
+
+  bustub.reset();
+  remove("sort_executor_test.db");
+  remove("sort_executor_test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch_test.cpp
+//
+// Identification: test/execution/tuple_batch_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "binder/binder.h"
+#include "common/bustub_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/executor_context.h"
+#include "execution/executor_factory.h"
+#include "execution/tuple_batch.h"
+#include "gtest/gtest.h"
+#include "optimizer/optimizer.h"
+#include "planner/planner.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, SelectTest) {
+  Schema schema(std::vector<Column>{Column{"a", TypeId::INTEGER}});
+  TupleBatch batch(8);
+  auto value_of = [&](size_t i) { return batch.GetTuple(i).GetValue(&schema, 0).GetAs<int32_t>(); };
+  for (int32_t a = 0; a < 8; a++) {
+    ASSERT_FALSE(batch.IsFull());
+    batch.Append(Tuple({ValueFactory::GetIntegerValue(a)}, &schema), RID(a, 0));
+  }
+  ASSERT_TRUE(batch.IsFull());
+  ASSERT_EQ(8, batch.Size());
+
+  // a selection keeps the surviving rows in order, with their RIDs, and a second one narrows the first
+  batch.Select([&](const Tuple &tuple) { return tuple.GetValue(&schema, 0).GetAs<int32_t>() % 2 == 0; });
+  ASSERT_EQ(4, batch.Size());
+  for (size_t i = 0; i < batch.Size(); i++) {
+    EXPECT_EQ(2 * i, value_of(i));
+    EXPECT_EQ(RID(2 * i, 0), batch.GetRid(i));
+  }
+  batch.Select([&](const Tuple &tuple) { return tuple.GetValue(&schema, 0).GetAs<int32_t>() > 2; });
+  ASSERT_EQ(2, batch.Size());
+  EXPECT_EQ(4, value_of(0));
+  EXPECT_EQ(6, value_of(1));
+  EXPECT_EQ(RID(6, 0), batch.GetRid(1));
+  // dropping rows does not make room, only a reset does
+  EXPECT_TRUE(batch.IsFull());
+  batch.Select([](const Tuple &tuple) { return false; });
+  EXPECT_TRUE(batch.IsEmpty());
+
+  batch.Reset();
+  EXPECT_TRUE(batch.IsEmpty());
+  EXPECT_FALSE(batch.IsFull());
+  EXPECT_EQ(8, batch.GetCapacity());
+  batch.Append(Tuple({ValueFactory::GetIntegerValue(42)}, &schema), RID(42, 0));
+  ASSERT_EQ(1, batch.Size());
+  EXPECT_EQ(42, value_of(0));
+}
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, NextBatchMatchesNextTest) {
+  auto bustub = std::make_unique<BustubInstance>("tuple_batch_test.db");
+  bustub->GenerateMockTable();
+  bustub->GenerateTestTable();
+  NoopWriter noop;
+  bustub->ExecuteSql("CREATE INDEX test_1_a ON test_1(colA);", noop);
+
+  // the nested loop join executor is not implemented; the optimizer turns every join below into a hash join or, over
+  // the index, a nested index join. The mock tables are scanned in a different random order by every executor, so
+  // queries over them are compared without order.
+  const std::vector<std::tuple<std::string, PlanType, bool>> queries = {
+      {"SELECT * FROM test_1 WHERE colA > 100 AND colB < 5;", PlanType::Filter, true},
+      {"SELECT colA, colD FROM test_1 WHERE colB = 3;", PlanType::Projection, true},
+      {"SELECT colA + colB, colC - colD FROM test_1;", PlanType::Projection, true},
+      {"SELECT x + y, y - x FROM __mock_t2_100k WHERE x > 1000;", PlanType::Projection, false},
+      {"SELECT * FROM __mock_t1_50k t1 INNER JOIN __mock_t3_1k t3 ON t1.x = t3.x;", PlanType::HashJoin, false},
+      {"SELECT * FROM __mock_t3_1k t3 LEFT JOIN __mock_t1_50k t1 ON t3.x = t1.x;", PlanType::HashJoin, false},
+      {"SELECT * FROM __mock_t3_1k m INNER JOIN test_1 t ON m.x = t.colA;", PlanType::NestedIndexJoin, false},
+  };
+  auto plan_of = [&](const std::string &sql) {
+    Binder binder(*bustub->catalog_);
+    binder.ParseAndSave(sql);
+    auto statement = binder.BindStatement(binder.statement_nodes_[0]);
+    Planner planner(*bustub->catalog_);
+    planner.PlanQuery(*statement);
+    Optimizer optimizer(*bustub->catalog_, false);
+    return optimizer.Optimize(planner.plan_);
+  };
+  // run the plan serially, through Next() or through NextBatch()
+  auto run = [&](const AbstractPlanNodeRef &plan, bool batched) {
+    auto *txn = bustub->txn_manager_->Begin();
+    ExecutorContext exec_ctx(txn, bustub->catalog_, bustub->buffer_pool_manager_, bustub->txn_manager_, nullptr);
+    auto executor = ExecutorFactory::CreateExecutor(&exec_ctx, plan);
+    executor->Init();
+    std::vector<std::string> rows;
+    if (batched) {
+      TupleBatch batch;
+      while (executor->NextBatch(&batch)) {
+        for (size_t i = 0; i < batch.Size(); i++) {
+          rows.push_back(batch.GetTuple(i).ToString(&plan->OutputSchema()));
+        }
+      }
+    } else {
+      Tuple tuple;
+      RID rid;
+      while (executor->Next(&tuple, &rid)) {
+        rows.push_back(tuple.ToString(&plan->OutputSchema()));
+      }
+    }
+    bustub->txn_manager_->Commit(txn);
+    delete txn;
+    return rows;
+  };
+
+  for (const auto &[sql, type, ordered] : queries) {
+    auto plan = plan_of(sql);
+    ASSERT_EQ(type, plan->GetType()) << sql;
+    auto rows = run(plan, false);
+    auto batched_rows = run(plan, true);
+    EXPECT_FALSE(rows.empty()) << sql;
+    if (!ordered) {
+      std::sort(rows.begin(), rows.end());
+      std::sort(batched_rows.begin(), batched_rows.end());
+    }
+    EXPECT_EQ(rows, batched_rows) << sql;
+  }
+
+  bustub.reset();
+  remove("tuple_batch_test.db");
+  remove("tuple_batch_test.log");
+}
+
+}  // namespace bustub
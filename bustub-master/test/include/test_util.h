@@ -17,10 +17,12 @@
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/bustub_instance.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/util/string_util.h"
@@ -92,4 +94,23 @@ auto ParseCreateStatement(const std::string &sql_base) -> std::unique_ptr<Schema
   return std::make_unique<Schema>(v);
 }
 
+/** @return the rows of the query result, one string of tab-separated values per row, in output order */
+auto QueryResult(BustubInstance *bustub, const std::string &sql) -> std::vector<std::string> {
+  std::stringstream output;
+  SimpleStreamWriter writer(output, true);
+  bustub->ExecuteSql(sql, writer);
+  std::vector<std::string> rows;
+  for (std::string row; std::getline(output, row);) {
+    rows.push_back(row);
+  }
+  return rows;
+}
+
+/** @return the rows of the query result, sorted, for queries whose row order is not defined */
+auto SortedResult(BustubInstance *bustub, const std::string &sql) -> std::vector<std::string> {
+  auto rows = QueryResult(bustub, sql);
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
 }  // namespace bustub
@@ -13,12 +13,15 @@
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
+#include <memory>
 #include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
 
 namespace bustub {
 // helper function to launch multiple threads
@@ -333,4 +336,53 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, BloomFilterLookupTest) {
+  auto table_schema = ParseCreateStatement("a integer");
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(
+      std::make_unique<IndexMetadata>("a_idx", "t", table_schema.get(), std::vector<uint32_t>{0}), bpm);
+  index.EnableBloomFilter();
+  auto key_of = [&](int32_t a) { return Tuple({ValueFactory::GetIntegerValue(a)}, index.GetKeySchema()); };
+  auto *transaction = new Transaction(0);
+  const int32_t key_count = 5000;
+  for (int32_t a = 0; a < 2 * key_count; a += 2) {
+    index.InsertEntry(key_of(a), RID(a, 0), transaction);
+  }
+
+  // every thread looks up every key, so the threads race to build the stale filter and then read it together
+  // keys that are a multiple of `removed_every` have been deleted, none if it is 0
+  auto lookup = [&](int32_t removed_every, uint64_t thread_itr) {
+    auto thread_txn = std::make_unique<Transaction>(static_cast<txn_id_t>(thread_itr + 1));
+    std::vector<RID> rids;
+    for (int32_t i = 0; i < 2 * key_count; i++) {
+      auto a = static_cast<int32_t>((i + thread_itr * 997) % (2 * key_count));
+      rids.clear();
+      index.ScanKey(key_of(a), &rids, thread_txn.get());
+      bool present = a % 2 == 0 && (removed_every == 0 || a % removed_every != 0);
+      ASSERT_EQ(rids.size(), present ? 1 : 0) << a;
+    }
+  };
+  LaunchParallelTest(4, lookup, 0);
+
+  // deleting most keys makes the filter stale again
+  for (int32_t a = 0; a < 2 * key_count; a += 4) {
+    index.DeleteEntry(key_of(a), RID(a, 0), transaction);
+  }
+  LaunchParallelTest(4, lookup, 4);
+  EXPECT_GT(index.GetAvoidedDescents(), 0);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
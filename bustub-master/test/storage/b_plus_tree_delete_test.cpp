@@ -12,6 +12,8 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <numeric>
+#include <random>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -163,4 +165,80 @@ TEST(BPlusTreeTests, DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, DeleteTest3) {
+  // random inserts and removes with tiny nodes and a small buffer pool, so that splits, merges and
+  // redistributions all happen many times and pages keep getting evicted
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  const size_t pool_size = 20;
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int64_t> keys(2000);
+  std::iota(keys.begin(), keys.end(), 1);
+  std::mt19937 g(15445);
+  std::shuffle(keys.begin(), keys.end(), g);
+  for (auto key : keys) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+
+  std::shuffle(keys.begin(), keys.end(), g);
+  std::vector<int64_t> removed(keys.begin(), keys.begin() + keys.size() / 2);
+  std::vector<int64_t> remaining(keys.begin() + keys.size() / 2, keys.end());
+  for (auto key : removed) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  EXPECT_TRUE(transaction->GetPageSet()->empty());
+
+  std::vector<RID> rids;
+  for (auto key : removed) {
+    index_key.SetFromInteger(key);
+    EXPECT_FALSE(tree.GetValue(index_key, &rids));
+  }
+  std::sort(remaining.begin(), remaining.end());
+  size_t i = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++i) {
+    ASSERT_LT(i, remaining.size());
+    EXPECT_EQ((*iterator).second.GetSlotNum(), remaining[i]);
+  }
+  EXPECT_EQ(i, remaining.size());
+  // the prev links survive the splits and merges as well
+  for (auto iterator = tree.RBegin(); iterator != tree.End(); --iterator) {
+    ASSERT_GT(i, 0);
+    EXPECT_EQ((*iterator).second.GetSlotNum(), remaining[--i]);
+  }
+  EXPECT_EQ(i, 0);
+
+  std::shuffle(remaining.begin(), remaining.end(), g);
+  for (auto key : remaining) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  // every page the tree touched must have been unpinned again
+  for (size_t frame = 1; frame < pool_size; frame++) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
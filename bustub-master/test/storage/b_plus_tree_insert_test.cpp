@@ -16,6 +16,7 @@
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "test_util.h"  // NOLINT
 
 #include <numeric>
@@ -23,6 +24,7 @@
 #include <string>
 
 #include "concurrency/transaction.h"
+#include "type/value_factory.h"
 #include "test_util.h"  // NOLINT
 
 namespace bustub {
@@ -264,4 +266,585 @@ TEST(BPlusTreeTests, InsertTest3) {
 
 }
 
+TEST(BPlusTreeTests, IntegerKeySearchTest) {
+  // single INTEGER column keys take the raw integer search path inside the pages
+  auto key_schema = ParseCreateStatement("a integer");
+  GenericComparator<4> comparator(key_schema.get());
+  EXPECT_EQ(comparator.GetIntegerKeyWidth(), 4);
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // default page sizes, so that a node holds far more keys than one SIMD window
+  BPlusTree<GenericKey<4>, RID, GenericComparator<4>> tree("foo_pk", bpm, comparator);
+  GenericKey<4> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  auto set_key = [&](int32_t key) {
+    Tuple tuple({ValueFactory::GetIntegerValue(key)}, key_schema.get());
+    index_key.SetFromKey(tuple);
+  };
+
+  // only even keys, negative ones included
+  std::vector<int32_t> keys;
+  for (int32_t key = -10000; key < 10000; key += 2) {
+    keys.push_back(key);
+  }
+  std::mt19937 g(15445);
+  std::shuffle(keys.begin(), keys.end(), g);
+  for (auto key : keys) {
+    rid.Set(0, key + 10000);
+    set_key(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+
+  std::vector<RID> rids;
+  for (int32_t key = -10000; key < 10000; key++) {
+    set_key(key);
+    bool is_present = tree.GetValue(index_key, &rids);
+    EXPECT_EQ(is_present, key % 2 == 0);
+    if (is_present) {
+      EXPECT_EQ(rids[0].GetSlotNum(), key + 10000);
+    }
+  }
+
+  // Begin(key) lands on the first key >= the probe, even when the probe is missing
+  for (int32_t probe : {-10001, -9999, -1, 0, 4095, 9997}) {
+    set_key(probe);
+    auto iterator = tree.Begin(index_key);
+    ASSERT_FALSE(iterator.IsEnd());
+    int32_t expected = probe % 2 == 0 ? probe : probe + 1;
+    EXPECT_EQ((*iterator).second.GetSlotNum(), expected + 10000);
+    int count = 0;
+    for (; count < 5 && !iterator.IsEnd(); ++iterator, ++count) {
+      EXPECT_EQ((*iterator).second.GetSlotNum(), expected + 10000 + 2 * count);
+    }
+  }
+  set_key(9999);
+  EXPECT_TRUE(tree.Begin(index_key).IsEnd());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, NonUniqueIndexTest) {
+  // table (a, b) with a non-unique index on a: every value of a is shared by 30 rows
+  auto table_schema = ParseCreateStatement("a integer,b integer");
+  const size_t pool_size = 50;
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  auto *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // a 4-byte key has no room for the RID suffix
+  EXPECT_THROW((BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>(
+                   std::make_unique<IndexMetadata>("bad_idx", "t", table_schema.get(), std::vector<uint32_t>{0}, false),
+                   bpm)),
+               Exception);
+
+  BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>> index(
+      std::make_unique<IndexMetadata>("a_idx", "t", table_schema.get(), std::vector<uint32_t>{0}, false), bpm);
+  EXPECT_FALSE(index.IsUnique());
+  auto key_of = [&](int32_t a) { return Tuple({ValueFactory::GetIntegerValue(a)}, index.GetKeySchema()); };
+
+  const int row_count = 3000;
+  const int32_t distinct = 100;
+  std::vector<int> rows(row_count);
+  std::iota(rows.begin(), rows.end(), 0);
+  std::mt19937 g(15445);
+  std::shuffle(rows.begin(), rows.end(), g);
+  for (auto row : rows) {
+    index.InsertEntry(key_of(row % distinct), RID(row / 50, row % 50), transaction);
+  }
+
+  // all duplicates come back, in RID order
+  for (int32_t a = 0; a < distinct; a++) {
+    std::vector<RID> rids;
+    index.ScanKey(key_of(a), &rids, transaction);
+    ASSERT_EQ(rids.size(), row_count / distinct);
+    for (size_t i = 0; i < rids.size(); i++) {
+      int row = a + static_cast<int>(i) * distinct;
+      EXPECT_EQ(rids[i], RID(row / 50, row % 50));
+    }
+  }
+  std::vector<RID> rids;
+  index.ScanKey(key_of(-1), &rids, transaction);
+  index.ScanKey(key_of(distinct), &rids, transaction);
+  EXPECT_TRUE(rids.empty());
+
+  // batched lookups in any order, repeated and missing keys included
+  std::vector<Tuple> probe_keys;
+  std::vector<int32_t> probes{42, -1, 7, 42, distinct, 0, 7};
+  for (auto probe : probes) {
+    probe_keys.push_back(key_of(probe));
+  }
+  std::vector<std::vector<RID>> results;
+  index.ScanKeys(probe_keys, &results, transaction);
+  ASSERT_EQ(results.size(), probes.size());
+  for (size_t i = 0; i < probes.size(); i++) {
+    rids.clear();
+    index.ScanKey(probe_keys[i], &rids, transaction);
+    EXPECT_EQ(results[i], rids);
+    EXPECT_EQ(rids.size(), probes[i] >= 0 && probes[i] < distinct ? row_count / distinct : 0);
+  }
+
+  // deleting one row removes only its own entry
+  for (int row = 0; row < row_count; row += 2) {
+    index.DeleteEntry(key_of(row % distinct), RID(row / 50, row % 50), transaction);
+  }
+  for (int32_t a = 0; a < distinct; a++) {
+    rids.clear();
+    index.ScanKey(key_of(a), &rids, transaction);
+    EXPECT_EQ(rids.size(), a % 2 == 0 ? 0 : row_count / distinct);
+  }
+
+  // scans stop in the middle of the leaf chain, and must still unpin their leaf
+  for (size_t frame = 1; frame < pool_size; frame++) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, RangeScanTest) {
+  auto table_schema = ParseCreateStatement("a integer");
+  const size_t pool_size = 10;
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  auto *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // unique index over the even keys 0, 2, ..., 1998
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(
+      std::make_unique<IndexMetadata>("a_idx", "t", table_schema.get(), std::vector<uint32_t>{0}), bpm);
+  auto key_of = [&](int32_t a) { return Tuple({ValueFactory::GetIntegerValue(a)}, index.GetKeySchema()); };
+  for (int32_t a = 0; a < 2000; a += 2) {
+    index.InsertEntry(key_of(a), RID(0, a), transaction);
+  }
+
+  auto scan_all = [&](std::optional<int32_t> low, std::optional<int32_t> high, RangeInclusivity inclusivity,
+                      size_t batch_size, ScanDirection direction = ScanDirection::FORWARD) {
+    std::optional<Tuple> low_key;
+    std::optional<Tuple> high_key;
+    if (low.has_value()) {
+      low_key = key_of(*low);
+    }
+    if (high.has_value()) {
+      high_key = key_of(*high);
+    }
+    auto scan = index.ScanRange(low_key.has_value() ? &*low_key : nullptr, high_key.has_value() ? &*high_key : nullptr,
+                                inclusivity, direction, batch_size, transaction);
+    std::vector<uint32_t> slots;
+    std::vector<RID> batch;
+    while (scan->NextBatch(&batch)) {
+      EXPECT_LE(batch.size(), batch_size);
+      for (const auto &rid : batch) {
+        slots.push_back(rid.GetSlotNum());
+      }
+    }
+    EXPECT_FALSE(scan->NextBatch(&batch));
+    return slots;
+  };
+  auto expect_range = [](const std::vector<uint32_t> &slots, uint32_t first, uint32_t last) {
+    ASSERT_EQ(slots.size(), (last - first) / 2 + 1);
+    for (size_t i = 0; i < slots.size(); i++) {
+      EXPECT_EQ(slots[i], first + 2 * i);
+    }
+  };
+
+  expect_range(scan_all(100, 200, {true, true}, 7), 100, 200);
+  expect_range(scan_all(100, 200, {false, false}, 7), 102, 198);
+  expect_range(scan_all(101, 199, {false, false}, 1000), 102, 198);
+  expect_range(scan_all(std::nullopt, 10, {true, false}, 3), 0, 8);
+  expect_range(scan_all(1990, std::nullopt, {false, true}, 3), 1992, 1998);
+  expect_range(scan_all(std::nullopt, std::nullopt, {}, 64), 0, 1998);
+  EXPECT_TRUE(scan_all(200, 100, {}, 7).empty());
+  EXPECT_TRUE(scan_all(1998, std::nullopt, {false, true}, 7).empty());
+
+  // scanning backwards visits the same ranges in reverse, following the prev links of the leaves
+  auto expect_reverse = [&](std::optional<int32_t> low, std::optional<int32_t> high, RangeInclusivity inclusivity) {
+    auto forward = scan_all(low, high, inclusivity, 5);
+    auto backward = scan_all(low, high, inclusivity, 5, ScanDirection::BACKWARD);
+    std::reverse(backward.begin(), backward.end());
+    EXPECT_EQ(forward, backward);
+  };
+  expect_reverse(100, 200, {true, true});
+  expect_reverse(100, 200, {false, false});
+  expect_reverse(101, 199, {false, false});
+  expect_reverse(std::nullopt, 10, {true, false});
+  expect_reverse(-5, 0, {true, true});
+  expect_reverse(1990, std::nullopt, {false, true});
+  expect_reverse(std::nullopt, std::nullopt, {});
+  expect_reverse(200, 100, {});
+
+  // between two batches the scan keeps at most one leaf pinned
+  {
+    auto scan = index.ScanRange(nullptr, nullptr, {}, ScanDirection::FORWARD, 5, transaction);
+    std::vector<RID> batch;
+    EXPECT_TRUE(scan->NextBatch(&batch));
+    std::vector<page_id_t> page_ids;
+    for (size_t frame = 2; frame < pool_size; frame++) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+      page_ids.push_back(page_id);
+    }
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+    for (auto id : page_ids) {
+      bpm->UnpinPage(id, false);
+    }
+  }
+
+  // non-unique index: equal keys come back in RID order
+  auto dup_schema = ParseCreateStatement("a integer");
+  BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>> dup_index(
+      std::make_unique<IndexMetadata>("dup_idx", "t", dup_schema.get(), std::vector<uint32_t>{0}, false), bpm);
+  for (int row = 0; row < 500; row++) {
+    dup_index.InsertEntry(key_of(row % 50), RID(0, row), transaction);
+  }
+  auto low_key = key_of(10);
+  auto high_key = key_of(12);
+  auto scan = dup_index.ScanRange(&low_key, &high_key, {false, true}, ScanDirection::FORWARD, 4, transaction);
+  std::vector<uint32_t> slots;
+  std::vector<RID> batch;
+  while (scan->NextBatch(&batch)) {
+    for (const auto &rid : batch) {
+      slots.push_back(rid.GetSlotNum());
+    }
+  }
+  ASSERT_EQ(slots.size(), 20);
+  for (size_t i = 0; i < slots.size(); i++) {
+    EXPECT_EQ(slots[i], (i < 10 ? 11 : 12) + 50 * (i % 10));
+  }
+  scan.reset();
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, GetValuesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const size_t pool_size = 50;
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  // small pages, so that a batch crosses many leaves
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+  auto *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  auto make_key = [](int64_t key) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    return index_key;
+  };
+
+  std::vector<std::vector<RID>> results;
+  tree.GetValues({make_key(1)}, &results, transaction);
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_TRUE(results[0].empty());
+
+  // multiples of 3 in [0, 3000)
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 3000; key += 3) {
+    keys.push_back(key);
+  }
+  std::mt19937 g(15445);
+  std::shuffle(keys.begin(), keys.end(), g);
+  for (auto key : keys) {
+    EXPECT_TRUE(tree.Insert(make_key(key), RID(0, key), transaction));
+  }
+
+  // dense probes move along the leaf chain, sparse ones descend again; some are past either end
+  for (int64_t step : {1, 2, 7, 500}) {
+    std::vector<int64_t> probes;
+    for (int64_t key = -5; key < 3010; key += step) {
+      probes.push_back(key);
+    }
+    std::vector<GenericKey<8>> probe_keys;
+    for (auto probe : probes) {
+      probe_keys.push_back(make_key(probe));
+    }
+    tree.GetValues(probe_keys, &results, transaction);
+    ASSERT_EQ(results.size(), probes.size());
+    for (size_t i = 0; i < probes.size(); i++) {
+      bool is_present = probes[i] >= 0 && probes[i] < 3000 && probes[i] % 3 == 0;
+      ASSERT_EQ(results[i].size(), is_present ? 1 : 0) << probes[i];
+      if (is_present) {
+        EXPECT_EQ(results[i][0].GetSlotNum(), probes[i]);
+      }
+    }
+  }
+
+  // ranges may span several leaves
+  tree.GetValueRanges({{make_key(10), make_key(100)}, {make_key(2990), make_key(5000)}}, &results, transaction);
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_EQ(results[0].size(), 30);
+  EXPECT_EQ(results[1].size(), 3);
+
+  for (size_t frame = 1; frame < pool_size; frame++) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, AppendAndBatchInsertTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const size_t pool_size = 50;
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 10, 10);
+  auto *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  auto make_key = [](int64_t key) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    return index_key;
+  };
+
+  // increasing keys fill each leaf up to 9 of 10 entries instead of 5
+  const int64_t append_count = 1000;
+  for (int64_t key = 0; key < append_count; key++) {
+    EXPECT_TRUE(tree.Insert(make_key(key), RID(0, key), transaction));
+  }
+  EXPECT_FALSE(tree.Insert(make_key(append_count - 1), RID(), transaction));
+  auto probe_page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, probe_page);
+  EXPECT_LT(page_id, append_count / 9 + 30);
+  bpm->UnpinPage(page_id, false);
+
+  // a batch in random order with duplicates, both of each other and of keys already in the tree
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  for (int64_t key = append_count - 100; key < 3 * append_count; key += 2) {
+    entries.emplace_back(make_key(key), RID(0, key));
+  }
+  for (int64_t key = append_count; key < 3 * append_count; key += 10) {
+    entries.emplace_back(make_key(key), RID(0, key));
+  }
+  std::mt19937 g(15445);
+  std::shuffle(entries.begin(), entries.end(), g);
+  EXPECT_EQ(tree.InsertBatch(entries, transaction), append_count);
+  // the same keys again, sorted this time: nothing new
+  std::sort(entries.begin(), entries.end(),
+            [&comparator](const auto &a, const auto &b) { return comparator(a.first, b.first) < 0; });
+  EXPECT_EQ(tree.InsertBatch(entries, transaction), 0);
+
+  std::vector<RID> rids;
+  int64_t expected = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), expected);
+    expected += expected < append_count ? 1 : 2;
+  }
+  EXPECT_EQ(expected, 3 * append_count);
+
+  // removing the tail merges the sparse rightmost leaves away, appending afterwards still works
+  for (int64_t key = 3 * append_count - 2; key >= 2 * append_count; key -= 2) {
+    tree.Remove(make_key(key), transaction);
+  }
+  for (int64_t key = 2 * append_count; key < 2 * append_count + 100; key++) {
+    EXPECT_TRUE(tree.Insert(make_key(key), RID(0, key), transaction));
+  }
+  // removing the largest keys leaves the cached last key of the rightmost leaf too large, so keys in between take
+  // the regular path, after which appending resumes
+  const int64_t end_key = 2 * append_count + 100;
+  for (int64_t key = end_key - 3; key < end_key; key++) {
+    tree.Remove(make_key(key), transaction);
+  }
+  for (int64_t key = end_key - 2; key < end_key + 20; key++) {
+    EXPECT_TRUE(tree.Insert(make_key(key), RID(0, key), transaction)) << key;
+  }
+  for (int64_t key = 2 * append_count - 10; key < end_key + 20; key++) {
+    bool is_present = key >= 2 * append_count ? key != end_key - 3 : key % 2 == 0;
+    EXPECT_EQ(tree.GetValue(make_key(key), &rids, transaction), is_present) << key;
+  }
+
+  for (size_t frame = 1; frame < pool_size; frame++) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, CoveringIndexTest) {
+  // table (a, b, c) with a non-unique index on a that includes c and b
+  auto table_schema = ParseCreateStatement("a integer,b bigint,c integer");
+  const size_t pool_size = 50;
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  auto *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  auto make_metadata = [&]() {
+    return std::make_unique<IndexMetadata>("a_idx", "t", table_schema.get(), std::vector<uint32_t>{0}, false,
+                                           std::vector<uint32_t>{2, 1});
+  };
+  // key, RID suffix and included columns take 24 bytes
+  EXPECT_THROW((BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>(make_metadata(), bpm)), Exception);
+  BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>> index(make_metadata(), bpm);
+  ASSERT_EQ(index.GetEntrySchema()->GetColumnCount(), 3);
+  EXPECT_EQ(index.GetEntryAttrs(), (std::vector<uint32_t>{0, 2, 1}));
+
+  auto row_of = [&](int32_t a, int64_t b, int32_t c) {
+    return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetBigIntValue(b), ValueFactory::GetIntegerValue(c)},
+                 table_schema.get());
+  };
+  auto entry_of = [&](Tuple row) {
+    return row.KeyFromTuple(*table_schema, *index.GetEntrySchema(), index.GetEntryAttrs());
+  };
+  const int32_t row_count = 1000;
+  for (int32_t row = 0; row < row_count; row++) {
+    index.InsertEntry(entry_of(row_of(row % 100, row * 1000000000LL, -row)), RID(row, 0), transaction);
+  }
+  // change the included columns of row 7, as an update would
+  index.DeleteEntry(entry_of(row_of(7, 7000000000LL, -7)), RID(7, 0), transaction);
+  index.InsertEntry(entry_of(row_of(7, 42, 42)), RID(7, 0), transaction);
+
+  // the entries come back with their included columns, the key columns still decide the order
+  Tuple low({ValueFactory::GetIntegerValue(7)}, index.GetKeySchema());
+  Tuple high({ValueFactory::GetIntegerValue(8)}, index.GetKeySchema());
+  auto scan = index.ScanRange(&low, &high, RangeInclusivity{}, ScanDirection::FORWARD, 7, transaction);
+  std::vector<RID> rids;
+  std::vector<Tuple> entries;
+  std::vector<int32_t> rows;
+  while (scan->NextEntryBatch(&rids, &entries)) {
+    ASSERT_EQ(rids.size(), entries.size());
+    for (size_t i = 0; i < rids.size(); i++) {
+      int32_t row = rids[i].GetPageId();
+      const auto *entry_schema = index.GetEntrySchema();
+      EXPECT_EQ(entries[i].GetValue(entry_schema, 0).GetAs<int32_t>(), row % 100);
+      EXPECT_EQ(entries[i].GetValue(entry_schema, 1).GetAs<int32_t>(), row == 7 ? 42 : -row);
+      EXPECT_EQ(entries[i].GetValue(entry_schema, 2).GetAs<int64_t>(), row == 7 ? 42 : row * 1000000000LL);
+      rows.push_back(row);
+    }
+  }
+  std::vector<int32_t> expected_rows;
+  for (int32_t row = 7; row < row_count; row += 100) {
+    expected_rows.push_back(row);
+  }
+  for (int32_t row = 8; row < row_count; row += 100) {
+    expected_rows.push_back(row);
+  }
+  EXPECT_EQ(rows, expected_rows);
+
+  // probes carry the key columns only
+  index.ScanKey(low, &rids, transaction);
+  EXPECT_EQ(rids.size(), row_count / 100);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, BloomFilterTest) {
+  auto table_schema = ParseCreateStatement("a integer");
+  const size_t pool_size = 50;
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  auto *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(
+      std::make_unique<IndexMetadata>("a_idx", "t", table_schema.get(), std::vector<uint32_t>{0}), bpm);
+  index.EnableBloomFilter();
+  auto key_of = [&](int32_t a) { return Tuple({ValueFactory::GetIntegerValue(a)}, index.GetKeySchema()); };
+
+  // even keys only; enough of them to outgrow the first filter
+  const int32_t key_count = 5000;
+  for (int32_t a = 0; a < 2 * key_count; a += 2) {
+    index.InsertEntry(key_of(a), RID(a, 0), transaction);
+  }
+
+  // no false negatives, and most misses never reach the tree
+  std::vector<RID> rids;
+  for (int32_t a = 0; a < 2 * key_count; a++) {
+    rids.clear();
+    index.ScanKey(key_of(a), &rids, transaction);
+    ASSERT_EQ(rids.size(), a % 2 == 0 ? 1 : 0) << a;
+  }
+  EXPECT_GT(index.GetAvoidedDescents(), key_count * 9 / 10);
+  EXPECT_LE(index.GetAvoidedDescents(), key_count);
+
+  // results are appended, and a key the filter rules out leaves them alone
+  rids.assign(1, RID(-1, 0));
+  for (int32_t a = 0; a < 4; a++) {
+    index.ScanKey(key_of(a), &rids, transaction);
+  }
+  ASSERT_EQ(3, rids.size());
+  EXPECT_EQ(RID(-1, 0), rids[0]);
+  EXPECT_EQ(RID(0, 0), rids[1]);
+  EXPECT_EQ(RID(2, 0), rids[2]);
+
+  // removed keys are filtered out again once the filter has been rebuilt
+  for (int32_t a = 0; a < 2 * key_count; a += 4) {
+    index.DeleteEntry(key_of(a), RID(a, 0), transaction);
+  }
+  std::vector<Tuple> probes;
+  for (int32_t a = 0; a < 2 * key_count; a++) {
+    probes.push_back(key_of(a));
+  }
+  size_t avoided_before = index.GetAvoidedDescents();
+  std::vector<std::vector<RID>> results;
+  index.ScanKeys(probes, &results, transaction);
+  for (int32_t a = 0; a < 2 * key_count; a++) {
+    ASSERT_EQ(results[a].size(), a % 4 == 2 ? 1 : 0) << a;
+  }
+  EXPECT_GT(index.GetAvoidedDescents() - avoided_before, key_count * 3 / 2 * 9 / 10);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
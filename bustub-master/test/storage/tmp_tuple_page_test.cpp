@@ -10,16 +10,20 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstdio>
+#include <string>
 #include <vector>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_tuple_run.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
+TEST(TmpTuplePageTest, BasicTest) {
   // There are many ways to do this assignment, and this is only one of them.
   // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
   // You will get full credit as long as you are correctly using a linear probe hash table.
@@ -46,6 +50,83 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), BUSTUB_PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 4), 123);
+
+  // fill the page, then walk it back from the last inserted tuple
+  int inserted = 1;
+  while (page.Insert(Tuple({ValueFactory::GetIntegerValue(inserted)}, &schema), &tmp_tuple)) {
+    ASSERT_EQ(page_id, tmp_tuple.GetPageId());
+    inserted++;
+  }
+  ASSERT_EQ((BUSTUB_PAGE_SIZE - 12) / 8, inserted);
+  int expected = inserted - 1;
+  for (size_t offset = page.GetFreeSpacePointer(); offset < BUSTUB_PAGE_SIZE; offset = page.GetPrevOffset(offset)) {
+    Tuple stored;
+    page.Get(offset, &stored);
+    ASSERT_EQ(expected == 0 ? 123 : expected, stored.GetValue(&schema, 0).GetAs<int32_t>());
+    expected--;
+  }
+  ASSERT_EQ(-1, expected);
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, RunTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(8, disk_manager);
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 64);
+  Schema schema(columns);
+
+  {
+    // many more pages than frames: the run only keeps its tail page pinned
+    TmpTupleRun run(bpm);
+    const int num_tuples = 3000;
+    for (int i = 0; i < num_tuples; i++) {
+      run.Append(Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i))}, &schema));
+    }
+    run.Finish();
+    ASSERT_EQ(num_tuples, run.GetNumTuples());
+    ASSERT_GT(run.GetNumPages(), 8);
+
+    // unpinning the tail between appends goes on filling the same page
+    TmpTupleRun interrupted(bpm);
+    for (int i = 0; i < num_tuples; i++) {
+      interrupted.Append(
+          Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::to_string(i))}, &schema));
+      interrupted.Finish();
+    }
+    ASSERT_EQ(run.GetNumPages(), interrupted.GetNumPages());
+
+    // moving the run moves its pages
+    TmpTupleRun moved(std::move(run));
+    ASSERT_EQ(0, run.GetNumPages());  // NOLINT
+    int expected = 0;
+    std::vector<Tuple> tuples;
+    for (size_t page = 0; page < moved.GetNumPages(); page++) {
+      tuples.clear();
+      moved.ReadPage(page, &tuples);
+      for (const auto &tuple : tuples) {
+        ASSERT_EQ(expected, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+        ASSERT_EQ(std::to_string(expected), tuple.GetValue(&schema, 1).ToString());
+        expected++;
+      }
+    }
+    ASSERT_EQ(num_tuples, expected);
+  }
+
+  // the runs deleted their pages, so every frame is free again
+  std::vector<page_id_t> page_ids(8);
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  for (auto page_id : page_ids) {
+    bpm->UnpinPage(page_id, false);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete bpm;
+  delete disk_manager;
 }
 
 }  // namespace bustub
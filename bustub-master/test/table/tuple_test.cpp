@@ -21,6 +21,7 @@
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +72,109 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+TEST(TupleTest, PageDirectoryTest) {
+  Column col1{"a", TypeId::INTEGER};
+  Column col2{"b", TypeId::VARCHAR, 64};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+
+  std::vector<RID> rid_v;
+  for (int i = 0; i < 2000; ++i) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+    rid_v.push_back(rid);
+  }
+
+  // the directory lists the pages in list order
+  auto page_ids = table->GetPageIds();
+  ASSERT_GT(page_ids.size(), 1);
+  EXPECT_EQ(page_ids.size(), table->GetNumPages());
+  EXPECT_EQ(table->GetFirstPageId(), page_ids.front());
+
+  // reading the pages one by one, in two halves as two workers would, yields every tuple once
+  std::vector<Tuple> tuples;
+  size_t half = page_ids.size() / 2;
+  for (size_t i = half; i < page_ids.size(); i++) {
+    ASSERT_TRUE(table->GetPageTuples(page_ids[i], &tuples, transaction));
+  }
+  for (size_t i = 0; i < half; i++) {
+    ASSERT_TRUE(table->GetPageTuples(page_ids[i], &tuples, transaction));
+  }
+  std::vector<RID> scanned;
+  for (const auto &scanned_tuple : tuples) {
+    scanned.push_back(scanned_tuple.GetRid());
+    EXPECT_EQ(tuple.GetLength(), scanned_tuple.GetLength());
+  }
+  auto by_page = [](const RID &a, const RID &b) { return a.Get() < b.Get(); };
+  std::sort(scanned.begin(), scanned.end(), by_page);
+  std::sort(rid_v.begin(), rid_v.end(), by_page);
+  EXPECT_EQ(rid_v, scanned);
+
+  // a heap opened from its first page rebuilds the same directory
+  auto *reopened = new TableHeap(buffer_pool_manager, lock_manager, log_manager, table->GetFirstPageId());
+  EXPECT_EQ(page_ids, reopened->GetPageIds());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete reopened;
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, MoveTest) {
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}}};
+  auto make_tuple = [&](int a, const std::string &b) {
+    return Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(b)}, &schema);
+  };
+  auto expect_tuple = [&](const Tuple &tuple, int a, const std::string &b) {
+    EXPECT_EQ(a, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(b, tuple.GetValue(&schema, 1).ToString());
+  };
+
+  // moving hands the data over without copying it, and leaves an empty tuple that owns nothing
+  Tuple first = make_tuple(1, "first");
+  const char *data = first.GetData();
+  uint32_t length = first.GetLength();
+  Tuple moved(std::move(first));
+  EXPECT_EQ(data, moved.GetData());
+  EXPECT_EQ(length, moved.GetLength());
+  EXPECT_TRUE(moved.IsAllocated());
+  expect_tuple(moved, 1, "first");
+  EXPECT_FALSE(first.IsAllocated());  // NOLINT
+  EXPECT_EQ(nullptr, first.GetData());
+  EXPECT_EQ(0, first.GetLength());
+
+  // move assignment frees the data the target owned; ASan reports a leak otherwise
+  Tuple second = make_tuple(2, "second");
+  second = std::move(moved);
+  expect_tuple(second, 1, "first");
+  EXPECT_EQ(nullptr, moved.GetData());  // NOLINT
+
+  // a moved-from tuple can be assigned again, by copy or by move
+  first = second;
+  expect_tuple(first, 1, "first");
+  EXPECT_NE(first.GetData(), second.GetData());
+  moved = make_tuple(3, "third");
+  expect_tuple(moved, 3, "third");
+
+  // moving a tuple into itself keeps it intact
+  auto &self = moved;
+  moved = std::move(self);
+  expect_tuple(moved, 3, "third");
+}
+
 }  // namespace bustub
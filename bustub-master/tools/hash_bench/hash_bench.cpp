@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_bench.cpp
+//
+// Identification: tools/hash_bench/hash_bench.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/util/hash_util.h"
+
+using bustub::hash_t;
+using bustub::HashFamily;
+using bustub::HashUtil;
+
+/**
+ * Compares the HashUtil hash families against std::hash and the old byte loop over integer and string key
+ * distributions: time per key, and how evenly the low bits spread the keys over buckets. Build in Release for
+ * meaningful timings. Usage: bustub-hash-bench [num_keys]
+ */
+namespace {
+
+/** The byte loop HashUtil::HashBytes used to be, kept as the baseline */
+auto LegacyHashBytes(const char *bytes, size_t length) -> hash_t {
+  hash_t hash = length;
+  for (size_t i = 0; i < length; ++i) {
+    hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+  }
+  return hash;
+}
+
+struct Quality {
+  double ns_per_key_;
+  size_t max_bucket_;
+  double empty_fraction_;
+};
+
+/**
+ * Hash every key, timing the loop, then bucket the hashes by their low bits into about as many buckets as keys. A
+ * good hash leaves about 36.8% of the buckets empty and keeps the fullest bucket in single digits.
+ */
+template <typename Key, typename HashFn>
+auto Measure(const std::vector<Key> &keys, HashFn &&hash_fn) -> Quality {
+  std::vector<hash_t> hashes(keys.size());
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < keys.size(); i++) {
+    hashes[i] = hash_fn(keys[i]);
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  size_t num_buckets = 1;
+  while (num_buckets < keys.size()) {
+    num_buckets <<= 1;
+  }
+  std::vector<uint32_t> buckets(num_buckets, 0);
+  for (hash_t hash : hashes) {
+    buckets[hash & (num_buckets - 1)]++;
+  }
+  Quality quality{};
+  quality.ns_per_key_ = std::chrono::duration<double, std::nano>(end - start).count() / keys.size();
+  size_t empty = 0;
+  for (uint32_t count : buckets) {
+    quality.max_bucket_ = std::max<size_t>(quality.max_bucket_, count);
+    empty += static_cast<size_t>(count == 0);
+  }
+  quality.empty_fraction_ = static_cast<double>(empty) / num_buckets;
+  return quality;
+}
+
+void Report(const char *distribution, const char *family, const Quality &quality) {
+  printf("%-14s %-12s %10.2f %12zu %10.1f%%\n", distribution, family, quality.ns_per_key_, quality.max_bucket_,
+         quality.empty_fraction_ * 100);
+}
+
+void BenchIntegers(const char *distribution, const std::vector<int64_t> &keys) {
+  Report(distribution, "std::hash", Measure(keys, [](int64_t key) { return std::hash<int64_t>{}(key); }));
+  Report(distribution, "legacy", Measure(keys, [](int64_t key) {
+           return LegacyHashBytes(reinterpret_cast<const char *>(&key), sizeof(key));
+         }));
+  Report(distribution, "mixint", Measure(keys, [](int64_t key) { return HashUtil::Hash(&key); }));
+  Report(distribution, "wyhash", Measure(keys, [](int64_t key) {
+           return HashUtil::HashBytes(reinterpret_cast<const char *>(&key), sizeof(key));
+         }));
+  Report(distribution, "crc32c", Measure(keys, [](int64_t key) {
+           return HashUtil::HashBytes<HashFamily::Crc32c>(reinterpret_cast<const char *>(&key), sizeof(key));
+         }));
+}
+
+void BenchStrings(const char *distribution, const std::vector<std::string> &keys) {
+  Report(distribution, "std::hash", Measure(keys, [](const std::string &key) { return std::hash<std::string>{}(key); }));
+  Report(distribution, "legacy",
+         Measure(keys, [](const std::string &key) { return LegacyHashBytes(key.data(), key.size()); }));
+  Report(distribution, "wyhash",
+         Measure(keys, [](const std::string &key) { return HashUtil::HashBytes(key.data(), key.size()); }));
+  Report(distribution, "crc32c", Measure(keys, [](const std::string &key) {
+           return HashUtil::HashBytes<HashFamily::Crc32c>(key.data(), key.size());
+         }));
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  const size_t num_keys = argc > 1 ? std::stoul(argv[1]) : 1 << 20;
+  std::mt19937_64 rng(15445);
+
+  std::vector<int64_t> dense(num_keys);
+  std::vector<int64_t> strided(num_keys);
+  std::vector<int64_t> random(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    dense[i] = static_cast<int64_t>(i);
+    // page-aligned offsets and similar keys share all of their low bits
+    strided[i] = static_cast<int64_t>(i) << 12;
+    random[i] = static_cast<int64_t>(rng());
+  }
+  std::vector<std::string> short_strings(num_keys);
+  std::vector<std::string> long_strings(num_keys);
+  const std::string prefix(64, 'x');
+  for (size_t i = 0; i < num_keys; i++) {
+    short_strings[i] = "key-" + std::to_string(i);
+    long_strings[i] = prefix + std::to_string(i);
+  }
+
+  printf("%zu keys\n", num_keys);
+  printf("%-14s %-12s %10s %12s %11s\n", "distribution", "family", "ns/key", "max bucket", "empty");
+  BenchIntegers("int dense", dense);
+  BenchIntegers("int strided", strided);
+  BenchIntegers("int random", random);
+  BenchStrings("str short", short_strings);
+  BenchStrings("str long", long_strings);
+  return 0;
+}